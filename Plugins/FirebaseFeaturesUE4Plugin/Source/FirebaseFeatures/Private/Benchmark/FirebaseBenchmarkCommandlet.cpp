@@ -0,0 +1,653 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Benchmark/FirebaseBenchmarkCommandlet.h"
+#include "FirebaseFeatures.h"
+#include "FirebaseSdk/FirebaseVariant.h"
+#include "Firestore/CollectionReference.h"
+#include "Firestore/DocumentReference.h"
+#include "Firestore/DocumentSnapshot.h"
+#include "Firestore/DocumentView.h"
+#include "Firestore/FieldValue.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/Query.h"
+#include "Performance/FirebasePerformanceLibrary.h"
+#include "Performance/FirebaseTraceAccumulator.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/app.h"
+#	include "firebase/future.h"
+#	include "firebase/firestore.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+namespace
+{
+	/**
+	 * Proxy forwarding every call to the allocator it wraps. It counts the allocations made by the
+	 * measuring thread while counting is enabled. Allocations of other threads aren't counted.
+	 */
+	class FCountingMallocProxy final : public FMalloc
+	{
+	public:
+		explicit FCountingMallocProxy(FMalloc* const InInner)
+			: Inner(InInner)
+		{
+		}
+
+		FMalloc* GetInner() const { return Inner; }
+
+		void StartCounting()
+		{
+			Allocations = 0;
+			AllocatedBytes = 0;
+			CountedThreadId = FPlatformTLS::GetCurrentThreadId();
+			FPlatformMisc::MemoryBarrier();
+			bCounting = true;
+		}
+
+		void StopCounting()
+		{
+			bCounting = false;
+			FPlatformMisc::MemoryBarrier();
+		}
+
+		uint64 GetAllocations() const { return Allocations; }
+		uint64 GetAllocatedBytes() const { return AllocatedBytes; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Record(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Record(Count);
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Record(Count);
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Record(Count);
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			Inner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			Inner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			Inner->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			Inner->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			Inner->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			Inner->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return Inner->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return Inner->GetDescriptiveName();
+		}
+
+	private:
+		FORCEINLINE void Record(const SIZE_T Count)
+		{
+			if (bCounting && FPlatformTLS::GetCurrentThreadId() == CountedThreadId)
+			{
+				++Allocations;
+				AllocatedBytes += Count;
+			}
+		}
+
+	private:
+		FMalloc* const Inner;
+
+		volatile bool bCounting = false;
+		uint32 CountedThreadId = 0;
+		uint64 Allocations = 0;
+		uint64 AllocatedBytes = 0;
+	};
+
+	/**
+	 * Wraps GMalloc in a counting proxy for the lifetime of the scope and restores
+	 * the wrapped allocator when the scope is left, whichever way it is left.
+	 */
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter()
+			: PreviousMalloc(GMalloc)
+			, Proxy(GetProxy(GMalloc))
+		{
+			FPlatformAtomics::InterlockedExchangePtr((void**)&GMalloc, Proxy);
+			Proxy->StartCounting();
+		}
+
+		~FScopedAllocationCounter()
+		{
+			Proxy->StopCounting();
+			FPlatformAtomics::InterlockedExchangePtr((void**)&GMalloc, PreviousMalloc);
+		}
+
+		uint64 GetAllocations() const { return Proxy->GetAllocations(); }
+		uint64 GetAllocatedBytes() const { return Proxy->GetAllocatedBytes(); }
+
+	private:
+		static FCountingMallocProxy* GetProxy(FMalloc* const Inner)
+		{
+			// Proxies are never destroyed: other threads may still be inside one right after GMalloc
+			// is restored. A new one is only created if the engine's allocator changed in the meantime.
+			static FCountingMallocProxy* Proxy = nullptr;
+			if (!Proxy || Proxy->GetInner() != Inner)
+			{
+				Proxy = new FCountingMallocProxy(Inner);
+			}
+			return Proxy;
+		}
+
+	private:
+		FMalloc* const PreviousMalloc;
+		FCountingMallocProxy* const Proxy;
+	};
+
+	struct FBenchmarkResult
+	{
+		FString Name;
+		int32 Iterations = 0;
+		double NanosecondsPerCall = 0.;
+		double AllocationsPerCall = 0.;
+		double BytesPerCall = 0.;
+		FString SkipReason;
+	};
+
+	// Results of the benchmarked calls are folded into it so they can't be optimized away.
+	static volatile int64 GBenchmarkSink = 0;
+
+	class FBenchmarkRunner
+	{
+	public:
+		FBenchmarkRunner(const int32 InIterations, const FString& InFilter)
+			: Iterations(InIterations)
+			, Filter(InFilter)
+		{
+		}
+
+		template<typename FunctorType>
+		void Run(const TCHAR* const Name, FunctorType&& Body)
+		{
+			if (!Filter.IsEmpty() && !FCString::Stristr(Name, *Filter))
+			{
+				return;
+			}
+
+			// Warms caches and lazily initialized state up.
+			for (int32 i = 0; i < FMath::Max(Iterations / 10, 1); ++i)
+			{
+				GBenchmarkSink += Body(i);
+			}
+
+			double Duration = 0.;
+			uint64 Allocations = 0;
+			uint64 AllocatedBytes = 0;
+			{
+				const FScopedAllocationCounter AllocationCounter;
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (int32 i = 0; i < Iterations; ++i)
+				{
+					GBenchmarkSink += Body(i);
+				}
+
+				Duration		= FPlatformTime::Seconds() - StartTime;
+				Allocations		= AllocationCounter.GetAllocations();
+				AllocatedBytes	= AllocationCounter.GetAllocatedBytes();
+			}
+
+			FBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+			Result.Name				  = Name;
+			Result.Iterations		  = Iterations;
+			Result.NanosecondsPerCall = Duration * 1.e9 / Iterations;
+			Result.AllocationsPerCall = (double)Allocations / Iterations;
+			Result.BytesPerCall		  = (double)AllocatedBytes / Iterations;
+
+			UE_LOG(LogFirebaseSdk, Display, TEXT("%-40s %10.1f ns/call %8.2f allocs/call %10.1f bytes/call"),
+				Name, Result.NanosecondsPerCall, Result.AllocationsPerCall, Result.BytesPerCall);
+
+			// Benchmarks creating UObjects would otherwise skew the following ones.
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		void Skip(const TCHAR* const Name, const TCHAR* const Reason)
+		{
+			if (!Filter.IsEmpty() && !FCString::Stristr(Name, *Filter))
+			{
+				return;
+			}
+
+			FBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+			Result.Name		  = Name;
+			Result.SkipReason = Reason;
+
+			UE_LOG(LogFirebaseSdk, Display, TEXT("%-40s skipped: %s"), Name, Reason);
+		}
+
+		FString ToJson() const
+		{
+			TArray<FString> Entries;
+			for (const FBenchmarkResult& Result : Results)
+			{
+				if (Result.SkipReason.IsEmpty())
+				{
+					Entries.Add(FString::Printf(TEXT("\t\t{ \"name\": \"%s\", \"iterations\": %d, \"nsPerCall\": %.3f, \"allocsPerCall\": %.3f, \"bytesPerCall\": %.3f }"),
+						*Result.Name, Result.Iterations, Result.NanosecondsPerCall, Result.AllocationsPerCall, Result.BytesPerCall));
+				}
+				else
+				{
+					Entries.Add(FString::Printf(TEXT("\t\t{ \"name\": \"%s\", \"skipped\": \"%s\" }"), *Result.Name, *Result.SkipReason));
+				}
+			}
+
+			return FString::Printf(TEXT("{\n\t\"timestamp\": \"%s\",\n\t\"platform\": \"%s\",\n\t\"firebaseSdk\": \"%d.%d.%d\",\n\t\"benchmarks\": [\n%s\n\t]\n}\n"),
+				*FDateTime::UtcNow().ToIso8601(), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()), FIREBASE_VERSION_MAJOR, FIREBASE_VERSION_MINOR, FIREBASE_VERSION_REVISION,
+				*FString::Join(Entries, TEXT(",\n")));
+		}
+
+	private:
+		const int32 Iterations;
+		const FString Filter;
+		TArray<FBenchmarkResult> Results;
+	};
+
+	TMap<FString, FFirestoreFieldValue> MakeFieldMap(const int32 Count)
+	{
+		TMap<FString, FFirestoreFieldValue> Fields;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Fields.Add(FString::Printf(TEXT("field_%d"), i), (i % 2) ? FFirestoreFieldValue((int64)i) : FFirestoreFieldValue(TEXT("benchmark value")));
+		}
+		return Fields;
+	}
+
+#if WITH_FIREBASE_FIRESTORE
+	// Pumps the game thread's tasks as Firestore callbacks are dispatched there.
+	template<typename PredicateType>
+	bool WaitFor(PredicateType&& IsDone, const double TimeoutSeconds = 10.)
+	{
+		const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+		while (!IsDone() && FPlatformTime::Seconds() < EndTime)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.005f);
+		}
+		return IsDone();
+	}
+
+	struct FSnapshotRequest
+	{
+		bool bDone = false;
+		TOptional<FFirestoreDocumentSnapshot> Snapshot;
+	};
+
+	template<typename ResultType>
+	bool WaitForFuture(const firebase::Future<ResultType>& Future)
+	{
+		return WaitFor([&Future]() { return Future.status() != firebase::kFutureStatusPending; })
+			&& Future.error() == 0;
+	}
+
+	/**
+	 * Firestore instance of an app of its own, so benchmark data never reaches the project's
+	 * database or its local cache: the instance's persistence directory is separate from the
+	 * project's, its network is disabled before any write and its persistence is cleared, with
+	 * the writes queued for the server, when the benchmarks are done.
+	 */
+	class FBenchmarkFirestore
+	{
+	public:
+		static constexpr const char* AppName = "firebase_benchmark";
+
+		FBenchmarkFirestore()
+		{
+#if !PLATFORM_ANDROID
+			firebase::App* App = firebase::App::GetInstance(AppName);
+			if (!App)
+			{
+				App = firebase::App::Create(firebase::App::GetInstance()->options(), AppName);
+			}
+
+			Firestore = firebase::firestore::Firestore::GetInstance(App);
+
+			// Leftovers of a run that didn't exit cleanly.
+			if (Firestore && (!WaitForFuture(Firestore->ClearPersistence()) || !WaitForFuture(Firestore->DisableNetwork())))
+			{
+				UE_LOG(LogFirestore, Error, TEXT("Failed to isolate the benchmark's Firestore instance."));
+
+				// Terminated so nothing it queued can be sent.
+				WaitForFuture(Firestore->Terminate());
+				Firestore = nullptr;
+			}
+#endif // !PLATFORM_ANDROID
+		}
+
+		~FBenchmarkFirestore()
+		{
+			if (Firestore)
+			{
+				// Only possible once the instance is terminated.
+				if (!WaitForFuture(Firestore->Terminate()) || !WaitForFuture(Firestore->ClearPersistence()))
+				{
+					UE_LOG(LogFirestore, Error, TEXT("Failed to clear the benchmark's Firestore data. It is cleared by the next run."));
+				}
+			}
+		}
+
+		bool IsValid() const { return Firestore != nullptr; }
+
+		/** @return A reference to the document of the benchmark's instance. Not interned with the project's references. */
+		UFirestoreDocumentReference* GetDocument(const TCHAR* const Path) const
+		{
+			UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
+			*Document->GetInternal() = Firestore->Document(TCHAR_TO_UTF8(Path));
+			return Document;
+		}
+
+	private:
+		firebase::firestore::Firestore* Firestore = nullptr;
+	};
+#endif
+}
+
+UFirebaseBenchmarkCommandlet::UFirebaseBenchmarkCommandlet()
+{
+	IsClient		= false;
+	IsServer		= false;
+	IsEditor		= false;
+	LogToConsole	= true;
+	ShowErrorCount	= true;
+}
+
+int32 UFirebaseBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Iterations = 10000;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString Filter;
+	FParse::Value(*Params, TEXT("Filter="), Filter);
+
+	FString OutPath;
+	if (!FParse::Value(*Params, TEXT("Out="), OutPath))
+	{
+		OutPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("FirebaseBenchmarks")
+			/ FString::Printf(TEXT("%s.json"), *FDateTime::Now().ToString());
+	}
+
+	FBenchmarkRunner Runner(Iterations, Filter);
+
+	// FFirestoreFieldValue
+
+	Runner.Run(TEXT("FieldValue.ConstructInteger"), [](const int32 i) -> int64
+	{
+		return (int64)FFirestoreFieldValue((int64)i).GetType();
+	});
+
+	Runner.Run(TEXT("FieldValue.ConstructString"), [](const int32) -> int64
+	{
+		return (int64)FFirestoreFieldValue(TEXT("benchmark string value")).GetType();
+	});
+
+	{
+		const FFirestoreFieldValue StringValue(TEXT("benchmark string value"));
+		Runner.Run(TEXT("FieldValue.ToString"), [&StringValue](const int32) -> int64
+		{
+			return StringValue.ToString().Len();
+		});
+
+		const FFirestoreFieldValue IntegerValue((int64)42);
+		Runner.Run(TEXT("FieldValue.ToInt64"), [&IntegerValue](const int32) -> int64
+		{
+			return IntegerValue.ToInt64();
+		});
+
+		const FFirestoreFieldValue CopiedValue(MakeFieldMap(16));
+		Runner.Run(TEXT("FieldValue.CopyMap16"), [&CopiedValue](const int32) -> int64
+		{
+			const FFirestoreFieldValue Copy(CopiedValue);
+			return (int64)Copy.GetType();
+		});
+	}
+
+	{
+		const TMap<FString, FFirestoreFieldValue> Fields = MakeFieldMap(16);
+		Runner.Run(TEXT("FieldValue.MapRoundTrip16"), [&Fields](const int32) -> int64
+		{
+			return FFirestoreFieldValue(Fields).ToMap().Num();
+		});
+
+		TArray<FFirestoreFieldValue> Elements;
+		Fields.GenerateValueArray(Elements);
+		Runner.Run(TEXT("FieldValue.ArrayRoundTrip16"), [&Elements](const int32) -> int64
+		{
+			return FFirestoreFieldValue(Elements).ToArray().Num();
+		});
+	}
+
+	// FFirebaseVariant
+
+	{
+		TMap<FFirebaseVariant, FFirebaseVariant> VariantMap;
+		TArray<FFirebaseVariant> VariantArray;
+		for (int32 i = 0; i < 16; ++i)
+		{
+			VariantMap.Add(FFirebaseVariant(FString::Printf(TEXT("key_%d"), i)), FFirebaseVariant((int64)i));
+			VariantArray.Add(FFirebaseVariant(FString::Printf(TEXT("value_%d"), i)));
+		}
+
+		Runner.Run(TEXT("Variant.MapRoundTrip16"), [&VariantMap](const int32) -> int64
+		{
+			return FFirebaseVariant(VariantMap).AsMap().Num();
+		});
+
+		Runner.Run(TEXT("Variant.ArrayRoundTrip16"), [&VariantArray](const int32) -> int64
+		{
+			return FFirebaseVariant(VariantArray).AsArray().Num();
+		});
+	}
+
+	// Firestore instance
+
+	static const TCHAR* const DocumentSkipReason = TEXT("Firebase app not initialized");
+
+#if WITH_FIREBASE_FIRESTORE
+	if (FFirebaseFeaturesModule::IsFirebaseSDKInitialized())
+	{
+		// Benchmark data must never reach the project's database.
+		const FBenchmarkFirestore BenchmarkFirestore;
+
+		UFirestoreDocumentReference* const Document = BenchmarkFirestore.IsValid() ? BenchmarkFirestore.GetDocument(TEXT("firebase_benchmark/document")) : nullptr;
+		TSharedRef<FSnapshotRequest, ESPMode::ThreadSafe> Request = MakeShared<FSnapshotRequest, ESPMode::ThreadSafe>();
+
+		if (Document)
+		{
+			Document->AddToRoot();
+			Document->Set(MakeFieldMap(16));
+			Document->Get(EFirestoreSource::Cache, FDocumentSnapshotCallback::CreateLambda([Request](const EFirestoreError Error, const FFirestoreDocumentSnapshot& Snapshot)
+			{
+				if (Error == EFirestoreError::Ok)
+				{
+					Request->Snapshot = Snapshot;
+				}
+				Request->bDone = true;
+			}));
+
+			WaitFor([Request]() { return Request->bDone; });
+		}
+
+		if (Request->Snapshot.IsSet())
+		{
+			const FFirestoreDocumentSnapshot& Snapshot = Request->Snapshot.GetValue();
+			Runner.Run(TEXT("DocumentSnapshot.GetData16"), [&Snapshot](const int32) -> int64
+			{
+				return Snapshot.GetData().Num();
+			});
+
+			static const FFirestoreFieldKey IntegerField(TEXT("field_1"));
+			static const FFirestoreFieldKey StringField(TEXT("field_2"));
+			Runner.Run(TEXT("DocumentView.Get2Of16"), [&Snapshot](const int32) -> int64
+			{
+				const FFirestoreDocumentView View(Snapshot);
+				return View.GetInt64(IntegerField) + View.GetString(StringField).Len();
+			});
+		}
+		else
+		{
+			Runner.Skip(TEXT("DocumentSnapshot.GetData16"), TEXT("Failed to read the benchmark document from the local cache"));
+			Runner.Skip(TEXT("DocumentView.Get2Of16"),	   TEXT("Failed to read the benchmark document from the local cache"));
+		}
+
+		Runner.Run(TEXT("Query.BuilderChain"), [](const int32 i) -> int64
+		{
+			UFirestoreQuery* const Query = UFirestore::GetCollection(TEXT("firebase_benchmark"))
+				->WhereEqualTo(TEXT("field_0"), FFirestoreFieldValue(TEXT("benchmark value")))
+				->WhereGreaterThan(TEXT("field_1"), FFirestoreFieldValue((int64)i))
+				->OrderBy(TEXT("field_1"))
+				->Limit(20);
+			return Query != nullptr;
+		});
+
+		if (Document)
+		{
+			Document->RemoveFromRoot();
+		}
+	}
+	else
+	{
+		Runner.Skip(TEXT("DocumentSnapshot.GetData16"), DocumentSkipReason);
+		Runner.Skip(TEXT("DocumentView.Get2Of16"),	   DocumentSkipReason);
+		Runner.Skip(TEXT("Query.BuilderChain"), DocumentSkipReason);
+	}
+#else
+	Runner.Skip(TEXT("DocumentSnapshot.GetData16"), TEXT("Firestore disabled"));
+	Runner.Skip(TEXT("DocumentView.Get2Of16"),	   TEXT("Firestore disabled"));
+	Runner.Skip(TEXT("Query.BuilderChain"), TEXT("Firestore disabled"));
+#endif
+
+	// FFirebaseTrace
+
+	{
+		FFirebaseTraceHandle Trace = UFirebasePerformanceLibrary::AcquireAndStartTrace(TEXT("firebase_benchmark"));
+		const FFirebaseMetricHandle Metric = FFirebaseTrace::RegisterMetric(TEXT("benchmark_metric"));
+
+		Runner.Run(TEXT("Trace.IncrementMetricByName"), [&Trace](const int32) -> int64
+		{
+			Trace->IncrementMetric(TEXT("benchmark_metric"), 1);
+			return 0;
+		});
+
+		Runner.Run(TEXT("Trace.IncrementMetricByHandle"), [&Trace, Metric](const int32) -> int64
+		{
+			Trace->IncrementMetric(Metric, 1);
+			return 0;
+		});
+
+		TArray<FFirebaseMetricHandle> Handles;
+		TArray<int64> Values;
+		for (int32 i = 0; i < 8; ++i)
+		{
+			Handles.Add(FFirebaseTrace::RegisterMetric(FString::Printf(TEXT("benchmark_metric_%d"), i)));
+			Values.Add(i);
+		}
+
+		Runner.Run(TEXT("Trace.SetMetricValues8"), [&Trace, &Handles, &Values](const int32) -> int64
+		{
+			Trace->SetMetricValues(Handles, Values);
+			return 0;
+		});
+
+		{
+			FFirebaseTraceAccumulator Accumulator(*Trace, 0.f);
+			const int32 Slot = Accumulator.AddMetric(TEXT("benchmark_metric"));
+
+			Runner.Run(TEXT("TraceAccumulator.Increment"), [&Accumulator, Slot](const int32) -> int64
+			{
+				Accumulator.Increment(Slot);
+				return 0;
+			});
+		}
+
+		Trace->Stop();
+	}
+
+	if (!FFileHelper::SaveStringToFile(Runner.ToJson(), *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogFirebaseSdk, Error, TEXT("Failed to write benchmark results to %s."), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogFirebaseSdk, Display, TEXT("Benchmark results written to %s."), *FPaths::ConvertRelativePathToFull(OutPath));
+
+	return 0;
+}
@@ -0,0 +1,26 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FirebaseBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures the per-call time and allocations of the plugin's hot wrappers and writes the results
+ * as JSON so they can be tracked between plugin updates. Runs headless.
+ *
+ * Usage: -run=FirebaseBenchmark [-Out=<JsonFile>] [-Iterations=<Count>] [-Filter=<Substring>]
+ *
+ * Benchmarks needing a Firestore instance are reported as skipped when the Firebase app couldn't be
+ * created. They only use local writes and the local cache, so no network access is required.
+ */
+UCLASS()
+class UFirebaseBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UFirebaseBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -17,6 +17,7 @@ THIRD_PARTY_INCLUDES_END
 
 
 #include "Async/Async.h"
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
 
 /**
  *	Not a function, we don't want to copy the ErrorMessage across calls...
@@ -61,7 +62,7 @@ class FChildListener final
 
 		FString Key = previous_sibling_key ? UTF8_TO_TCHAR(previous_sibling_key) : TEXT("");
 
-		AsyncTask(ENamedThreads::GameThread, [snapshot, Key = MoveTemp(Key), LocalQuery = this->Query]() -> void
+		FFirebaseEventDispatcher::Get().Dispatch([snapshot, Key = MoveTemp(Key), LocalQuery = this->Query]() -> void
 		{
 			if (LocalQuery.IsValid())
 			{
@@ -81,7 +82,7 @@ class FChildListener final
 		FString Key = UTF8_TO_TCHAR(previous_sibling_key);
 		TWeakObjectPtr<UDatabaseQuery> LocalQuery = Query;
 
-		AsyncTask(ENamedThreads::GameThread, [snapshot, Key = MoveTemp(Key), LocalQuery]() -> void
+		FFirebaseEventDispatcher::Get().Dispatch([snapshot, Key = MoveTemp(Key), LocalQuery]() -> void
 		{
 			if (LocalQuery.IsValid())
 			{
@@ -100,7 +101,7 @@ class FChildListener final
 
 		FString Key = previous_sibling_key ? UTF8_TO_TCHAR(previous_sibling_key) : TEXT("");
 
-		AsyncTask(ENamedThreads::GameThread, [snapshot, Key = MoveTemp(Key), LocalQuery = Query]() -> void
+		FFirebaseEventDispatcher::Get().Dispatch([snapshot, Key = MoveTemp(Key), LocalQuery = Query]() -> void
 		{
 			if (LocalQuery.IsValid())
 			{
@@ -117,7 +118,7 @@ class FChildListener final
 		UE_LOG(LogFirebaseDatabase, Log, TEXT("Child Removed Event fired."));
 #endif
 
-		AsyncTask(ENamedThreads::GameThread, [snapshot, LocalQuery = Query]() -> void
+		FFirebaseEventDispatcher::Get().Dispatch([snapshot, LocalQuery = Query]() -> void
 		{
 			if (LocalQuery.IsValid())
 			{
@@ -138,7 +139,7 @@ class FChildListener final
 	
 		const EFirebaseDatabaseError Error = (EFirebaseDatabaseError)error;
 
-		AsyncTask(ENamedThreads::GameThread, [Error, Message = MoveTemp(Message), LocalQuery = Query]() -> void
+		FFirebaseEventDispatcher::Get().Dispatch([Error, Message = MoveTemp(Message), LocalQuery = Query]() -> void
 		{
 			if (LocalQuery.IsValid())
 			{
@@ -161,6 +162,7 @@ class FValueListener final
 public:
 	FValueListener(UDatabaseQuery* const InQuery)
 		: Query(InQuery)
+		, Channel(FFirebaseEventDispatcher::CreateChannel())
 	{
 	}
 	virtual ~FValueListener()
@@ -173,7 +175,8 @@ public:
 		UE_LOG(LogFirebaseDatabase, Log, TEXT("A value with a listener has changed."));
 #endif
 
-		AsyncTask(ENamedThreads::GameThread, [snapshot, LocalQuery = this->Query]() -> void
+		// The value is the whole state of the location, a newer one supersedes the ones not delivered yet.
+		FFirebaseEventDispatcher::Get().Dispatch(Channel, [snapshot, LocalQuery = this->Query]() -> void
 		{
 			if (!LocalQuery.IsStale())
 			{
@@ -192,7 +195,7 @@ public:
 		
 		const EFirebaseDatabaseError Error = (EFirebaseDatabaseError)error;
 
-		AsyncTask(ENamedThreads::GameThread, [Error, Message = MoveTemp(Message), 
+		FFirebaseEventDispatcher::Get().Dispatch([Error, Message = MoveTemp(Message), 
 			LocalQuery = this->Query]() -> void
 		{
 			if (!LocalQuery.IsStale())
@@ -203,6 +206,7 @@ public:
 	}
 private:
 	TWeakObjectPtr<UDatabaseQuery> Query;
+	FFirebaseEventDispatcher::FChannelRef Channel;
 #endif
 };
 
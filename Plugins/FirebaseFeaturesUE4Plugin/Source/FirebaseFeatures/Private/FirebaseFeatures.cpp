@@ -67,6 +67,11 @@ THIRD_PARTY_INCLUDES_END
 #	include "Messaging/MessagingLibrary.h"
 #endif
 
+#if WITH_FIREBASE_PERFORMANCE
+#	include "Performance/FirebasePerformanceLibrary.h"
+#	include "Performance/FirebaseTraceFileSink.h"
+#endif
+
 #include "FirebaseSdk/FirebaseConfig.h"
 #include "FirebaseSdk/FirebaseApiConfig.h"
 
@@ -303,6 +308,9 @@ void FFirebaseFeaturesModule::StartupModule()
 	else
 #endif
 	{
+		// Started before the app so traces are recorded even if the app can't be created.
+		StartTraceRecording();
+
 		// We call it directly instead of GetApp() to avoid a call to firebase::app::GetInstance()
 		// which logs a warning on some platforms when the app is not created yet.
 		CreateApp();
@@ -378,6 +386,8 @@ void FFirebaseFeaturesModule::StartupModule()
 
 void FFirebaseFeaturesModule::ShutdownModule()
 {
+	StopTraceRecording();
+
 #if WITH_EDITOR
 	// Unregister settings
 	ISettingsModule* const SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings");
@@ -539,6 +549,7 @@ void FFirebaseFeaturesModule::InitializeFirebaseComponents()
 	InitFirebaseModule(Crashlytics);
 
 	InitDynamicLinks();
+	InitPerformance();
 
 	bIsSDKInitialized = true;
 	
@@ -582,6 +593,58 @@ void FFirebaseFeaturesModule::InitCrashlytics()
 #endif // WITH_FIREBASE_CRASHLYTICS
 }
 
+void FFirebaseFeaturesModule::InitPerformance()
+{
+#if WITH_FIREBASE_PERFORMANCE
+	const TArray<FString>& TraceNames = UFirebaseConfig::Get()->PrewarmedTraceNames;
+
+	if (TraceNames.Num() > 0)
+	{
+		UE_LOG(LogFirebasePerformance, Log, TEXT("Prewarming %d Firebase Performance trace(s)."), TraceNames.Num());
+
+		UFirebasePerformanceLibrary::PrewarmTraces(TraceNames);
+	}
+#endif // WITH_FIREBASE_PERFORMANCE
+}
+
+void FFirebaseFeaturesModule::StartTraceRecording()
+{
+#if WITH_FIREBASE_TRACE_FILE_SINK
+	FString TraceFilePath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("FirebaseTraceFile="), TraceFilePath))
+	{
+		if (!UFirebaseConfig::Get()->bRecordDesktopTraces)
+		{
+			return;
+		}
+
+		TraceFilePath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("FirebaseTraces")
+			/ FString::Printf(TEXT("%s.fbtrace"), *FDateTime::Now().ToString());
+	}
+
+	const int64 FileSize = (int64)FMath::Max(UFirebaseConfig::Get()->DesktopTraceFileSizeMB, 1) * 1024 * 1024;
+
+	TSharedPtr<FFirebaseTraceFileSink, ESPMode::ThreadSafe> Sink = FFirebaseTraceFileSink::Create(TraceFilePath, FileSize);
+
+	if (Sink.IsValid())
+	{
+		FirebasePerformance::AddTraceSink(Sink.ToSharedRef());
+		TraceRecorder = Sink;
+	}
+#endif // WITH_FIREBASE_TRACE_FILE_SINK
+}
+
+void FFirebaseFeaturesModule::StopTraceRecording()
+{
+#if WITH_FIREBASE_TRACE_FILE_SINK
+	if (TraceRecorder.IsValid())
+	{
+		FirebasePerformance::RemoveTraceSink(TraceRecorder.ToSharedRef());
+		TraceRecorder.Reset();
+	}
+#endif // WITH_FIREBASE_TRACE_FILE_SINK
+}
+
 void FFirebaseFeaturesModule::InitRemoteConfig()
 {
 #if WITH_FIREBASE_REMOTE_CONFIG
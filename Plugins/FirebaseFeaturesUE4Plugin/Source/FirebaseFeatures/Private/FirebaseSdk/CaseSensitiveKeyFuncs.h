@@ -0,0 +1,28 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Map key functions comparing and hashing FString keys case-sensitively.
+ * FString's default ones would merge "Users/A" and "users/a", while Firebase
+ * paths, field names and metric names are case-sensitive.
+ */
+template<typename ValueType>
+struct TCaseSensitiveKeyFuncs : TDefaultMapHashableKeyFuncs<FString, ValueType, false>
+{
+	static FORCEINLINE bool Matches(const FString& A, const FString& B)
+	{
+		return A.Equals(B, ESearchCase::CaseSensitive);
+	}
+
+	static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+	{
+		return FCrc::StrCrc32(*Key);
+	}
+};
+
+/** A map with FString keys compared case-sensitively. */
+template<typename ValueType>
+using TCaseSensitiveMap = TMap<FString, ValueType, FDefaultSetAllocator, TCaseSensitiveKeyFuncs<ValueType>>;
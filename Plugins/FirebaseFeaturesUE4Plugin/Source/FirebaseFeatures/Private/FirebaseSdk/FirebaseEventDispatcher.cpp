@@ -0,0 +1,128 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
+#include "FirebaseSdk/FirebaseConfig.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+
+FFirebaseEventDispatcher& FFirebaseEventDispatcher::Get()
+{
+	// Never destroyed: SDK threads can still dispatch events during exit.
+	static FFirebaseEventDispatcher* const Instance = new FFirebaseEventDispatcher();
+	return *Instance;
+}
+
+FFirebaseEventDispatcher::FChannelRef FFirebaseEventDispatcher::CreateChannel()
+{
+	return MakeShared<FChannel, ESPMode::ThreadSafe>();
+}
+
+FFirebaseEventDispatcher::FFirebaseEventDispatcher()
+	: NumPendingEvents(0)
+	, bTickerRegistered(false)
+	, Budget(FMath::Max(UFirebaseConfig::Get()->EventDispatchBudget, 0.f) / 1000.f)
+{
+}
+
+void FFirebaseEventDispatcher::Dispatch(TUniqueFunction<void()>&& Event)
+{
+	FEvent NewEvent;
+
+	NewEvent.Function = MoveTemp(Event);
+
+	Enqueue(MoveTemp(NewEvent));
+}
+
+void FFirebaseEventDispatcher::Dispatch(const FChannelRef& Channel, TUniqueFunction<void()>&& Event)
+{
+	FEvent NewEvent;
+
+	NewEvent.Function = MoveTemp(Event);
+	NewEvent.Channel  = Channel;
+	NewEvent.Serial   = Channel->LastSerial.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+	Enqueue(MoveTemp(NewEvent));
+}
+
+void FFirebaseEventDispatcher::Flush()
+{
+	check(IsInGameThread());
+
+	Drain(0.);
+}
+
+void FFirebaseEventDispatcher::SetBudget(const float Seconds)
+{
+	check(IsInGameThread());
+
+	Budget = FMath::Max(Seconds, 0.f);
+}
+
+float FFirebaseEventDispatcher::GetBudget() const
+{
+	return Budget;
+}
+
+int32 FFirebaseEventDispatcher::GetNumPendingEvents() const
+{
+	return NumPendingEvents.load(std::memory_order_relaxed);
+}
+
+void FFirebaseEventDispatcher::Enqueue(FEvent&& Event)
+{
+	Queue.Enqueue(MoveTemp(Event));
+
+	NumPendingEvents.fetch_add(1, std::memory_order_relaxed);
+
+	if (!bTickerRegistered.exchange(true))
+	{
+		// The core ticker can only be used from the game thread.
+		if (IsInGameThread())
+		{
+			RegisterTicker();
+		}
+		else
+		{
+			AsyncTask(ENamedThreads::GameThread, []() -> void
+			{
+				FFirebaseEventDispatcher::Get().RegisterTicker();
+			});
+		}
+	}
+}
+
+void FFirebaseEventDispatcher::RegisterTicker()
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FFirebaseEventDispatcher::HandleTick));
+}
+
+bool FFirebaseEventDispatcher::HandleTick(float DeltaTime)
+{
+	Drain(Budget > 0.f ? FPlatformTime::Seconds() + Budget : 0.);
+
+	return true;
+}
+
+void FFirebaseEventDispatcher::Drain(const double EndTime)
+{
+	FEvent Event;
+
+	// Runs at least one event per drain so a single slow event can't stall the queue.
+	bool bRanEvent = false;
+
+	while ((!bRanEvent || EndTime == 0. || FPlatformTime::Seconds() < EndTime) && Queue.Dequeue(Event))
+	{
+		NumPendingEvents.fetch_sub(1, std::memory_order_relaxed);
+
+		// A newer event of the same listener is queued.
+		if (Event.Channel && Event.Serial != Event.Channel->LastSerial.load(std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		Event.Function();
+
+		bRanEvent = true;
+	}
+}
@@ -0,0 +1,445 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/BulkWriter.h"
+#include "Firestore/DocumentReference.h"
+
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/future.h"
+#	include "firebase/firestore.h"
+#	include "firebase/firestore/write_batch.h"
+#	include "firebase/firestore/document_reference.h"
+#	include "firebase/firestore/map_field_value.h"
+#	include "firebase/firestore/set_options.h"
+THIRD_PARTY_INCLUDES_END
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+
+#include <vector>
+
+struct FFirestoreBulkWriter::FBatch
+{
+#if WITH_FIREBASE_FIRESTORE
+	enum class EWriteType : uint8
+	{
+		Set,
+		Update,
+		UpdatePaths,
+		Delete,
+	};
+
+	struct FWrite
+	{
+		EWriteType Type;
+		firebase::firestore::DocumentReference Document;
+		firebase::firestore::MapFieldValue Data;
+		std::unordered_map<firebase::firestore::FieldPath, firebase::firestore::FieldValue> PathData;
+		firebase::firestore::SetOptions Options;
+	};
+
+	std::vector<FWrite> Writes;
+#endif // WITH_FIREBASE_FIRESTORE
+
+	int32 NumWrites = 0;
+	int32 NumAttempts = 0;
+
+	/** If a write increments or changes an array, which applying twice doesn't give the same document. */
+	bool bHasTransforms = false;
+};
+
+namespace
+{
+	/**
+	 * If the commit can succeed when retried later.
+	 *
+	 * @param bHasTransforms If the batch has writes that can't be applied twice. The commit
+	 * might have been applied when the error is unknown, internal or a deadline: only
+	 * batches giving the same documents when applied twice are retried then.
+	 */
+	bool IsTransientError(const EFirestoreError Error, const bool bHasTransforms)
+	{
+		switch (Error)
+		{
+		case EFirestoreError::ResourceExhausted:
+		case EFirestoreError::Aborted:
+		case EFirestoreError::Unavailable:
+			return true;
+
+		case EFirestoreError::Unknown:
+		case EFirestoreError::DeadlineExceeded:
+		case EFirestoreError::Internal:
+			return !bHasTransforms;
+
+		default:
+			return false;
+		}
+	}
+
+#if WITH_FIREBASE_FIRESTORE
+	bool IsTransform(const firebase::firestore::FieldValue& Value)
+	{
+		using firebase::firestore::FieldValue;
+
+		switch (Value.type())
+		{
+		case FieldValue::Type::kArrayUnion:
+		case FieldValue::Type::kArrayRemove:
+		case FieldValue::Type::kIncrementInteger:
+		case FieldValue::Type::kIncrementDouble:
+			return true;
+
+		case FieldValue::Type::kMap:
+			for (const auto& Field : Value.map_value())
+			{
+				if (IsTransform(Field.second))
+				{
+					return true;
+				}
+			}
+			return false;
+
+		default:
+			return false;
+		}
+	}
+
+	template<typename MapType>
+	bool HasTransforms(const MapType& Data)
+	{
+		for (const auto& Field : Data)
+		{
+			if (IsTransform(Field.second))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	firebase::firestore::MapFieldValue ToNative(const TMap<FString, FFirestoreFieldValue>& Data)
+	{
+		firebase::firestore::MapFieldValue RawData;
+
+		RawData.reserve(Data.Num());
+
+		for (const auto& DataElem : Data)
+		{
+			RawData.emplace(TCHAR_TO_UTF8(*DataElem.Key), DataElem.Value);
+		}
+
+		return RawData;
+	}
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+TSharedRef<FFirestoreBulkWriter, ESPMode::ThreadSafe> FFirestoreBulkWriter::Create(const FFirestoreBulkWriterSettings& Settings)
+{
+	return MakeShareable(new FFirestoreBulkWriter(Settings));
+}
+
+FFirestoreBulkWriter::FFirestoreBulkWriter(const FFirestoreBulkWriterSettings& InSettings)
+	: Settings(InSettings)
+	, NumInFlightBatches(0)
+	, NumWaitingRetries(0)
+	, StartTime(0.)
+	, bClosed(false)
+{
+	ensureMsgf(Settings.BatchSize > 0 && Settings.BatchSize <= 500, TEXT("Firestore write batches must contain between 1 and 500 writes."));
+}
+
+FFirestoreBulkWriter::~FFirestoreBulkWriter()
+{
+	UE_CLOG(!bClosed && Stats.NumWrites > 0, LogFirestore, Warning,
+		TEXT("Bulk writer destroyed without being closed. Writes of its current batch are discarded."));
+}
+
+FFirestoreBulkWriter::FBatch& FFirestoreBulkWriter::GetCurrentBatch()
+{
+	check(IsInGameThread());
+	checkf(!bClosed, TEXT("Writes can't be added to a closed bulk writer."));
+
+	if (!CurrentBatch)
+	{
+		CurrentBatch = MakeShared<FBatch, ESPMode::ThreadSafe>();
+#if WITH_FIREBASE_FIRESTORE
+		CurrentBatch->Writes.reserve(FMath::Clamp(Settings.BatchSize, 1, 500));
+#endif // WITH_FIREBASE_FIRESTORE
+	}
+
+	if (Stats.NumWrites == 0)
+	{
+		StartTime = FPlatformTime::Seconds();
+	}
+
+	return *CurrentBatch;
+}
+
+void FFirestoreBulkWriter::Set(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+	const FFirestoreSetOptions& Options)
+{
+	FBatch& Batch = GetCurrentBatch();
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Document)
+	{
+		return;
+	}
+
+	FBatch::FWrite Write;
+	Write.Type		= FBatch::EWriteType::Set;
+	Write.Document	= *Document->GetInternal();
+	Write.Data		= ToNative(Data);
+	Write.Options	= Options;
+
+	Batch.bHasTransforms |= HasTransforms(Write.Data);
+	Batch.Writes.push_back(MoveTemp(Write));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	OnWriteAdded();
+}
+
+void FFirestoreBulkWriter::Update(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data)
+{
+	FBatch& Batch = GetCurrentBatch();
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Document)
+	{
+		return;
+	}
+
+	FBatch::FWrite Write;
+	Write.Type		= FBatch::EWriteType::Update;
+	Write.Document	= *Document->GetInternal();
+	Write.Data		= ToNative(Data);
+
+	Batch.bHasTransforms |= HasTransforms(Write.Data);
+	Batch.Writes.push_back(MoveTemp(Write));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	OnWriteAdded();
+}
+
+void FFirestoreBulkWriter::Update(UFirestoreDocumentReference* const Document, const TMap<FFirestoreFieldPath, FFirestoreFieldValue>& Data)
+{
+	FBatch& Batch = GetCurrentBatch();
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Document)
+	{
+		return;
+	}
+
+	FBatch::FWrite Write;
+	Write.Type		= FBatch::EWriteType::UpdatePaths;
+	Write.Document	= *Document->GetInternal();
+
+	Write.PathData.reserve(Data.Num());
+	for (const auto& DataElem : Data)
+	{
+		Write.PathData.emplace(DataElem.Key, DataElem.Value);
+	}
+
+	Batch.bHasTransforms |= HasTransforms(Write.PathData);
+	Batch.Writes.push_back(MoveTemp(Write));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	OnWriteAdded();
+}
+
+void FFirestoreBulkWriter::Delete(UFirestoreDocumentReference* const Document)
+{
+	FBatch& Batch = GetCurrentBatch();
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Document)
+	{
+		return;
+	}
+
+	FBatch::FWrite Write;
+	Write.Type		= FBatch::EWriteType::Delete;
+	Write.Document	= *Document->GetInternal();
+
+	Batch.Writes.push_back(MoveTemp(Write));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	OnWriteAdded();
+}
+
+void FFirestoreBulkWriter::OnWriteAdded()
+{
+	++Stats.NumWrites;
+
+	if (++CurrentBatch->NumWrites >= Settings.BatchSize)
+	{
+		Flush();
+	}
+}
+
+void FFirestoreBulkWriter::Flush()
+{
+	check(IsInGameThread());
+
+	if (CurrentBatch && CurrentBatch->NumWrites > 0)
+	{
+		QueuedBatches.Add(MoveTemp(CurrentBatch));
+	}
+
+	CurrentBatch.Reset();
+
+	SendBatches();
+}
+
+void FFirestoreBulkWriter::Close(FFirestoreBulkWriterCallback Callback)
+{
+	check(IsInGameThread());
+
+	if (bClosed)
+	{
+		UE_LOG(LogFirestore, Warning, TEXT("Bulk writer closed twice."));
+		return;
+	}
+
+	bClosed = true;
+	CompletionCallback = MoveTemp(Callback);
+
+	Flush();
+	TryComplete();
+}
+
+FFirestoreBulkWriterStats FFirestoreBulkWriter::GetStats() const
+{
+	return Stats;
+}
+
+void FFirestoreBulkWriter::SendBatches()
+{
+	const int32 MaxInFlightBatches = FMath::Max(Settings.MaxInFlightBatches, 1);
+
+	while (NumInFlightBatches < MaxInFlightBatches && QueuedBatches.Num() > 0)
+	{
+		const FBatchPtr Batch = QueuedBatches[0];
+		QueuedBatches.RemoveAt(0, 1, false);
+
+		CommitBatch(Batch);
+	}
+}
+
+void FFirestoreBulkWriter::CommitBatch(const FBatchPtr& Batch)
+{
+	++NumInFlightBatches;
+	++Batch->NumAttempts;
+
+#if WITH_FIREBASE_FIRESTORE
+	// A native batch can only be committed once so it's built again for each attempt.
+	firebase::firestore::WriteBatch NativeBatch = Batch->Writes[0].Document.firestore()->batch();
+
+	for (const FBatch::FWrite& Write : Batch->Writes)
+	{
+		switch (Write.Type)
+		{
+		case FBatch::EWriteType::Set:			NativeBatch.Set(Write.Document, Write.Data, Write.Options); break;
+		case FBatch::EWriteType::Update:		NativeBatch.Update(Write.Document, Write.Data);				break;
+		case FBatch::EWriteType::UpdatePaths:	NativeBatch.Update(Write.Document, Write.PathData);			break;
+		case FBatch::EWriteType::Delete:		NativeBatch.Delete(Write.Document);							break;
+		}
+	}
+
+	NativeBatch.Commit().OnCompletion([Writer = AsShared(), Batch](const firebase::Future<void>& Future) -> void
+	{
+		const EFirestoreError Error = (EFirestoreError)Future.error();
+
+		if (Error != EFirestoreError::Ok)
+		{
+			UE_LOG(LogFirestore, Warning, TEXT("Bulk writer failed to commit a batch of %d writes (attempt %d). Code: %d. Message: %s"),
+				Batch->NumWrites, Batch->NumAttempts, Error, UTF8_TO_TCHAR(Future.error_message()));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Writer, Batch, Error]() -> void
+		{
+			Writer->HandleBatchCompleted(Batch, Error);
+		});
+	});
+#else
+	AsyncTask(ENamedThreads::GameThread, [Writer = AsShared(), Batch]() -> void
+	{
+		Writer->HandleBatchCompleted(Batch, EFirestoreError::Unimplemented);
+	});
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreBulkWriter::HandleBatchCompleted(const FBatchPtr& Batch, const EFirestoreError Error)
+{
+	--NumInFlightBatches;
+
+	if (Error == EFirestoreError::Ok)
+	{
+		Stats.NumCommittedWrites += Batch->NumWrites;
+		++Stats.NumCommittedBatches;
+	}
+	else if (IsTransientError(Error, Batch->bHasTransforms) && Batch->NumAttempts < Settings.MaxAttempts)
+	{
+		// Exponential backoff with jitter so concurrent batches don't retry in lockstep.
+		const float Backoff = FMath::Min(Settings.InitialBackoff * FMath::Pow(2.f, (float)(Batch->NumAttempts - 1)), Settings.MaxBackoff);
+		const float Delay	= Backoff * FMath::FRandRange(0.5f, 1.f);
+
+		++Stats.NumRetries;
+		++NumWaitingRetries;
+
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Writer = AsShared(), Batch](float) -> bool
+		{
+			--Writer->NumWaitingRetries;
+
+			// Retried batches go before the queued ones to keep the stream moving in order.
+			Writer->QueuedBatches.Insert(Batch, 0);
+			Writer->SendBatches();
+
+			return false;
+		}), Delay);
+	}
+	else
+	{
+		Stats.NumFailedWrites += Batch->NumWrites;
+
+		if (Stats.FirstError == EFirestoreError::Ok)
+		{
+			Stats.FirstError = Error;
+		}
+	}
+
+	UpdateStats();
+
+	OnProgress.ExecuteIfBound(Stats);
+
+	SendBatches();
+	TryComplete();
+}
+
+void FFirestoreBulkWriter::TryComplete()
+{
+	if (!bClosed || CurrentBatch || QueuedBatches.Num() > 0 || NumInFlightBatches > 0 || NumWaitingRetries > 0)
+	{
+		return;
+	}
+
+	UpdateStats();
+
+	UE_LOG(LogFirestore, Log, TEXT("Bulk writer committed %d/%d writes in %d batches (%d retries) in %.2fs, %.0f writes/s."),
+		Stats.NumCommittedWrites, Stats.NumWrites, Stats.NumCommittedBatches, Stats.NumRetries, Stats.ElapsedSeconds, Stats.WritesPerSecond);
+
+	FFirestoreBulkWriterCallback Callback = MoveTemp(CompletionCallback);
+	CompletionCallback.Unbind();
+
+	Callback.ExecuteIfBound(Stats);
+}
+
+void FFirestoreBulkWriter::UpdateStats()
+{
+	if (Stats.NumWrites > 0)
+	{
+		Stats.ElapsedSeconds  = FPlatformTime::Seconds() - StartTime;
+		Stats.WritesPerSecond = Stats.ElapsedSeconds > 0. ? Stats.NumCommittedWrites / Stats.ElapsedSeconds : 0.;
+	}
+}
@@ -11,6 +11,7 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 
 #include "Firestore/DocumentReference.h"
+#include "Firestore/FirestoreReferenceCache.h"
 
 #include "Async/Async.h"
 
@@ -55,13 +56,11 @@ FString UFirestoreCollectionReference::GetPath() const
 
 UFirestoreDocumentReference* UFirestoreCollectionReference::GetParent() const
 {
-	UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
-
 #if WITH_FIREBASE_FIRESTORE
-	*Document->Reference = GetQuery()->Parent();
+	return FFirestoreReferenceCache::Get().FindOrAdd(GetQuery()->Parent());
+#else
+	return NewObject<UFirestoreDocumentReference>();
 #endif
-
-	return Document;
 }
 
 UFirestoreDocumentReference* UFirestoreCollectionReference::GetDocument() const
@@ -77,16 +76,14 @@ UFirestoreDocumentReference* UFirestoreCollectionReference::GetDocument() const
 
 UFirestoreDocumentReference* UFirestoreCollectionReference::GetDocumentFromPath(const FString& DocumentPath) const
 {
-	UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
-
 #if WITH_FIREBASE_FIRESTORE
 	if (!DocumentPath.IsEmpty())
 	{
-		*Document->Reference = GetQuery()->Document(TCHAR_TO_UTF8(*DocumentPath));
+		return FFirestoreReferenceCache::Get().FindOrAdd(GetQuery()->Document(TCHAR_TO_UTF8(*DocumentPath)));
 	}
 #endif
 
-	return Document;
+	return NewObject<UFirestoreDocumentReference>();
 }
 
 void UFirestoreCollectionReference::Add(const TMap<FString, FFirestoreFieldValue>& Data, const FFirestoreDocumentCallback& Callback)
@@ -113,11 +110,7 @@ void UFirestoreCollectionReference::Add(const TMap<FString, FFirestoreFieldValue
 			firebase::firestore::DocumentReference Reference = Future.result() ? *Future.result() : firebase::firestore::DocumentReference();
 			AsyncTask(ENamedThreads::GameThread, [Callback, Error, Reference]() -> void
 			{
-				UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
-
-				*Document->Reference = Reference;
-
-				Callback.ExecuteIfBound(Error, Document);
+				Callback.ExecuteIfBound(Error, FFirestoreReferenceCache::Get().FindOrAdd(Reference));
 			});
 		}
 	});
@@ -3,6 +3,9 @@
 #include "Firestore/DocumentReference.h"
 #include "Firestore/CollectionReference.h"
 #include "Firestore/DocumentSnapshot.h"
+#include "Firestore/FirestoreStructCodec.h"
+#include "Firestore/FirestoreWriteCoalescer.h"
+#include "Firestore/FirestoreSnapshotPoller.h"
 
 THIRD_PARTY_INCLUDES_START
 #	include "firebase/future.h"
@@ -12,6 +15,7 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 
 #include "Async/Async.h"
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
 
 UFirestoreDocumentReference::UFirestoreDocumentReference(FVTableHelper& Helper) : Super(Helper)
 {
@@ -129,6 +133,12 @@ void UFirestoreDocumentReference::Set(const TMap<FString, FFirestoreFieldValue>&
 	const FFirestoreSetOptions& options, FFirestoreCallback Callback)
 {
 #if WITH_FIREBASE_FIRESTORE 
+	if (FFirestoreWriteCoalescer::Get().IsEnabled())
+	{
+		FFirestoreWriteCoalescer::Get().Set(this, Data, options, MoveTemp(Callback));
+		return;
+	}
+
 	std::unordered_map<std::string, firebase::firestore::FieldValue> RawData;
 
 	RawData.reserve(Data.Num());
@@ -147,9 +157,33 @@ void UFirestoreDocumentReference::Set(const TMap<FString, FFirestoreFieldValue>&
 	Set(Data, {}, MoveTemp(Callback));
 }
 
+void UFirestoreDocumentReference::SetStruct(const UStruct* const Struct, const void* const StructData,
+	const FFirestoreSetOptions& options, FFirestoreCallback Callback)
+{
+#if WITH_FIREBASE_FIRESTORE 
+	// Queued writes are committed first to keep the writes in order.
+	if (FFirestoreWriteCoalescer::Get().IsEnabled())
+	{
+		FFirestoreWriteCoalescer::Get().Flush();
+	}
+
+	std::unordered_map<std::string, firebase::firestore::FieldValue> RawData;
+
+	FirestoreStructCodec::Write(Struct, StructData, RawData);
+
+	Reference->Set(RawData, options).OnCompletion(CreateVoidCallback("Failed to set document Reference->"));
+#endif // WITH_FIREBASE_FIRESTORE 
+}
+
 void UFirestoreDocumentReference::Update(const TMap<FString, FFirestoreFieldValue>& Data, FFirestoreCallback Callback)
 {
 #if WITH_FIREBASE_FIRESTORE 
+	if (FFirestoreWriteCoalescer::Get().IsEnabled())
+	{
+		FFirestoreWriteCoalescer::Get().Update(this, Data, MoveTemp(Callback));
+		return;
+	}
+
 	std::unordered_map<std::string, firebase::firestore::FieldValue> RawData;
 
 	RawData.reserve(Data.Num());
@@ -166,6 +200,12 @@ void UFirestoreDocumentReference::Update(const TMap<FString, FFirestoreFieldValu
 void UFirestoreDocumentReference::Update(const TMap<FFirestoreFieldPath, FFirestoreFieldValue>& Data, FFirestoreCallback Callback)
 {
 #if WITH_FIREBASE_FIRESTORE 
+	if (FFirestoreWriteCoalescer::Get().IsEnabled())
+	{
+		FFirestoreWriteCoalescer::Get().Update(this, Data, MoveTemp(Callback));
+		return;
+	}
+
 	std::unordered_map<firebase::firestore::FieldPath, firebase::firestore::FieldValue> RawData;
 
 	RawData.reserve(Data.Num());
@@ -182,6 +222,12 @@ void UFirestoreDocumentReference::Update(const TMap<FFirestoreFieldPath, FFirest
 void UFirestoreDocumentReference::Delete(FFirestoreCallback Callback)
 {
 #if WITH_FIREBASE_FIRESTORE 
+	if (FFirestoreWriteCoalescer::Get().IsEnabled())
+	{
+		FFirestoreWriteCoalescer::Get().Delete(this, MoveTemp(Callback));
+		return;
+	}
+
 	Reference->Delete().OnCompletion(CreateVoidCallback("Failed to delete document Reference->"));
 #endif // WITH_FIREBASE_FIRESTORE 
 }
@@ -206,34 +252,21 @@ FString UFirestoreDocumentReference::ToString() const
 
 #undef CreateVoidCallback
 
-void UFirestoreDocumentReference::AddSnapshotListener(FDocumentSnapshotListener Callback)
+FQuerySnapshotListenerHandle UFirestoreDocumentReference::AddSnapshotListener(FDocumentSnapshotListener Callback)
 {
-#if !PLATFORM_LINUX && WITH_FIREBASE_FIRESTORE && defined(FIREBASE_USE_STD_FUNCTION) && !PLATFORM_IOS
-	Reference->AddSnapshotListener([Callback = MoveTemp(Callback)]
-#if FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
-	(const firebase::firestore::DocumentSnapshot& Snapshot, firebase::firestore::Error NativeError) mutable -> void
-#else
-	(const firebase::firestore::DocumentSnapshot& Snapshot, firebase::firestore::Error NativeError, const std::string&) mutable -> void
-#endif
-	{
-		if (Callback.IsBound())
+	// Bound weakly to the Blueprint's object so the listener knows when nobody listens anymore.
+	return AddSnapshotListener(FDocumentSnapshotListenerCallback::CreateWeakLambda(Callback.GetUObject(),
+		[Callback](const EFirestoreError Error, const FFirestoreDocumentSnapshot& Snapshot) -> void
 		{
-			const EFirestoreError Error = (EFirestoreError)NativeError;
-			AsyncTask(ENamedThreads::GameThread, [Snapshot, Callback = MoveTemp(Callback), Error]() -> void
-			{
-				Callback.ExecuteIfBound(Error, Snapshot);
-			});
+			Callback.ExecuteIfBound(Error, Snapshot);
 		}
-	});
-#else // not LINUX || not WITH_FIREBASE_FIRESTORE || not defined(FIREBASE_USE_STD_FUNCTION) || PLATFORM_IOS
-	UE_LOG(LogFirestore, Warning, TEXT("Function AddSnapshotListener is unavailable for this platform."));
-#endif
+	));
 }
 
-void UFirestoreDocumentReference::AddSnapshotListener(FDocumentSnapshotListenerCallback Callback)
+FQuerySnapshotListenerHandle UFirestoreDocumentReference::AddSnapshotListener(FDocumentSnapshotListenerCallback Callback)
 {
-#if !PLATFORM_LINUX && WITH_FIREBASE_FIRESTORE && defined(FIREBASE_USE_STD_FUNCTION) && !PLATFORM_IOS
-	Reference->AddSnapshotListener([Callback = MoveTemp(Callback)]
+#if WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS
+	return FQuerySnapshotListenerHandle(Reference->AddSnapshotListener([Callback = MoveTemp(Callback), Channel = FFirebaseEventDispatcher::CreateChannel()]
 #if FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
 		(const firebase::firestore::DocumentSnapshot & Snapshot, firebase::firestore::Error NativeError) mutable -> void
 #else
@@ -243,14 +276,38 @@ void UFirestoreDocumentReference::AddSnapshotListener(FDocumentSnapshotListenerC
 		if (Callback.IsBound())
 		{
 			const EFirestoreError Error = (EFirestoreError)NativeError;
-			AsyncTask(ENamedThreads::GameThread, [Snapshot, Callback = MoveTemp(Callback), Error]() -> void
+			// A newer snapshot of the document supersedes the ones not delivered yet.
+			FFirebaseEventDispatcher::Get().Dispatch(Channel, [Snapshot, Callback, Error]() -> void
 			{
 				Callback.ExecuteIfBound(Error, Snapshot);
 			});
 		}
+	}));
+#elif WITH_FIREBASE_FIRESTORE
+	// Set once added, before any poll result is dispatched to the game thread.
+	const TSharedRef<uint64, ESPMode::ThreadSafe> PolledListenerId = MakeShared<uint64, ESPMode::ThreadSafe>(0);
+
+	// No SDK listeners on this platform: the document is polled and the callback called when it changed.
+	*PolledListenerId = FFirestoreSnapshotPoller::Get().AddDocument(*Reference, [Callback = MoveTemp(Callback), Channel = FFirebaseEventDispatcher::CreateChannel(), PolledListenerId]
+		(const firebase::firestore::DocumentSnapshot& Snapshot, const EFirestoreError Error) -> void
+	{
+		FFirebaseEventDispatcher::Get().Dispatch(Channel, [Snapshot, Callback, Error, PolledListenerId]() -> void
+		{
+			// Each poll is a billed read: stop once the callback's object is gone.
+			if (!Callback.IsBound())
+			{
+				FFirestoreSnapshotPoller::Get().Remove(*PolledListenerId);
+				return;
+			}
+
+			Callback.Execute(Error, Snapshot);
+		});
 	});
-#else // not LINUX || not WITH_FIREBASE_FIRESTORE || not defined(FIREBASE_USE_STD_FUNCTION) || PLATFORM_IOS
+
+	return FQuerySnapshotListenerHandle(*PolledListenerId);
+#else
 	UE_LOG(LogFirestore, Warning, TEXT("Function AddSnapshotListener is unavailable for this platform."));
+	return FQuerySnapshotListenerHandle();
 #endif
 }
 
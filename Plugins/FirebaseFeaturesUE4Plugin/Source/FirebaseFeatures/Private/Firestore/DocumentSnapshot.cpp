@@ -2,6 +2,8 @@
 
 #include "Firestore/DocumentSnapshot.h"
 #include "Firestore/DocumentReference.h"
+#include "Firestore/FirestoreReferenceCache.h"
+#include "Firestore/FirestoreStructCodec.h"
 
 #if WITH_FIREBASE_FIRESTORE
 THIRD_PARTY_INCLUDES_START
@@ -26,11 +28,11 @@ FString FFirestoreDocumentSnapshot::GetId() const
 
 UFirestoreDocumentReference* FFirestoreDocumentSnapshot::GetReference() const
 {
-    UFirestoreDocumentReference* const Ref = NewObject<UFirestoreDocumentReference>();
 #if WITH_FIREBASE_FIRESTORE
-    *Ref->Reference = Snapshot.reference();
+    return FFirestoreReferenceCache::Get().FindOrAdd(Snapshot.reference());
+#else
+    return NewObject<UFirestoreDocumentReference>();
 #endif
-    return Ref;
 }
 
 FFirestoreSnapshotMetadata FFirestoreDocumentSnapshot::GetMetadata() const
@@ -60,7 +62,7 @@ TMap<FString, FFirestoreFieldValue> FFirestoreDocumentSnapshot::GetData(
     TMap<FString, FFirestoreFieldValue> Values;
 
 #if WITH_FIREBASE_FIRESTORE
-    const std::unordered_map<std::string, firebase::firestore::FieldValue>& RawValues =
+    std::unordered_map<std::string, firebase::firestore::FieldValue> RawValues =
         Snapshot.GetData(
             (firebase::firestore::DocumentSnapshot::ServerTimestampBehavior)
             ServerTimestampBehavior);
@@ -68,15 +70,31 @@ TMap<FString, FFirestoreFieldValue> FFirestoreDocumentSnapshot::GetData(
 
     Values.Reserve(RawValues.size());
 
-    for (const auto& Value : RawValues)
+    for (auto& Value : RawValues)
     {
-        Values.Add(UTF8_TO_TCHAR(Value.first.c_str()), Value.second);
+        Values.Add(UTF8_TO_TCHAR(Value.first.c_str()), MoveTemp(Value.second));
     }
 #endif
 
     return Values;
 }
 
+bool FFirestoreDocumentSnapshot::ToStruct(const UStruct* const Struct, void* const StructData,
+    EFirestoreServerTimestampBehavior ServerTimestampBehavior) const
+{
+#if WITH_FIREBASE_FIRESTORE
+    if (!Snapshot.is_valid() || !Snapshot.exists())
+    {
+        return false;
+    }
+
+    return FirestoreStructCodec::Read(Struct, StructData, Snapshot.GetData(
+        (firebase::firestore::DocumentSnapshot::ServerTimestampBehavior)ServerTimestampBehavior));
+#else
+    return false;
+#endif
+}
+
 FFirestoreFieldValue FFirestoreDocumentSnapshot::Get(
     const FString& Field,
     EFirestoreServerTimestampBehavior ServerTimestampBehavior) const
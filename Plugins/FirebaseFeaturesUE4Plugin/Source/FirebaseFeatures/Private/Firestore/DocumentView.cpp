@@ -0,0 +1,340 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/DocumentView.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/geo_point.h"
+#	include "firebase/firestore/timestamp.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+// FFirestoreFieldKey
+
+FFirestoreFieldKey::FFirestoreFieldKey(const TCHAR* const Name)
+#if WITH_FIREBASE_FIRESTORE
+	: Utf8(TCHAR_TO_UTF8(Name))
+#endif // WITH_FIREBASE_FIRESTORE
+{
+}
+
+FFirestoreFieldKey::FFirestoreFieldKey(const FString& Name)
+	: FFirestoreFieldKey(*Name)
+{
+}
+
+// FFirestoreValueView
+
+FFirestoreValueView::FFirestoreValueView()
+{
+}
+
+FFirestoreValueView::FFirestoreValueView(const FFirestoreValueView& Other)
+#if WITH_FIREBASE_FIRESTORE
+	: Owned(Other.Owned)
+	, Value(Other.Value == &Other.Owned ? &Owned : Other.Value)
+#endif // WITH_FIREBASE_FIRESTORE
+{
+}
+
+FFirestoreValueView::FFirestoreValueView(FFirestoreValueView&& Other)
+#if WITH_FIREBASE_FIRESTORE
+	: Owned(MoveTemp(Other.Owned))
+	, Value(Other.Value == &Other.Owned ? &Owned : Other.Value)
+#endif // WITH_FIREBASE_FIRESTORE
+{
+#if WITH_FIREBASE_FIRESTORE
+	Other.Value = nullptr;
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+FFirestoreValueView& FFirestoreValueView::operator=(const FFirestoreValueView& Other)
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (this != &Other)
+	{
+		Owned = Other.Owned;
+		Value = Other.Value == &Other.Owned ? &Owned : Other.Value;
+	}
+#endif // WITH_FIREBASE_FIRESTORE
+	return *this;
+}
+
+FFirestoreValueView& FFirestoreValueView::operator=(FFirestoreValueView&& Other)
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (this != &Other)
+	{
+		Owned		= MoveTemp(Other.Owned);
+		Value		= Other.Value == &Other.Owned ? &Owned : Other.Value;
+		Other.Value = nullptr;
+	}
+#endif // WITH_FIREBASE_FIRESTORE
+	return *this;
+}
+
+#if WITH_FIREBASE_FIRESTORE
+FFirestoreValueView::FFirestoreValueView(firebase::firestore::FieldValue&& InValue)
+	: Owned(MoveTemp(InValue))
+	, Value(Owned.is_valid() ? &Owned : nullptr)
+{
+}
+
+FFirestoreValueView::FFirestoreValueView(const firebase::firestore::FieldValue* InValue)
+	: Value(InValue && InValue->is_valid() ? InValue : nullptr)
+{
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+bool FFirestoreValueView::IsValid() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return Value != nullptr;
+#else
+	return false;
+#endif
+}
+
+EFirestoreFieldValueType FFirestoreValueView::GetType() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return Value ? (EFirestoreFieldValueType)Value->type() : EFirestoreFieldValueType::Null;
+#else
+	return EFirestoreFieldValueType::Null;
+#endif
+}
+
+bool FFirestoreValueView::IsNull() const
+{
+	return GetType() == EFirestoreFieldValueType::Null;
+}
+
+#if WITH_FIREBASE_FIRESTORE
+#	define RETURN_TYPE(TypeName, DefaultValue) \
+		return Value && Value->is_ ## TypeName () ? Value-> TypeName ## _value() : DefaultValue
+#else
+#	define RETURN_TYPE(TypeName, DefaultValue) return DefaultValue
+#endif  // WITH_FIREBASE_FIRESTORE
+
+bool FFirestoreValueView::GetBool(const bool bDefault) const
+{
+	RETURN_TYPE(boolean, bDefault);
+}
+
+int64 FFirestoreValueView::GetInt64(const int64 Default) const
+{
+	RETURN_TYPE(integer, Default);
+}
+
+#undef RETURN_TYPE
+
+double FFirestoreValueView::GetDouble(const double Default) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_integer())
+	{
+		return (double)Value->integer_value();
+	}
+
+	return Value && Value->is_double() ? Value->double_value() : Default;
+#else
+	return Default;
+#endif
+}
+
+FString FFirestoreValueView::GetString(const FString& Default) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_string())
+	{
+		const std::string String = Value->string_value();
+		const FUTF8ToTCHAR Converted(String.c_str(), String.size());
+		return FString(Converted.Length(), Converted.Get());
+	}
+#endif
+	return Default;
+}
+
+FFirestoreTimestamp FFirestoreValueView::GetTimestamp() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_timestamp())
+	{
+		const firebase::Timestamp Time = Value->timestamp_value();
+		return FFirestoreTimestamp(Time.seconds(), Time.nanoseconds());
+	}
+#endif
+	return FFirestoreTimestamp();
+}
+
+FFirestoreGeoPoint FFirestoreValueView::GetGeoPoint() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_geo_point())
+	{
+		const firebase::firestore::GeoPoint Point = Value->geo_point_value();
+		return FFirestoreGeoPoint((float)Point.latitude(), (float)Point.longitude());
+	}
+#endif
+	return FFirestoreGeoPoint();
+}
+
+TArrayView<const uint8> FFirestoreValueView::GetBlob() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_blob())
+	{
+		return TArrayView<const uint8>(Value->blob_value(), (int32)Value->blob_size());
+	}
+#endif
+	return TArrayView<const uint8>();
+}
+
+FFirestoreArrayView FFirestoreValueView::GetArrayView() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_array())
+	{
+		return FFirestoreArrayView(Value->array_value());
+	}
+#endif
+	return FFirestoreArrayView();
+}
+
+FFirestoreMapView FFirestoreValueView::GetMapView() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value && Value->is_map())
+	{
+		return FFirestoreMapView(Value->map_value());
+	}
+#endif
+	return FFirestoreMapView();
+}
+
+FFirestoreFieldValue FFirestoreValueView::ToFieldValue() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Value)
+	{
+		return FFirestoreFieldValue(*Value);
+	}
+#endif
+	return FFirestoreFieldValue();
+}
+
+// FFirestoreArrayView
+
+#if WITH_FIREBASE_FIRESTORE
+FFirestoreArrayView::FFirestoreArrayView(std::vector<firebase::firestore::FieldValue>&& InValues)
+	: Values(MoveTemp(InValues))
+{
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+int32 FFirestoreArrayView::Num() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return (int32)Values.size();
+#else
+	return 0;
+#endif
+}
+
+FFirestoreValueView FFirestoreArrayView::GetValue(const int32 Index) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Index >= 0 && Index < (int32)Values.size())
+	{
+		return FFirestoreValueView(&Values[Index]);
+	}
+#endif
+	return FFirestoreValueView();
+}
+
+// FFirestoreMapView
+
+#if WITH_FIREBASE_FIRESTORE
+FFirestoreMapView::FFirestoreMapView(firebase::firestore::MapFieldValue&& InValues)
+	: Values(MoveTemp(InValues))
+{
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+int32 FFirestoreMapView::Num() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return (int32)Values.size();
+#else
+	return 0;
+#endif
+}
+
+FFirestoreValueView FFirestoreMapView::GetValue(const FFirestoreFieldKey& Key) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	const auto Found = Values.find(Key.Get());
+
+	if (Found != Values.end())
+	{
+		return FFirestoreValueView(&Found->second);
+	}
+#endif
+	return FFirestoreValueView();
+}
+
+void FFirestoreMapView::ForEach(TFunctionRef<void(const ANSICHAR* Key, const FFirestoreValueView& Value)> Callback) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	for (const auto& Field : Values)
+	{
+		Callback(Field.first.c_str(), FFirestoreValueView(&Field.second));
+	}
+#endif
+}
+
+// FFirestoreDocumentView
+
+FFirestoreDocumentView::FFirestoreDocumentView(const FFirestoreDocumentSnapshot& InSnapshot,
+	const EFirestoreServerTimestampBehavior InServerTimestampBehavior)
+#if WITH_FIREBASE_FIRESTORE
+	: Snapshot(InSnapshot)
+	, ServerTimestampBehavior(InServerTimestampBehavior)
+#else
+	: ServerTimestampBehavior(InServerTimestampBehavior)
+#endif // WITH_FIREBASE_FIRESTORE
+{
+}
+
+bool FFirestoreDocumentView::Exists() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return Snapshot.is_valid() && Snapshot.exists();
+#else
+	return false;
+#endif
+}
+
+FFirestoreValueView FFirestoreDocumentView::GetValue(const FFirestoreFieldKey& Key) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Snapshot.is_valid())
+	{
+		return FFirestoreValueView(Snapshot.Get(Key.Get(),
+			(firebase::firestore::DocumentSnapshot::ServerTimestampBehavior)ServerTimestampBehavior));
+	}
+#endif
+	return FFirestoreValueView();
+}
+
+FFirestoreValueView FFirestoreDocumentView::GetValue(const FFirestoreFieldPath& Path) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Snapshot.is_valid())
+	{
+		return FFirestoreValueView(Snapshot.Get(Path,
+			(firebase::firestore::DocumentSnapshot::ServerTimestampBehavior)ServerTimestampBehavior));
+	}
+#endif
+	return FFirestoreValueView();
+}
@@ -1,6 +1,7 @@
 
 #include "Firestore/FieldValue.h"
 #include "Firestore/DocumentReference.h"
+#include "Firestore/FirestoreReferenceCache.h"
 
 #if WITH_FIREBASE_FIRESTORE
 	THIRD_PARTY_INCLUDES_START
@@ -57,23 +58,77 @@ FString FFirestoreTimestamp::ToString() const
 }
 
 FFirestoreFieldValue::FFirestoreFieldValue()
+{
+	Inline.Integer = 0;
+}
+
+FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreFieldValue& Other)
+	: InlineType(Other.InlineType)
+	, Inline(Other.Inline)
+{
 #if WITH_FIREBASE_FIRESTORE
-	: FieldValue(MakeUnique<firebase::firestore::FieldValue>())
+	if (Other.FieldValue)
+	{
+		FieldValue = MakeUnique<firebase::firestore::FieldValue>(*Other.FieldValue);
+	}
 #endif // WITH_FIREBASE_FIRESTORE
-{
 }
-FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreFieldValue& Other) : FFirestoreFieldValue()
+
+FFirestoreFieldValue::FFirestoreFieldValue(FFirestoreFieldValue&& Other)
+	: InlineType(Other.InlineType)
+	, Inline(Other.Inline)
 {
 #if WITH_FIREBASE_FIRESTORE
-	*FieldValue = *Other.FieldValue;
+	FieldValue = MoveTemp(Other.FieldValue);
 #endif // WITH_FIREBASE_FIRESTORE
+
+	Other.InlineType = EFirestoreFieldValueType::Null;
 }
 
 FFirestoreFieldValue& FFirestoreFieldValue::operator=(const FFirestoreFieldValue& Other)
 {
+	if (this == &Other)
+	{
+		return *this;
+	}
+
+	InlineType = Other.InlineType;
+	Inline	   = Other.Inline;
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Other.FieldValue)
+	{
+		FieldValue.Reset();
+	}
+	else if (FieldValue)
+	{
+		*FieldValue = *Other.FieldValue;
+	}
+	else
+	{
+		FieldValue = MakeUnique<firebase::firestore::FieldValue>(*Other.FieldValue);
+	}
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return *this;
+}
+
+FFirestoreFieldValue& FFirestoreFieldValue::operator=(FFirestoreFieldValue&& Other)
+{
+	if (this == &Other)
+	{
+		return *this;
+	}
+
+	InlineType = Other.InlineType;
+	Inline	   = Other.Inline;
+
 #if WITH_FIREBASE_FIRESTORE
-	*FieldValue.Get() = *Other.FieldValue.Get();
+	FieldValue = MoveTemp(Other.FieldValue);
 #endif // WITH_FIREBASE_FIRESTORE
+
+	Other.InlineType = EFirestoreFieldValueType::Null;
+
 	return *this;
 }
 
@@ -81,10 +136,65 @@ FFirestoreFieldValue::~FFirestoreFieldValue()
 {
 }
 
+#if WITH_FIREBASE_FIRESTORE
+FFirestoreFieldValue::operator firebase::firestore::FieldValue& ()
+{
+	if (!FieldValue)
+	{
+		FieldValue = MakeUnique<firebase::firestore::FieldValue>(ToNative());
+	}
+
+	return *FieldValue;
+}
+
+firebase::firestore::FieldValue FFirestoreFieldValue::ToNative() const
+{
+	if (FieldValue)
+	{
+		return *FieldValue;
+	}
+
+	switch (InlineType)
+	{
+	case EFirestoreFieldValueType::Boolean:
+		return firebase::firestore::FieldValue::Boolean(Inline.bBoolean);
+
+	case EFirestoreFieldValueType::Integer:
+		return firebase::firestore::FieldValue::Integer(Inline.Integer);
+
+	case EFirestoreFieldValueType::Double:
+		return firebase::firestore::FieldValue::Double(Inline.Double);
+
+	case EFirestoreFieldValueType::Timestamp:
+		return firebase::firestore::FieldValue::Timestamp(firebase::Timestamp(Inline.Timestamp.Seconds, Inline.Timestamp.Nanoseconds));
+
+	case EFirestoreFieldValueType::GeoPoint:
+		return firebase::firestore::FieldValue::GeoPoint(firebase::firestore::GeoPoint(Inline.GeoPoint.Latitude, Inline.GeoPoint.Longitude));
+
+	default:
+		return firebase::firestore::FieldValue::Null();
+	}
+}
+
+firebase::firestore::FieldValue FFirestoreFieldValue::MoveToNative()
+{
+	if (!FieldValue)
+	{
+		firebase::firestore::FieldValue Value = ToNative();
+		InlineType = EFirestoreFieldValueType::Null;
+		return Value;
+	}
+
+	firebase::firestore::FieldValue Value = MoveTemp(*FieldValue);
+	FieldValue.Reset();
+	return Value;
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
 FFirestoreFieldValue::operator TArray<uint8>() const
 {
 #if WITH_FIREBASE_FIRESTORE
-	return FieldValue->is_blob() ?
+	return !IsInline() && FieldValue->is_blob() ?
 		TArray<uint8>(FieldValue->blob_value(), FieldValue->blob_size()) :
 		TArray<uint8>();
 #else
@@ -98,10 +208,12 @@ FFirestoreFieldValue::operator TArray<FFirestoreFieldValue>() const
 	TArray<FFirestoreFieldValue> Array;
 
 #if WITH_FIREBASE_FIRESTORE
-	if (FieldValue->is_array())
+	if (!IsInline() && FieldValue->is_array())
 	{
 		const auto& ArrayRaw = FieldValue->array_value();
 
+		Array.Reserve(ArrayRaw.size());
+
 		for (const auto& ArrayElem : ArrayRaw)
 		{
 			Array.Emplace(ArrayElem);
@@ -117,10 +229,12 @@ FFirestoreFieldValue::operator TMap<FString, FFirestoreFieldValue>() const
 	TMap<FString, FFirestoreFieldValue> Map;
 
 #if WITH_FIREBASE_FIRESTORE
-	if (FieldValue->is_map())
+	if (!IsInline() && FieldValue->is_map())
 	{
 		const auto& MapRaw = FieldValue->map_value();
 
+		Map.Reserve(MapRaw.size());
+
 		for (const auto& MapElem : MapRaw)
 		{
 			Map.Emplace(UTF8_TO_TCHAR(MapElem.first.c_str()), MapElem.second);
@@ -134,16 +248,12 @@ FFirestoreFieldValue::operator TMap<FString, FFirestoreFieldValue>() const
 FFirestoreFieldValue::operator UFirestoreDocumentReference* () const
 {
 #if WITH_FIREBASE_FIRESTORE
-	if (!FieldValue->is_reference())
+	if (IsInline() || !FieldValue->is_reference())
 	{
 		return nullptr;
 	}
 
-	UFirestoreDocumentReference* const Reference = NewObject<UFirestoreDocumentReference>();
-
-	*Reference->Reference = FieldValue->reference_value();
-
-	return Reference;
+	return FFirestoreReferenceCache::Get().FindOrAdd(FieldValue->reference_value());
 #else
 	return nullptr;
 #endif // WITH_FIREBASE_FIRESTORE
@@ -152,54 +262,50 @@ FFirestoreFieldValue::operator UFirestoreDocumentReference* () const
 #if WITH_FIREBASE_FIRESTORE
 FFirestoreFieldValue::FFirestoreFieldValue(const firebase::firestore::FieldValue& Value) : FFirestoreFieldValue()
 {
-	*FieldValue = Value;
+	SetValue(Value);
+}
+
+FFirestoreFieldValue::FFirestoreFieldValue(firebase::firestore::FieldValue&& Value) : FFirestoreFieldValue()
+{
+	SetValue(MoveTemp(Value));
 }
 #endif // WITH_FIREBASE_FIRESTORE
 
 FFirestoreFieldValue::FFirestoreFieldValue(const bool bValue) : FFirestoreFieldValue()
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Boolean(bValue));
-#endif // WITH_FIREBASE_FIRESTORE
+	InlineType		= EFirestoreFieldValueType::Boolean;
+	Inline.bBoolean = bValue;
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const int32  Value) : FFirestoreFieldValue()
+FFirestoreFieldValue::FFirestoreFieldValue(const int32  Value) : FFirestoreFieldValue((int64)Value)
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Integer((int64_t)Value));
-#endif // WITH_FIREBASE_FIRESTORE
 }
 
 FFirestoreFieldValue::FFirestoreFieldValue(const int64  Value) : FFirestoreFieldValue()
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Integer(Value));
-#endif // WITH_FIREBASE_FIRESTORE
+	InlineType	   = EFirestoreFieldValueType::Integer;
+	Inline.Integer = Value;
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const float  Value) : FFirestoreFieldValue()
+FFirestoreFieldValue::FFirestoreFieldValue(const float  Value) : FFirestoreFieldValue((double)Value)
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Double((float)Value));
-#endif // WITH_FIREBASE_FIRESTORE
 }
 
 FFirestoreFieldValue::FFirestoreFieldValue(const double Value) : FFirestoreFieldValue()
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Double(Value));
-#endif // WITH_FIREBASE_FIRESTORE
+	InlineType	  = EFirestoreFieldValueType::Double;
+	Inline.Double = Value;
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const TCHAR* Value) : FFirestoreFieldValue(FString(Value))
+FFirestoreFieldValue::FFirestoreFieldValue(const TCHAR* Value) : FFirestoreFieldValue()
 {
+#if WITH_FIREBASE_FIRESTORE
+	SetValue(firebase::firestore::FieldValue::String(TCHAR_TO_UTF8(Value)));
+#endif // WITH_FIREBASE_FIRESTORE
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const FString& Value) : FFirestoreFieldValue()
+FFirestoreFieldValue::FFirestoreFieldValue(const FString& Value) : FFirestoreFieldValue(*Value)
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::String(TCHAR_TO_UTF8(*Value)));
-#endif // WITH_FIREBASE_FIRESTORE
 }
 
 FFirestoreFieldValue::FFirestoreFieldValue(const TArray<uint8>& Value) : FFirestoreFieldValue()
@@ -218,25 +324,25 @@ FFirestoreFieldValue::FFirestoreFieldValue(const TArray<FFirestoreFieldValue>& V
 
 	for (const auto& Val : Value)
 	{
-		Values.push_back(Val);
+		Values.push_back(Val.ToNative());
 	}
 
-	SetValue(firebase::firestore::FieldValue::Array(Values));
+	SetValue(firebase::firestore::FieldValue::Array(MoveTemp(Values)));
 #endif // WITH_FIREBASE_FIRESTORE
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreGeoPoint& Value)
+FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreGeoPoint& Value) : FFirestoreFieldValue()
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::GeoPoint(firebase::firestore::GeoPoint(Value.Latitude, Value.Longitude)));
-#endif
+	InlineType				= EFirestoreFieldValueType::GeoPoint;
+	Inline.GeoPoint.Latitude  = Value.Latitude;
+	Inline.GeoPoint.Longitude = Value.Longitude;
 }
 
-FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreTimestamp& Value)
+FFirestoreFieldValue::FFirestoreFieldValue(const FFirestoreTimestamp& Value) : FFirestoreFieldValue()
 {
-#if WITH_FIREBASE_FIRESTORE
-	SetValue(firebase::firestore::FieldValue::Timestamp(firebase::Timestamp(Value.Seconds, Value.Nanoseconds)));
-#endif
+	InlineType					= EFirestoreFieldValueType::Timestamp;
+	Inline.Timestamp.Seconds	 = Value.Seconds;
+	Inline.Timestamp.Nanoseconds = Value.Nanoseconds;
 }
 
 FFirestoreFieldValue::FFirestoreFieldValue(const TMap<FString, FFirestoreFieldValue>& Value) : FFirestoreFieldValue()
@@ -248,10 +354,10 @@ FFirestoreFieldValue::FFirestoreFieldValue(const TMap<FString, FFirestoreFieldVa
 
 	for (const auto& Val : Value)
 	{
-		Values.emplace(TCHAR_TO_UTF8(*Val.Key), Val.Value);
+		Values.emplace(TCHAR_TO_UTF8(*Val.Key), Val.Value.ToNative());
 	}
 
-	SetValue(firebase::firestore::FieldValue::Map(Values));
+	SetValue(firebase::firestore::FieldValue::Map(MoveTemp(Values)));
 #endif // WITH_FIREBASE_FIRESTORE
 }
 
@@ -266,51 +372,135 @@ FFirestoreFieldValue::FFirestoreFieldValue(UFirestoreDocumentReference* const Va
 }
 
 #if WITH_FIREBASE_FIRESTORE
+namespace
+{
+	/** Copies the native value to the inline storage if it is one of the inline types. */
+	bool TryStoreInline(const firebase::firestore::FieldValue& Value, EFirestoreFieldValueType& OutType, FFirestoreInlineFieldValue& OutInline)
+	{
+		switch (Value.type())
+		{
+		case firebase::firestore::FieldValue::Type::kNull:
+			OutType = EFirestoreFieldValueType::Null;
+			return true;
+
+		case firebase::firestore::FieldValue::Type::kBoolean:
+			OutType			  = EFirestoreFieldValueType::Boolean;
+			OutInline.bBoolean = Value.boolean_value();
+			return true;
+
+		case firebase::firestore::FieldValue::Type::kInteger:
+			OutType			 = EFirestoreFieldValueType::Integer;
+			OutInline.Integer = Value.integer_value();
+			return true;
+
+		case firebase::firestore::FieldValue::Type::kDouble:
+			OutType			= EFirestoreFieldValueType::Double;
+			OutInline.Double = Value.double_value();
+			return true;
+
+		case firebase::firestore::FieldValue::Type::kTimestamp:
+		{
+			const firebase::Timestamp Timestamp = Value.timestamp_value();
+			OutType						   = EFirestoreFieldValueType::Timestamp;
+			OutInline.Timestamp.Seconds	   = Timestamp.seconds();
+			OutInline.Timestamp.Nanoseconds = Timestamp.nanoseconds();
+			return true;
+		}
+
+		case firebase::firestore::FieldValue::Type::kGeoPoint:
+		{
+			const firebase::firestore::GeoPoint GeoPoint = Value.geo_point_value();
+			OutType					   = EFirestoreFieldValueType::GeoPoint;
+			OutInline.GeoPoint.Latitude  = GeoPoint.latitude();
+			OutInline.GeoPoint.Longitude = GeoPoint.longitude();
+			return true;
+		}
+
+		default:
+			return false;
+		}
+	}
+}
+
 void FFirestoreFieldValue::SetValue(const firebase::firestore::FieldValue& Value)
 {
-	*FieldValue.Get() = Value;
+	if (TryStoreInline(Value, InlineType, Inline))
+	{
+		FieldValue.Reset();
+	}
+	else if (FieldValue)
+	{
+		*FieldValue = Value;
+	}
+	else
+	{
+		FieldValue = MakeUnique<firebase::firestore::FieldValue>(Value);
+	}
+}
+
+void FFirestoreFieldValue::SetValue(firebase::firestore::FieldValue&& Value)
+{
+	if (TryStoreInline(Value, InlineType, Inline))
+	{
+		FieldValue.Reset();
+	}
+	else if (FieldValue)
+	{
+		*FieldValue = MoveTemp(Value);
+	}
+	else
+	{
+		FieldValue = MakeUnique<firebase::firestore::FieldValue>(MoveTemp(Value));
+	}
 }
 #endif // WITH_FIREBASE_FIRESTORE
 
 EFirestoreFieldValueType FFirestoreFieldValue::GetType() const
 {
 #if WITH_FIREBASE_FIRESTORE
-	return (EFirestoreFieldValueType)FieldValue->type();
-#else
-	return EFirestoreFieldValueType::Null;
+	if (!IsInline())
+	{
+		return (EFirestoreFieldValueType)FieldValue->type();
+	}
 #endif
+	return InlineType;
 }
 
 #if WITH_FIREBASE_FIRESTORE
-#	define RETURN_TYPE(TypeName, DefaultValue) \
+#	define RETURN_TYPE(TypeName, InlineTypeName, InlineMember, DefaultValue)								\
+		if (IsInline())																					\
+		{																								\
+			return InlineType == EFirestoreFieldValueType::InlineTypeName ? Inline.InlineMember : DefaultValue;	\
+		}																								\
 		return FieldValue->is_ ## TypeName () ? FieldValue-> TypeName ## _value() : DefaultValue
 #else
-#	define RETURN_TYPE(TypeName, DefaultValue) return DefaultValue
+#	define RETURN_TYPE(TypeName, InlineTypeName, InlineMember, DefaultValue) \
+		return InlineType == EFirestoreFieldValueType::InlineTypeName ? Inline.InlineMember : DefaultValue
 #endif  // WITH_FIREBASE_FIRESTORE
 
 FFirestoreFieldValue::operator int32() const
 {
-	RETURN_TYPE(integer, 0);
+	RETURN_TYPE(integer, Integer, Integer, 0);
 }
 
 FFirestoreFieldValue::operator int64() const
 {
-	RETURN_TYPE(integer, 0);
+	RETURN_TYPE(integer, Integer, Integer, 0);
 }
 
 FFirestoreFieldValue::operator bool() const
 {
-	RETURN_TYPE(boolean, false);
+	RETURN_TYPE(boolean, Boolean, bBoolean, false);
 }
 
 FFirestoreFieldValue::operator float() const
 {
-	RETURN_TYPE(double, 0.f);
+	RETURN_TYPE(double, Double, Double, 0.f);
 }
 
 FFirestoreFieldValue::operator double() const
 {
-	RETURN_TYPE(double, 0.);
+	RETURN_TYPE(double, Double, Double, 0.);
 }
 
 #undef RETURN_TYPE
@@ -319,8 +509,13 @@ FFirestoreFieldValue::operator FFirestoreGeoPoint() const
 {
 	FFirestoreGeoPoint GeoPoint;
 
+	if (IsInline() && InlineType == EFirestoreFieldValueType::GeoPoint)
+	{
+		GeoPoint.Latitude  = (float)Inline.GeoPoint.Latitude;
+		GeoPoint.Longitude = (float)Inline.GeoPoint.Longitude;
+	}
 #if WITH_FIREBASE_FIRESTORE
-	if (FieldValue->is_geo_point())
+	else if (!IsInline() && FieldValue->is_geo_point())
 	{
 		auto Point = FieldValue->geo_point_value();
 
@@ -340,8 +535,13 @@ FFirestoreFieldValue::operator FFirestoreTimestamp() const
 {
 	FFirestoreTimestamp Timestamp;
 
+	if (IsInline() && InlineType == EFirestoreFieldValueType::Timestamp)
+	{
+		Timestamp.Seconds	  = Inline.Timestamp.Seconds;
+		Timestamp.Nanoseconds = Inline.Timestamp.Nanoseconds;
+	}
 #if WITH_FIREBASE_FIRESTORE
-	if (FieldValue->is_timestamp())
+	else if (!IsInline() && FieldValue->is_timestamp())
 	{
 		auto Time = FieldValue->timestamp_value();
 
@@ -356,7 +556,7 @@ FFirestoreFieldValue::operator FFirestoreTimestamp() const
 FFirestoreFieldValue::operator FString() const
 {
 #if WITH_FIREBASE_FIRESTORE
-	return FieldValue->is_string() ? UTF8_TO_TCHAR(FieldValue->string_value().c_str()) : TEXT("");
+	return !IsInline() && FieldValue->is_string() ? UTF8_TO_TCHAR(FieldValue->string_value().c_str()) : TEXT("");
 #else
 	return TEXT("FIRESTORE_DISABLED");
 #endif
@@ -424,11 +624,7 @@ FFirestoreTimestamp FFirestoreFieldValue::ToTimestamp() const
 
 bool    FFirestoreFieldValue::IsNull()   const
 {
-#if WITH_FIREBASE_FIRESTORE
-	return FieldValue->is_null();
-#else 
-	return FFirestoreFieldValue();
-#endif
+	return GetType() == EFirestoreFieldValueType::Null;
 }
 
 FFirestoreFieldValue FFirestoreFieldValue::Delete()
@@ -451,11 +647,7 @@ FFirestoreFieldValue FFirestoreFieldValue::ServerTimestamp()
 
 FFirestoreFieldValue FFirestoreFieldValue::Null()
 {
-#if WITH_FIREBASE_FIRESTORE
-	return firebase::firestore::FieldValue::Null();
-#else 
 	return FFirestoreFieldValue();
-#endif
 }
 
 FFirestoreFieldValue FFirestoreFieldValue::ArrayUnion(const TArray<FFirestoreFieldValue>& Elements)
@@ -467,7 +659,7 @@ FFirestoreFieldValue FFirestoreFieldValue::ArrayUnion(const TArray<FFirestoreFie
 
 	for (const FFirestoreFieldValue& Value : Elements)
 	{
-		elements.push_back(*Value.FieldValue);
+		elements.push_back(Value.ToNative());
 	}
 
 	return firebase::firestore::FieldValue::ArrayUnion(MoveTemp(elements));
@@ -485,7 +677,7 @@ FFirestoreFieldValue FFirestoreFieldValue::ArrayRemove(const TArray<FFirestoreFi
 
 	for (const FFirestoreFieldValue& Value : Elements)
 	{
-		elements.push_back(*Value.FieldValue);
+		elements.push_back(Value.ToNative());
 	}
 
 	return firebase::firestore::FieldValue::ArrayRemove(MoveTemp(elements));
@@ -494,4 +686,22 @@ FFirestoreFieldValue FFirestoreFieldValue::ArrayRemove(const TArray<FFirestoreFi
 #endif
 }
 
+FFirestoreFieldValue FFirestoreFieldValue::Increment(const int64 ByValue)
+{
+#if WITH_FIREBASE_FIRESTORE
+	return firebase::firestore::FieldValue::Increment<int64_t>(ByValue);
+#else 
+	return FFirestoreFieldValue();
+#endif
+}
+
+FFirestoreFieldValue FFirestoreFieldValue::Increment(const double ByValue)
+{
+#if WITH_FIREBASE_FIRESTORE
+	return firebase::firestore::FieldValue::Increment<double>(ByValue);
+#else 
+	return FFirestoreFieldValue();
+#endif
+}
+
 
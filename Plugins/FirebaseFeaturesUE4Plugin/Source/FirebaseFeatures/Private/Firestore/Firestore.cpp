@@ -13,6 +13,9 @@ THIRD_PARTY_INCLUDES_END
 #include "Firestore/CollectionReference.h"
 #include "Firestore/DocumentReference.h"
 #include "Firestore/Query.h"
+#include "Firestore/FirestoreWriteCoalescer.h"
+#include "Firestore/FirestoreMultiGet.h"
+#include "Firestore/FirestoreReferenceCache.h"
 
 #if !UE_BUILD_SHIPPING
 #	include "Misc/MessageDialog.h"
@@ -28,6 +31,8 @@ FFirestoreSetOptions FFirestoreSetOptions::Merge()
 	*Opt.Options = firebase::firestore::SetOptions::Merge();
 #endif // WITH_FIREBASE_FIRESTORE
 
+	Opt.Type = EFirestoreSetOptionsType::MergeAll;
+
 	return Opt;
 }
 
@@ -48,6 +53,8 @@ FFirestoreSetOptions FFirestoreSetOptions::MergeFields(const TArray<FString>& Fi
 	*Opt.Options = firebase::firestore::SetOptions::MergeFields(RawFields);
 #endif // WITH_FIREBASE_FIRESTORE
 
+	Opt.Type = EFirestoreSetOptionsType::MergeSpecific;
+
 	return Opt;
 }
 
@@ -68,6 +75,8 @@ FFirestoreSetOptions FFirestoreSetOptions::MergeFieldPaths(const TArray<FFiresto
 	*Opt.Options = firebase::firestore::SetOptions::MergeFieldPaths(RawFields);
 #endif // WITH_FIREBASE_FIRESTORE
 
+	Opt.Type = EFirestoreSetOptionsType::MergeSpecific;
+
 	return Opt;
 }
 FFirestoreSetOptions::FFirestoreSetOptions()
@@ -82,6 +91,7 @@ FFirestoreSetOptions::FFirestoreSetOptions(const FFirestoreSetOptions& Other) :
 #if WITH_FIREBASE_FIRESTORE
 	*Options = *Other.Options;
 #endif // WITH_FIREBASE_FIRESTORE
+	Type = Other.Type;
 }
 
 FFirestoreSetOptions::FFirestoreSetOptions(FFirestoreSetOptions&& Other) : FFirestoreSetOptions()
@@ -89,6 +99,7 @@ FFirestoreSetOptions::FFirestoreSetOptions(FFirestoreSetOptions&& Other) : FFire
 #if WITH_FIREBASE_FIRESTORE
 	*Options = *Other.Options;
 #endif // WITH_FIREBASE_FIRESTORE
+	Type = Other.Type;
 }
 
 FFirestoreSetOptions::~FFirestoreSetOptions()
@@ -101,6 +112,7 @@ FFirestoreSetOptions& FFirestoreSetOptions::operator=(const FFirestoreSetOptions
 #if WITH_FIREBASE_FIRESTORE
 	*Options = *Other.Options.Get();
 #endif // WITH_FIREBASE_FIRESTORE
+	Type = Other.Type;
 	return *this;
 }
 
@@ -229,6 +241,28 @@ FWriteBatch::FWriteBatch()
 
 }
 
+FWriteBatch::FWriteBatch(const FWriteBatch& Other) : FWriteBatch()
+{
+#if WITH_FIREBASE_FIRESTORE
+	*Batch = *Other.Batch;
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+FWriteBatch::FWriteBatch(FWriteBatch&& Other)
+	: Batch(MoveTemp(Other.Batch))
+{
+#if WITH_FIREBASE_FIRESTORE
+	Other.Batch = MakeUnique<firebase::firestore::WriteBatch>();
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+#if WITH_FIREBASE_FIRESTORE
+FWriteBatch::FWriteBatch(firebase::firestore::WriteBatch&& InBatch)
+	: Batch(MakeUnique<firebase::firestore::WriteBatch>(MoveTemp(InBatch)))
+{
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
 FWriteBatch::~FWriteBatch()
 {
 
@@ -414,17 +448,19 @@ UFirestoreDocumentReference* UFirestore::GetDocument(const FString& DocumentPath
 		return nullptr;
 	}
 
-	UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
-
 #if WITH_FIREBASE_FIRESTORE
-	firebase::firestore::Firestore* const Firestore = GetFirestore();
+	// The path is only converted when no reference to the document is alive.
+	return FFirestoreReferenceCache::Get().FindOrAdd(DocumentPath, [&DocumentPath]() -> firebase::firestore::DocumentReference
+	{
+		firebase::firestore::Firestore* const Firestore = GetFirestore();
 
-	check(Firestore);
+		check(Firestore);
 
-	*Document->Reference = Firestore->Document(TCHAR_TO_UTF8(*DocumentPath));
+		return Firestore->Document(TCHAR_TO_UTF8(*DocumentPath));
+	});
+#else
+	return NewObject<UFirestoreDocumentReference>();
 #endif // WITH_FIREBASE_FIRESTORE
-
-	return Document;
 }
 
 UFirestoreQuery* UFirestore::CollectionGroup(const FString& CollectionId)
@@ -502,6 +538,40 @@ void UFirestore::RunTransaction(const FFirestoreTransactionCallback& Transaction
 #endif // WITH_FIREBASE_FIRESTORE
 }
 
+void UFirestore::GetAll(const TArray<UFirestoreDocumentReference*>& Documents, const EFirestoreSource Source, FFirestoreDocumentsCallback Callback)
+{
+	FFirestoreMultiGet::Run(Documents, Source, MoveTemp(Callback));
+}
+
+void UFirestore::GetAll(const TArray<UFirestoreDocumentReference*>& Documents, FFirestoreDocumentsCallback Callback)
+{
+	GetAll(Documents, EFirestoreSource::Default, MoveTemp(Callback));
+}
+
+FWriteBatch UFirestore::Batch()
+{
+#if WITH_FIREBASE_FIRESTORE
+	return FWriteBatch(GetFirestore()->batch());
+#else
+	return FWriteBatch();
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void UFirestore::SetWriteCoalescingWindow(const float Seconds)
+{
+	FFirestoreWriteCoalescer::Get().SetWindow(Seconds);
+}
+
+float UFirestore::GetWriteCoalescingWindow()
+{
+	return FFirestoreWriteCoalescer::Get().GetWindow();
+}
+
+void UFirestore::FlushCoalescedWrites(const FFirestoreCallback& Callback)
+{
+	FFirestoreWriteCoalescer::Get().Flush(Callback);
+}
+
 void UFirestore::DisableNetwork(const FFirestoreCallback& Callback)
 {
 #if WITH_FIREBASE_FIRESTORE
@@ -0,0 +1,158 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/FirestoreMultiGet.h"
+#include "Firestore/DocumentReference.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/future.h"
+#	include "firebase/firestore/document_reference.h"
+#	include "firebase/firestore/document_snapshot.h"
+THIRD_PARTY_INCLUDES_END
+
+#	include <string>
+#	include <unordered_map>
+#endif // WITH_FIREBASE_FIRESTORE
+
+#include "Async/Async.h"
+
+#include <atomic>
+#include <vector>
+
+struct FFirestoreMultiGet::FState
+{
+#if WITH_FIREBASE_FIRESTORE
+	/** The documents to read, each path once. */
+	std::vector<firebase::firestore::DocumentReference> Documents;
+#endif // WITH_FIREBASE_FIRESTORE
+
+	/** Index in Documents of each requested document. */
+	TArray<int32> Slots;
+
+	/** Snapshot of each document read, each one written by its read only. */
+	TArray<FFirestoreDocumentSnapshot> Snapshots;
+
+	EFirestoreSource Source = EFirestoreSource::Default;
+
+	FFirestoreDocumentsCallback Callback;
+
+	std::atomic<int32> NextIndex    { 0 };
+	std::atomic<int32> NumRemaining { 0 };
+	std::atomic<int32> FirstError   { 0 };
+};
+
+void FFirestoreMultiGet::Run(const TArray<UFirestoreDocumentReference*>& Documents, const EFirestoreSource Source, FFirestoreDocumentsCallback Callback)
+{
+	const FStateRef State = MakeShared<FState, ESPMode::ThreadSafe>();
+
+	State->Source   = Source;
+	State->Callback = MoveTemp(Callback);
+	State->Slots.Reserve(Documents.Num());
+
+#if WITH_FIREBASE_FIRESTORE
+	std::unordered_map<std::string, int32> Indices;
+
+	for (UFirestoreDocumentReference* const Document : Documents)
+	{
+		if (!Document)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Failed to get documents: invalid document reference."));
+
+			AsyncTask(ENamedThreads::GameThread, [Callback = MoveTemp(State->Callback)]() -> void
+			{
+				Callback.ExecuteIfBound(EFirestoreError::InvalidArgument, {});
+			});
+			return;
+		}
+
+		const firebase::firestore::DocumentReference& Reference = *Document->GetInternal();
+
+		const auto Index = Indices.emplace(Reference.path(), (int32)State->Documents.size());
+
+		if (Index.second)
+		{
+			State->Documents.push_back(Reference);
+		}
+
+		State->Slots.Add(Index.first->second);
+	}
+
+	const int32 NumDocuments = (int32)State->Documents.size();
+
+	State->Snapshots.SetNum(NumDocuments);
+	State->NumRemaining = NumDocuments;
+
+	if (NumDocuments == 0)
+	{
+		Complete(State);
+		return;
+	}
+
+	for (int32 i = 0; i < FMath::Min(NumDocuments, MaxConcurrentReads); ++i)
+	{
+		ReadNext(State);
+	}
+#else
+	AsyncTask(ENamedThreads::GameThread, [Callback = MoveTemp(State->Callback)]() -> void
+	{
+		Callback.ExecuteIfBound(EFirestoreError::Unimplemented, {});
+	});
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreMultiGet::ReadNext(const FStateRef& State)
+{
+#if WITH_FIREBASE_FIRESTORE
+	const int32 Index = State->NextIndex.fetch_add(1);
+
+	if (Index >= (int32)State->Documents.size())
+	{
+		return;
+	}
+
+	State->Documents[Index].Get(static_cast<firebase::firestore::Source>(State->Source)).OnCompletion(
+		[State, Index](const firebase::Future<firebase::firestore::DocumentSnapshot>& Result) -> void
+	{
+		const EFirestoreError Error = (EFirestoreError)Result.error();
+
+		if (Error != EFirestoreError::Ok)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Failed to get document %s. Reason: %s."),
+				UTF8_TO_TCHAR(State->Documents[Index].path().c_str()), UTF8_TO_TCHAR(Result.error_message()));
+
+			int32 NoError = (int32)EFirestoreError::Ok;
+			State->FirstError.compare_exchange_strong(NoError, (int32)Error);
+		}
+		else if (const firebase::firestore::DocumentSnapshot* const Snapshot = Result.result())
+		{
+			State->Snapshots[Index] = FFirestoreDocumentSnapshot(*Snapshot);
+		}
+
+		// The completed read makes room for the next one.
+		ReadNext(State);
+
+		if (State->NumRemaining.fetch_sub(1) == 1)
+		{
+			Complete(State);
+		}
+	});
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreMultiGet::Complete(const FStateRef& State)
+{
+	// Snapshots in the requested order, repeated documents sharing the same read.
+	TArray<FFirestoreDocumentSnapshot> Snapshots;
+
+	Snapshots.Reserve(State->Slots.Num());
+
+	for (const int32 Slot : State->Slots)
+	{
+		Snapshots.Add(State->Snapshots[Slot]);
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [Callback = MoveTemp(State->Callback), Error = (EFirestoreError)State->FirstError.load(), Snapshots = MoveTemp(Snapshots)]() -> void
+	{
+		Callback.ExecuteIfBound(Error, Snapshots);
+	});
+}
@@ -0,0 +1,31 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+
+class UFirestoreDocumentReference;
+
+/**
+ * Reads several documents concurrently for UFirestore::GetAll().
+ *
+ * Documents with the same path are read once. At most MaxConcurrentReads reads are
+ * running at a time, a new one starting each time one completes. Snapshots are converted
+ * on the SDK's threads and delivered together on the game thread.
+ */
+class FFirestoreMultiGet
+{
+public:
+	/** Reads running at the same time for one call. */
+	static constexpr int32 MaxConcurrentReads = 16;
+
+	static void Run(const TArray<UFirestoreDocumentReference*>& Documents, const EFirestoreSource Source, FFirestoreDocumentsCallback Callback);
+
+private:
+	struct FState;
+	using FStateRef = TSharedRef<FState, ESPMode::ThreadSafe>;
+
+	static void ReadNext(const FStateRef& State);
+	static void Complete(const FStateRef& State);
+};
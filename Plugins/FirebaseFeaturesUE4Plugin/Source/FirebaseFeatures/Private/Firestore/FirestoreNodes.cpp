@@ -388,12 +388,13 @@ void UCollectionReferenceAddProxy::OnActionOver(const EFirestoreError Error, UFi
 #undef CHECK_REFERENCE
 #undef BROADCAST_RESULT
 
-UQueryGetProxy* UQueryGetProxy::Get(UFirestoreQuery* Query, const EFirestoreSource Source)
+UQueryGetProxy* UQueryGetProxy::Get(UFirestoreQuery* Query, const EFirestoreSource Source, const bool bUseCache)
 {
 	UQueryGetProxy* const Proxy = NewObject<UQueryGetProxy>();
 
-	Proxy->Query  = Query;
-	Proxy->Source = Source;
+	Proxy->Query	 = Query;
+	Proxy->Source	 = Source;
+	Proxy->bUseCache = bUseCache;
 
 	return Proxy;
 }
@@ -407,7 +408,19 @@ void UQueryGetProxy::Activate()
 		return;
 	}
 
-	Query->Get(Source,FFirestoreQueryCallback::CreateUObject(this, &ThisClass::OnTaskOver));
+	if (bUseCache)
+	{
+		Query->GetCached(Source, FFirestoreCachedQueryCallback::CreateUObject(this, &ThisClass::OnCachedTaskOver));
+	}
+	else
+	{
+		Query->Get(Source,FFirestoreQueryCallback::CreateUObject(this, &ThisClass::OnTaskOver));
+	}
+}
+
+void UQueryGetProxy::OnCachedTaskOver(const EFirestoreError Error, const TArray<FFirestoreDocumentSnapshot>& DocumentSnapshots)
+{
+	OnTaskOver(Error, DocumentSnapshots, {});
 }
 
 void UQueryGetProxy::OnTaskOver(const EFirestoreError Error, TArray<FFirestoreDocumentSnapshot> DocumentSnapshots, TArray<class UFirestoreDocumentChange*> Changes)
@@ -749,17 +749,21 @@ public:
 	 * altered via the Source parameter.
 	 *
 	 * @param Source A value to configure the get behavior (optional).
+	 * @param bUseCache If the results are kept up to date in memory so the next gets of the same
+	 *					query are immediate. No document changes are given. @see UFirestoreQuery::GetCached()
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query", meta = (BlueprintInternalUseOnly = "true"))
-	static UQueryGetProxy* Get(UFirestoreQuery* Query, const EFirestoreSource Source = EFirestoreSource::Default);
+	static UQueryGetProxy* Get(UFirestoreQuery* Query, const EFirestoreSource Source = EFirestoreSource::Default, const bool bUseCache = false);
 
 private:
 	void OnTaskOver(const EFirestoreError Error, TArray<FFirestoreDocumentSnapshot> DocumentSnapshots, TArray<class UFirestoreDocumentChange*> Changes);
+	void OnCachedTaskOver(const EFirestoreError Error, const TArray<FFirestoreDocumentSnapshot>& DocumentSnapshots);
 
 	UPROPERTY()
 	UFirestoreQuery* Query;
 
 	EFirestoreSource Source;
+	bool bUseCache;
 };
 
 
@@ -0,0 +1,96 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/FirestoreReferenceCache.h"
+#include "Firestore/DocumentReference.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/document_reference.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+#if WITH_FIREBASE_FIRESTORE
+namespace
+{
+	UFirestoreDocumentReference* MakeDocument(const firebase::firestore::DocumentReference& Reference)
+	{
+		UFirestoreDocumentReference* const Document = NewObject<UFirestoreDocumentReference>();
+
+		*Document->GetInternal() = Reference;
+
+		return Document;
+	}
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+FFirestoreReferenceCache& FFirestoreReferenceCache::Get()
+{
+	// Never destroyed: references can be requested during exit.
+	static FFirestoreReferenceCache* const Instance = new FFirestoreReferenceCache();
+	return *Instance;
+}
+
+FFirestoreReferenceCache::FFirestoreReferenceCache()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FFirestoreReferenceCache::HandlePostGarbageCollect);
+}
+
+#if WITH_FIREBASE_FIRESTORE
+UFirestoreDocumentReference* FFirestoreReferenceCache::FindOrAdd(const firebase::firestore::DocumentReference& Reference)
+{
+	if (!IsInGameThread() || !Reference.is_valid())
+	{
+		return MakeDocument(Reference);
+	}
+
+	const FString Path = UTF8_TO_TCHAR(Reference.path().c_str());
+
+	TWeakObjectPtr<UFirestoreDocumentReference>& Entry = References.FindOrAdd(Path);
+
+	if (UFirestoreDocumentReference* const Document = Entry.Get())
+	{
+		return Document;
+	}
+
+	UFirestoreDocumentReference* const Document = MakeDocument(Reference);
+
+	Entry = Document;
+
+	return Document;
+}
+
+UFirestoreDocumentReference* FFirestoreReferenceCache::FindOrAdd(const FString& Path, TFunctionRef<firebase::firestore::DocumentReference()> MakeReference)
+{
+	if (!IsInGameThread())
+	{
+		return MakeDocument(MakeReference());
+	}
+
+	if (const TWeakObjectPtr<UFirestoreDocumentReference>* const Entry = References.Find(Path))
+	{
+		if (UFirestoreDocumentReference* const Document = Entry->Get())
+		{
+			return Document;
+		}
+	}
+
+	UFirestoreDocumentReference* const Document = FindOrAdd(MakeReference());
+
+	// Paths given by callers aren't always normalized: they point to the same reference.
+	References.Add(Path, Document);
+
+	return Document;
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+void FFirestoreReferenceCache::HandlePostGarbageCollect()
+{
+	for (auto It = References.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
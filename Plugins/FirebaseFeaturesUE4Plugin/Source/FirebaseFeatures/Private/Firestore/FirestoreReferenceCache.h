@@ -0,0 +1,53 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FirebaseSdk/CaseSensitiveKeyFuncs.h"
+#include "Templates/Function.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+#if WITH_FIREBASE_FIRESTORE
+namespace firebase { namespace firestore { class DocumentReference; } }
+#endif
+
+class UFirestoreDocumentReference;
+
+/**
+ * Interns the document references: while a reference to a path is alive, the same object
+ * is returned for that path instead of creating a new one and copying the native reference.
+ *
+ * References are held weakly and the entries of collected ones are removed after each
+ * garbage collection. References requested from other threads aren't interned.
+ */
+class FFirestoreReferenceCache
+{
+public:
+	static FFirestoreReferenceCache& Get();
+
+#if WITH_FIREBASE_FIRESTORE
+	/** @return The reference to the native reference's document. */
+	UFirestoreDocumentReference* FindOrAdd(const firebase::firestore::DocumentReference& Reference);
+
+	/**
+	 * Finds the reference from the path as given by the caller, without converting it.
+	 *
+	 * @param Path The path of the document.
+	 * @param MakeReference Makes the native reference when no reference to the path is alive.
+	 * @return The reference to the document.
+	 */
+	UFirestoreDocumentReference* FindOrAdd(const FString& Path, TFunctionRef<firebase::firestore::DocumentReference()> MakeReference);
+#endif // WITH_FIREBASE_FIRESTORE
+
+	/** @return The number of paths in the table, including collected references not removed yet. */
+	int32 Num() const { return References.Num(); }
+
+private:
+	FFirestoreReferenceCache();
+
+	void HandlePostGarbageCollect();
+
+private:
+	/** Keyed case-sensitively as Firestore paths are. */
+	TCaseSensitiveMap<TWeakObjectPtr<UFirestoreDocumentReference>> References;
+};
@@ -0,0 +1,270 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/FirestoreSnapshotPoller.h"
+#include "FirebaseSdk/FirebaseConfig.h"
+#include "HAL/PlatformTime.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/future.h"
+THIRD_PARTY_INCLUDES_END
+
+struct FFirestoreSnapshotPoller::FTarget
+{
+	uint64 Id = 0;
+
+	/** The polled query or document. */
+	TUniquePtr<firebase::firestore::Query>             Query;
+	TUniquePtr<firebase::firestore::DocumentReference> Document;
+
+	FQueryListener    OnQuery;
+	FDocumentListener OnDocument;
+
+	/** Results of the last poll that reached the listener. Only used by the running poll. */
+	std::vector<firebase::firestore::DocumentSnapshot> Documents;
+	TUniquePtr<firebase::firestore::DocumentSnapshot>  LastDocument;
+	bool bHasResults = false;
+
+	float Interval = 0.f;
+
+	std::atomic<double> NextPollTime { 0. };
+	std::atomic<bool>   bInFlight    { false };
+	std::atomic<bool>   bRemoved     { false };
+};
+
+namespace
+{
+	// Interval between two checks of the targets to poll.
+	constexpr float TickInterval = 0.1f;
+
+	// Growth of a target's interval after a poll without changes.
+	constexpr float IntervalGrowth = 1.5f;
+
+	/** If polling can go on after the error. */
+	bool IsTransientError(const EFirestoreError Error)
+	{
+		switch (Error)
+		{
+		case EFirestoreError::DeadlineExceeded:
+		case EFirestoreError::ResourceExhausted:
+		case EFirestoreError::Aborted:
+		case EFirestoreError::Unavailable:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	/** Snapshots are equal if they are the same version of the same document. */
+	bool AreEqual(const std::vector<firebase::firestore::DocumentSnapshot>& A, const std::vector<firebase::firestore::DocumentSnapshot>& B)
+	{
+		if (A.size() != B.size())
+		{
+			return false;
+		}
+
+		for (std::size_t i = 0; i < A.size(); ++i)
+		{
+			if (!(A[i] == B[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+FFirestoreSnapshotPoller& FFirestoreSnapshotPoller::Get()
+{
+	// Never destroyed: polls can complete during exit.
+	static FFirestoreSnapshotPoller* const Instance = new FFirestoreSnapshotPoller();
+	return *Instance;
+}
+
+FFirestoreSnapshotPoller::FFirestoreSnapshotPoller()
+	: NextId(0)
+	, MinInterval(FMath::Max(UFirebaseConfig::Get()->SnapshotPollingMinInterval, TickInterval))
+	, MaxInterval(FMath::Max(UFirebaseConfig::Get()->SnapshotPollingMaxInterval, MinInterval))
+	, NumInFlightPolls(0)
+{
+	check(IsInGameThread());
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FFirestoreSnapshotPoller::HandleTick), TickInterval);
+}
+
+uint64 FFirestoreSnapshotPoller::AddQuery(const firebase::firestore::Query& Query, FQueryListener Listener)
+{
+	const FTargetRef Target = MakeShared<FTarget, ESPMode::ThreadSafe>();
+
+	Target->Query   = MakeUnique<firebase::firestore::Query>(Query);
+	Target->OnQuery = MoveTemp(Listener);
+
+	return AddTarget(Target);
+}
+
+uint64 FFirestoreSnapshotPoller::AddDocument(const firebase::firestore::DocumentReference& Document, FDocumentListener Listener)
+{
+	const FTargetRef Target = MakeShared<FTarget, ESPMode::ThreadSafe>();
+
+	Target->Document   = MakeUnique<firebase::firestore::DocumentReference>(Document);
+	Target->OnDocument = MoveTemp(Listener);
+
+	return AddTarget(Target);
+}
+
+void FFirestoreSnapshotPoller::Remove(const uint64 Id)
+{
+	check(IsInGameThread());
+
+	const int32 Index = Targets.IndexOfByPredicate([Id](const FTargetRef& Target) -> bool
+	{
+		return Target->Id == Id;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		// A running poll keeps the target alive and drops its results.
+		Targets[Index]->bRemoved = true;
+		Targets.RemoveAt(Index);
+	}
+}
+
+uint64 FFirestoreSnapshotPoller::AddTarget(const FTargetRef& Target)
+{
+	check(IsInGameThread());
+
+	Target->Id       = ++NextId;
+	Target->Interval = MinInterval;
+
+	Targets.Add(Target);
+
+	// The first poll is made right away to deliver the initial snapshot.
+	if (NumInFlightPolls.load() < MaxInFlightPolls)
+	{
+		Poll(Target);
+	}
+
+	return Target->Id;
+}
+
+bool FFirestoreSnapshotPoller::HandleTick(float DeltaTime)
+{
+	// Targets are removed by a poll when the listener got an error.
+	Targets.RemoveAll([](const FTargetRef& Target) -> bool
+	{
+		return Target->bRemoved.load();
+	});
+
+	const double Now = FPlatformTime::Seconds();
+
+	for (const FTargetRef& Target : Targets)
+	{
+		if (NumInFlightPolls.load() >= MaxInFlightPolls)
+		{
+			break;
+		}
+
+		if (!Target->bInFlight.load(std::memory_order_acquire) && Now >= Target->NextPollTime.load(std::memory_order_relaxed))
+		{
+			Poll(Target);
+		}
+	}
+
+	return true;
+}
+
+void FFirestoreSnapshotPoller::Poll(const FTargetRef& Target)
+{
+	Target->bInFlight.store(true);
+	NumInFlightPolls.fetch_add(1);
+
+	if (Target->Query)
+	{
+		Target->Query->Get().OnCompletion([this, Target](const firebase::Future<firebase::firestore::QuerySnapshot>& Result) -> void
+		{
+			const EFirestoreError Error = (EFirestoreError)Result.error();
+			bool bChanged = false;
+
+			if (Target->bRemoved)
+			{
+				// Removed while the poll was running.
+			}
+			else if (Error != EFirestoreError::Ok)
+			{
+				if (!IsTransientError(Error))
+				{
+					UE_LOG(LogFirestore, Error, TEXT("Failed to poll query: %s"), UTF8_TO_TCHAR(Result.error_message()));
+
+					Target->bRemoved = true;
+					Target->OnQuery(firebase::firestore::QuerySnapshot(), Target->Documents, Error);
+				}
+			}
+			else if (const firebase::firestore::QuerySnapshot* const Snapshot = Result.result())
+			{
+				std::vector<firebase::firestore::DocumentSnapshot> Documents = Snapshot->documents();
+
+				bChanged = !Target->bHasResults || !AreEqual(Documents, Target->Documents);
+
+				if (bChanged)
+				{
+					Target->OnQuery(*Snapshot, Target->Documents, EFirestoreError::Ok);
+
+					Target->Documents   = std::move(Documents);
+					Target->bHasResults = true;
+				}
+			}
+
+			OnPolled(*Target, bChanged);
+		});
+	}
+	else
+	{
+		Target->Document->Get().OnCompletion([this, Target](const firebase::Future<firebase::firestore::DocumentSnapshot>& Result) -> void
+		{
+			const EFirestoreError Error = (EFirestoreError)Result.error();
+			bool bChanged = false;
+
+			if (Target->bRemoved)
+			{
+				// Removed while the poll was running.
+			}
+			else if (Error != EFirestoreError::Ok)
+			{
+				if (!IsTransientError(Error))
+				{
+					UE_LOG(LogFirestore, Error, TEXT("Failed to poll document: %s"), UTF8_TO_TCHAR(Result.error_message()));
+
+					Target->bRemoved = true;
+					Target->OnDocument(firebase::firestore::DocumentSnapshot(), Error);
+				}
+			}
+			else if (const firebase::firestore::DocumentSnapshot* const Snapshot = Result.result())
+			{
+				bChanged = !Target->LastDocument || !(*Snapshot == *Target->LastDocument);
+
+				if (bChanged)
+				{
+					Target->OnDocument(*Snapshot, EFirestoreError::Ok);
+					Target->LastDocument = MakeUnique<firebase::firestore::DocumentSnapshot>(*Snapshot);
+				}
+			}
+
+			OnPolled(*Target, bChanged);
+		});
+	}
+}
+
+void FFirestoreSnapshotPoller::OnPolled(FTarget& Target, const bool bChanged)
+{
+	// Targets that change are polled often, idle ones less and less.
+	Target.Interval = bChanged ? MinInterval : FMath::Min(Target.Interval * IntervalGrowth, MaxInterval);
+
+	Target.NextPollTime.store(FPlatformTime::Seconds() + Target.Interval, std::memory_order_relaxed);
+
+	NumInFlightPolls.fetch_sub(1);
+	Target.bInFlight.store(false, std::memory_order_release);
+}
+#endif // WITH_FIREBASE_FIRESTORE
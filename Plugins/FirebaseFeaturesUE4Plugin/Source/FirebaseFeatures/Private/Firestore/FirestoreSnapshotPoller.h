@@ -0,0 +1,92 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+#include "Containers/Ticker.h"
+
+#include <atomic>
+#include <vector>
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/internal/common.h"
+#	include "firebase/firestore/query.h"
+#	include "firebase/firestore/document_reference.h"
+#	include "firebase/firestore/document_snapshot.h"
+#	include "firebase/firestore/query_snapshot.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+// The SDK's snapshot listeners are used wherever the plugin has enabled them. They never were
+// with the plugin's Linux libraries, where snapshots are polled instead. Projects that validated
+// them there can define WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS=1 in their build rules.
+#if !defined(WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS)
+#	if WITH_FIREBASE_FIRESTORE && !PLATFORM_LINUX && defined(FIREBASE_USE_STD_FUNCTION)
+#		define WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS 1
+#	else
+#		define WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS 0
+#	endif
+#endif
+
+#if WITH_FIREBASE_FIRESTORE
+/**
+ * Emulates snapshot listeners by polling the documents and queries.
+ *
+ * Each listened target is fetched again once its interval elapsed. The results are
+ * compared to the previous ones, documents being equal only if their version didn't
+ * change, and listeners are only called when something changed. A target's interval
+ * is reset to the minimum when it changes and grows up to the maximum while it
+ * doesn't, so idle targets cost few reads.
+ *
+ * Listeners are called on the SDK's thread, like the SDK's listeners. Listeners are
+ * added and removed on the game thread.
+ */
+class FFirestoreSnapshotPoller
+{
+public:
+	/** Called with the new results and the results of the previous call. */
+	using FQueryListener    = TFunction<void(const firebase::firestore::QuerySnapshot& Snapshot,
+		const std::vector<firebase::firestore::DocumentSnapshot>& PreviousDocuments, const EFirestoreError Error)>;
+	using FDocumentListener = TFunction<void(const firebase::firestore::DocumentSnapshot& Snapshot, const EFirestoreError Error)>;
+
+	// Maximum number of gets running at the same time.
+	static constexpr int32 MaxInFlightPolls = 8;
+
+	static FFirestoreSnapshotPoller& Get();
+
+	/** @return An ID to remove the listener. */
+	uint64 AddQuery(const firebase::firestore::Query& Query, FQueryListener Listener);
+	uint64 AddDocument(const firebase::firestore::DocumentReference& Document, FDocumentListener Listener);
+
+	void Remove(const uint64 Id);
+
+private:
+	struct FTarget;
+	using FTargetRef = TSharedRef<FTarget, ESPMode::ThreadSafe>;
+
+	FFirestoreSnapshotPoller();
+
+	uint64 AddTarget(const FTargetRef& Target);
+
+	bool HandleTick(float DeltaTime);
+
+	void Poll(const FTargetRef& Target);
+
+	/** Schedules the next poll of the target. Called on the SDK's thread. */
+	void OnPolled(FTarget& Target, const bool bChanged);
+
+private:
+	TArray<FTargetRef> Targets;
+
+	uint64 NextId;
+
+	float MinInterval;
+	float MaxInterval;
+
+	std::atomic<int32> NumInFlightPolls;
+
+	FDelegateHandle TickerHandle;
+};
+#endif // WITH_FIREBASE_FIRESTORE
@@ -0,0 +1,651 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/FirestoreStructCodec.h"
+
+#if WITH_FIREBASE_FIRESTORE
+
+#include "FirebaseFeatures.h"
+#include "Engine/UserDefinedStruct.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/field_value.h"
+#	include "firebase/firestore/geo_point.h"
+#	include "firebase/firestore/timestamp.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+	using firebase::firestore::FieldValue;
+	using firebase::firestore::MapFieldValue;
+
+	enum class ECodecKind : uint8
+	{
+		Unsupported,
+		Bool,
+		Integer,
+		Floating,
+		Enum,
+		String,
+		Name,
+		Text,
+		Timestamp,
+		GeoPoint,
+		DateTime,
+		Struct,
+		Blob,
+		Array,
+		Map,
+	};
+
+	struct FStructPlan;
+
+	/** Converter of a property, resolved once when the plan is built. */
+	struct FPropertyCodec
+	{
+		ECodecKind Kind = ECodecKind::Unsupported;
+
+		const FProperty*		Property	= nullptr;
+		const FNumericProperty* Numeric		= nullptr;
+		const UEnum*			Enum		= nullptr;
+		const FStructPlan*		StructPlan	= nullptr;
+
+		/** Codec of an array's elements or of a map's values. */
+		TUniquePtr<FPropertyCodec> Inner;
+
+		/** If a map's keys are names instead of strings. */
+		bool bNameKeys = false;
+	};
+
+	struct FStructField
+	{
+		std::string		Key;
+		const FProperty* Property = nullptr;
+		FPropertyCodec	Codec;
+	};
+
+	struct FStructPlan
+	{
+		TArray<FStructField> Fields;
+	};
+
+	// Ticks between 0001-01-01 and the Unix epoch.
+	static const int64 UnixEpochTicks = FDateTime(1970, 1, 1).GetTicks();
+
+	/**
+	 * Plans built from the same properties. Plans reference each other and the properties
+	 * they were built from, so they are dropped together when a struct's layout may have
+	 * changed, once the conversions using them are done.
+	 */
+	struct FStructPlanSet
+	{
+		TMap<FObjectKey, TUniquePtr<FStructPlan>> Plans;
+	};
+
+	using FStructPlanSetRef = TSharedRef<FStructPlanSet, ESPMode::ThreadSafe>;
+
+	class FStructPlanCache
+	{
+	public:
+		static FStructPlanCache& Get()
+		{
+			// Never destroyed as the engine's delegates are bound to it.
+			static FStructPlanCache* const Instance = new FStructPlanCache();
+			return *Instance;
+		}
+
+		/**
+		 * @param OutPlan The plan of the struct.
+		 * @return The set owning the plan, to hold while the plan is used.
+		 */
+		FStructPlanSetRef FindOrBuild(const UStruct* const Struct, const FStructPlan*& OutPlan)
+		{
+			// Recursive on all platforms, so nested structs can be built while holding it.
+			FScopeLock ScopeLock(&Lock);
+
+			OutPlan = &FindOrBuildPlan(Struct);
+
+			return Current;
+		}
+
+	private:
+		FStructPlanCache()
+			: Current(MakeShared<FStructPlanSet, ESPMode::ThreadSafe>())
+		{
+			// Reinstanced and hot reloaded structs get new properties.
+			FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FStructPlanCache::HandleObjectsReplaced);
+#if WITH_EDITOR
+			// A user defined struct keeps its object when it is recompiled, but its properties are
+			// destroyed and recreated. The struct or its editor data is modified before it happens.
+			FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FStructPlanCache::HandleObjectModified);
+#endif
+		}
+
+		void HandleObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects)
+		{
+			Invalidate();
+		}
+
+#if WITH_EDITOR
+		void HandleObjectModified(UObject* const Object)
+		{
+			if (Object->IsA<UUserDefinedStruct>() || Object->GetTypedOuter<UUserDefinedStruct>())
+			{
+				Invalidate();
+			}
+		}
+#endif
+
+		void Invalidate()
+		{
+			FScopeLock ScopeLock(&Lock);
+
+			if (Current->Plans.Num() > 0)
+			{
+				Current = MakeShared<FStructPlanSet, ESPMode::ThreadSafe>();
+			}
+		}
+
+		const FStructPlan& FindOrBuildPlan(const UStruct* const Struct)
+		{
+			if (const TUniquePtr<FStructPlan>* const Existing = Current->Plans.Find(FObjectKey(Struct)))
+			{
+				return **Existing;
+			}
+
+			// Added before being built so structs referencing themselves through containers terminate.
+			FStructPlan& Plan = *Current->Plans.Add(FObjectKey(Struct), MakeUnique<FStructPlan>());
+
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				const FProperty* const Property = *It;
+
+				if (Property->ArrayDim != 1 || Property->HasAnyPropertyFlags(CPF_Transient | CPF_Deprecated))
+				{
+					continue;
+				}
+
+				FStructField Field;
+				Field.Property = Property;
+
+				if (!BuildCodec(Property, Field.Codec))
+				{
+					UE_LOG(LogFirestore, Warning, TEXT("Property %s of %s can't be stored in Firestore and will be skipped."),
+						*Property->GetName(), *Struct->GetName());
+					continue;
+				}
+
+				Field.Key = TCHAR_TO_UTF8(*Struct->GetAuthoredNameForField(Property));
+
+				Plan.Fields.Add(MoveTemp(Field));
+			}
+
+			return Plan;
+		}
+
+	private:
+		bool BuildCodec(const FProperty* const Property, FPropertyCodec& OutCodec)
+		{
+			OutCodec.Property = Property;
+
+			if (Property->IsA<FBoolProperty>())
+			{
+				OutCodec.Kind = ECodecKind::Bool;
+			}
+			else if (const FEnumProperty* const EnumProperty = CastField<FEnumProperty>(Property))
+			{
+				OutCodec.Kind	 = ECodecKind::Enum;
+				OutCodec.Enum	 = EnumProperty->GetEnum();
+				OutCodec.Numeric = EnumProperty->GetUnderlyingProperty();
+			}
+			else if (const FNumericProperty* const NumericProperty = CastField<FNumericProperty>(Property))
+			{
+				OutCodec.Numeric = NumericProperty;
+				OutCodec.Enum	 = NumericProperty->GetIntPropertyEnum();
+				OutCodec.Kind	 = OutCodec.Enum ? ECodecKind::Enum :
+					NumericProperty->IsFloatingPoint() ? ECodecKind::Floating : ECodecKind::Integer;
+			}
+			else if (Property->IsA<FStrProperty>())
+			{
+				OutCodec.Kind = ECodecKind::String;
+			}
+			else if (Property->IsA<FNameProperty>())
+			{
+				OutCodec.Kind = ECodecKind::Name;
+			}
+			else if (Property->IsA<FTextProperty>())
+			{
+				OutCodec.Kind = ECodecKind::Text;
+			}
+			else if (const FStructProperty* const StructProperty = CastField<FStructProperty>(Property))
+			{
+				const UScriptStruct* const Struct = StructProperty->Struct;
+
+				if (Struct == FFirestoreTimestamp::StaticStruct())
+				{
+					OutCodec.Kind = ECodecKind::Timestamp;
+				}
+				else if (Struct == FFirestoreGeoPoint::StaticStruct())
+				{
+					OutCodec.Kind = ECodecKind::GeoPoint;
+				}
+				else if (Struct == TBaseStructure<FDateTime>::Get())
+				{
+					OutCodec.Kind = ECodecKind::DateTime;
+				}
+				else
+				{
+					OutCodec.Kind		= ECodecKind::Struct;
+					OutCodec.StructPlan = &FindOrBuildPlan(Struct);
+				}
+			}
+			else if (const FArrayProperty* const ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				const FByteProperty* const ByteProperty = CastField<FByteProperty>(ArrayProperty->Inner);
+
+				if (ByteProperty && !ByteProperty->Enum)
+				{
+					OutCodec.Kind = ECodecKind::Blob;
+				}
+				else
+				{
+					OutCodec.Kind  = ECodecKind::Array;
+					OutCodec.Inner = MakeUnique<FPropertyCodec>();
+					return BuildCodec(ArrayProperty->Inner, *OutCodec.Inner);
+				}
+			}
+			else if (const FMapProperty* const MapProperty = CastField<FMapProperty>(Property))
+			{
+				if (!MapProperty->KeyProp->IsA<FStrProperty>() && !MapProperty->KeyProp->IsA<FNameProperty>())
+				{
+					return false;
+				}
+
+				OutCodec.Kind	   = ECodecKind::Map;
+				OutCodec.bNameKeys = MapProperty->KeyProp->IsA<FNameProperty>();
+				OutCodec.Inner	   = MakeUnique<FPropertyCodec>();
+				return BuildCodec(MapProperty->ValueProp, *OutCodec.Inner);
+			}
+
+			return OutCodec.Kind != ECodecKind::Unsupported;
+		}
+
+	private:
+		FCriticalSection Lock;
+		FStructPlanSetRef Current;
+	};
+
+	void WriteStruct(const FStructPlan& Plan, const void* StructData, MapFieldValue& OutData);
+	bool ReadStruct (const FStructPlan& Plan, void* StructData, const MapFieldValue& Data);
+
+	FieldValue WriteValue(const FPropertyCodec& Codec, const void* const ValuePtr)
+	{
+		switch (Codec.Kind)
+		{
+		case ECodecKind::Bool:
+			return FieldValue::Boolean(static_cast<const FBoolProperty*>(Codec.Property)->GetPropertyValue(ValuePtr));
+
+		case ECodecKind::Integer:
+			return FieldValue::Integer(Codec.Numeric->GetSignedIntPropertyValue(ValuePtr));
+
+		case ECodecKind::Floating:
+			return FieldValue::Double(Codec.Numeric->GetFloatingPointPropertyValue(ValuePtr));
+
+		case ECodecKind::Enum:
+		{
+			const int64	 Value = Codec.Numeric->GetSignedIntPropertyValue(ValuePtr);
+			const FString Name  = Codec.Enum->GetNameStringByValue(Value);
+			return Name.IsEmpty() ? FieldValue::Integer(Value) : FieldValue::String(TCHAR_TO_UTF8(*Name));
+		}
+
+		case ECodecKind::String:
+			return FieldValue::String(TCHAR_TO_UTF8(**static_cast<const FString*>(ValuePtr)));
+
+		case ECodecKind::Name:
+			return FieldValue::String(TCHAR_TO_UTF8(*static_cast<const FName*>(ValuePtr)->ToString()));
+
+		case ECodecKind::Text:
+			return FieldValue::String(TCHAR_TO_UTF8(*static_cast<const FText*>(ValuePtr)->ToString()));
+
+		case ECodecKind::Timestamp:
+		{
+			const FFirestoreTimestamp& Timestamp = *static_cast<const FFirestoreTimestamp*>(ValuePtr);
+			return FieldValue::Timestamp(firebase::Timestamp(Timestamp.Seconds, Timestamp.Nanoseconds));
+		}
+
+		case ECodecKind::GeoPoint:
+		{
+			const FFirestoreGeoPoint& GeoPoint = *static_cast<const FFirestoreGeoPoint*>(ValuePtr);
+			return FieldValue::GeoPoint(firebase::firestore::GeoPoint(GeoPoint.Latitude, GeoPoint.Longitude));
+		}
+
+		case ECodecKind::DateTime:
+		{
+			const int64 Ticks = static_cast<const FDateTime*>(ValuePtr)->GetTicks() - UnixEpochTicks;
+			int64 Seconds	  = Ticks / ETimespan::TicksPerSecond;
+			int64 Remainder	  = Ticks % ETimespan::TicksPerSecond;
+			if (Remainder < 0)
+			{
+				Seconds	  -= 1;
+				Remainder += ETimespan::TicksPerSecond;
+			}
+			return FieldValue::Timestamp(firebase::Timestamp(Seconds, (int32)(Remainder * ETimespan::NanosecondsPerTick)));
+		}
+
+		case ECodecKind::Struct:
+		{
+			MapFieldValue Fields;
+			WriteStruct(*Codec.StructPlan, ValuePtr, Fields);
+			return FieldValue::Map(MoveTemp(Fields));
+		}
+
+		case ECodecKind::Blob:
+		{
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Codec.Property), ValuePtr);
+			return FieldValue::Blob(Helper.Num() > 0 ? Helper.GetRawPtr(0) : nullptr, Helper.Num());
+		}
+
+		case ECodecKind::Array:
+		{
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Codec.Property), ValuePtr);
+
+			std::vector<FieldValue> Values;
+			Values.reserve(Helper.Num());
+
+			for (int32 Index = 0; Index < Helper.Num(); ++Index)
+			{
+				Values.push_back(WriteValue(*Codec.Inner, Helper.GetRawPtr(Index)));
+			}
+
+			return FieldValue::Array(MoveTemp(Values));
+		}
+
+		case ECodecKind::Map:
+		{
+			FScriptMapHelper Helper(static_cast<const FMapProperty*>(Codec.Property), ValuePtr);
+
+			MapFieldValue Values;
+			Values.reserve(Helper.Num());
+
+			for (int32 Index = 0; Index < Helper.GetMaxIndex(); ++Index)
+			{
+				if (!Helper.IsValidIndex(Index))
+				{
+					continue;
+				}
+
+				const void* const KeyPtr = Helper.GetKeyPtr(Index);
+				const FString Key = Codec.bNameKeys ? static_cast<const FName*>(KeyPtr)->ToString() : *static_cast<const FString*>(KeyPtr);
+
+				Values.emplace(TCHAR_TO_UTF8(*Key), WriteValue(*Codec.Inner, Helper.GetValuePtr(Index)));
+			}
+
+			return FieldValue::Map(MoveTemp(Values));
+		}
+
+		default:
+			return FieldValue::Null();
+		}
+	}
+
+	FString ToFString(const FieldValue& Value)
+	{
+		const std::string String = Value.string_value();
+		const FUTF8ToTCHAR Converted(String.c_str(), String.size());
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	bool ReadValue(const FPropertyCodec& Codec, void* const ValuePtr, const FieldValue& Value)
+	{
+		switch (Codec.Kind)
+		{
+		case ECodecKind::Bool:
+			if (!Value.is_boolean())
+			{
+				return false;
+			}
+			static_cast<const FBoolProperty*>(Codec.Property)->SetPropertyValue(ValuePtr, Value.boolean_value());
+			return true;
+
+		case ECodecKind::Integer:
+			// Other clients may store whole numbers as doubles.
+			if (Value.is_integer())
+			{
+				Codec.Numeric->SetIntPropertyValue(ValuePtr, (int64)Value.integer_value());
+				return true;
+			}
+			if (Value.is_double())
+			{
+				Codec.Numeric->SetIntPropertyValue(ValuePtr, (int64)Value.double_value());
+				return true;
+			}
+			return false;
+
+		case ECodecKind::Floating:
+			if (Value.is_double())
+			{
+				Codec.Numeric->SetFloatingPointPropertyValue(ValuePtr, Value.double_value());
+				return true;
+			}
+			if (Value.is_integer())
+			{
+				Codec.Numeric->SetFloatingPointPropertyValue(ValuePtr, (double)Value.integer_value());
+				return true;
+			}
+			return false;
+
+		case ECodecKind::Enum:
+			if (Value.is_string())
+			{
+				const int64 EnumValue = Codec.Enum->GetValueByNameString(ToFString(Value));
+				if (EnumValue == INDEX_NONE)
+				{
+					return false;
+				}
+				Codec.Numeric->SetIntPropertyValue(ValuePtr, EnumValue);
+				return true;
+			}
+			if (Value.is_integer())
+			{
+				Codec.Numeric->SetIntPropertyValue(ValuePtr, (int64)Value.integer_value());
+				return true;
+			}
+			return false;
+
+		case ECodecKind::String:
+			if (!Value.is_string())
+			{
+				return false;
+			}
+			*static_cast<FString*>(ValuePtr) = ToFString(Value);
+			return true;
+
+		case ECodecKind::Name:
+			if (!Value.is_string())
+			{
+				return false;
+			}
+			*static_cast<FName*>(ValuePtr) = FName(*ToFString(Value));
+			return true;
+
+		case ECodecKind::Text:
+			if (!Value.is_string())
+			{
+				return false;
+			}
+			*static_cast<FText*>(ValuePtr) = FText::FromString(ToFString(Value));
+			return true;
+
+		case ECodecKind::Timestamp:
+		{
+			if (!Value.is_timestamp())
+			{
+				return false;
+			}
+			const firebase::Timestamp Time = Value.timestamp_value();
+			*static_cast<FFirestoreTimestamp*>(ValuePtr) = FFirestoreTimestamp(Time.seconds(), Time.nanoseconds());
+			return true;
+		}
+
+		case ECodecKind::GeoPoint:
+		{
+			if (!Value.is_geo_point())
+			{
+				return false;
+			}
+			const firebase::firestore::GeoPoint Point = Value.geo_point_value();
+			*static_cast<FFirestoreGeoPoint*>(ValuePtr) = FFirestoreGeoPoint((float)Point.latitude(), (float)Point.longitude());
+			return true;
+		}
+
+		case ECodecKind::DateTime:
+		{
+			if (!Value.is_timestamp())
+			{
+				return false;
+			}
+			const firebase::Timestamp Time = Value.timestamp_value();
+			*static_cast<FDateTime*>(ValuePtr) = FDateTime(UnixEpochTicks
+				+ Time.seconds() * ETimespan::TicksPerSecond + Time.nanoseconds() / ETimespan::NanosecondsPerTick);
+			return true;
+		}
+
+		case ECodecKind::Struct:
+			return Value.is_map() && ReadStruct(*Codec.StructPlan, ValuePtr, Value.map_value());
+
+		case ECodecKind::Blob:
+		{
+			if (!Value.is_blob())
+			{
+				return false;
+			}
+
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Codec.Property), ValuePtr);
+			Helper.Resize((int32)Value.blob_size());
+
+			if (Helper.Num() > 0)
+			{
+				FMemory::Memcpy(Helper.GetRawPtr(0), Value.blob_value(), Helper.Num());
+			}
+			return true;
+		}
+
+		case ECodecKind::Array:
+		{
+			if (!Value.is_array())
+			{
+				return false;
+			}
+
+			const std::vector<FieldValue> Values = Value.array_value();
+
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Codec.Property), ValuePtr);
+			Helper.EmptyAndAddValues((int32)Values.size());
+
+			bool bSuccess = true;
+			for (int32 Index = 0; Index < Helper.Num(); ++Index)
+			{
+				bSuccess &= ReadValue(*Codec.Inner, Helper.GetRawPtr(Index), Values[Index]);
+			}
+			return bSuccess;
+		}
+
+		case ECodecKind::Map:
+		{
+			if (!Value.is_map())
+			{
+				return false;
+			}
+
+			const MapFieldValue Values = Value.map_value();
+
+			FScriptMapHelper Helper(static_cast<const FMapProperty*>(Codec.Property), ValuePtr);
+			Helper.EmptyValues((int32)Values.size());
+
+			bool bSuccess = true;
+			for (const auto& Field : Values)
+			{
+				const int32 Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				void* const KeyPtr = Helper.GetKeyPtr(Index);
+
+				const FString Key = UTF8_TO_TCHAR(Field.first.c_str());
+				if (Codec.bNameKeys)
+				{
+					*static_cast<FName*>(KeyPtr) = FName(*Key);
+				}
+				else
+				{
+					*static_cast<FString*>(KeyPtr) = Key;
+				}
+
+				bSuccess &= ReadValue(*Codec.Inner, Helper.GetValuePtr(Index), Field.second);
+			}
+			Helper.Rehash();
+			return bSuccess;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	void WriteStruct(const FStructPlan& Plan, const void* const StructData, MapFieldValue& OutData)
+	{
+		OutData.reserve(OutData.size() + Plan.Fields.Num());
+
+		for (const FStructField& Field : Plan.Fields)
+		{
+			OutData.emplace(Field.Key, WriteValue(Field.Codec, Field.Property->ContainerPtrToValuePtr<void>(StructData)));
+		}
+	}
+
+	bool ReadStruct(const FStructPlan& Plan, void* const StructData, const MapFieldValue& Data)
+	{
+		bool bSuccess = true;
+
+		for (const FStructField& Field : Plan.Fields)
+		{
+			const auto Found = Data.find(Field.Key);
+
+			if (Found == Data.end() || Found->second.is_null())
+			{
+				continue;
+			}
+
+			if (!ReadValue(Field.Codec, Field.Property->ContainerPtrToValuePtr<void>(StructData), Found->second))
+			{
+				UE_LOG(LogFirestore, Warning, TEXT("Field %s has a type that can't be read into property %s."),
+					UTF8_TO_TCHAR(Field.Key.c_str()), *Field.Property->GetName());
+				bSuccess = false;
+			}
+		}
+
+		return bSuccess;
+	}
+}
+
+void FirestoreStructCodec::Write(const UStruct* const Struct, const void* const StructData, MapFieldValue& OutData)
+{
+	check(Struct && StructData);
+
+	const FStructPlan* Plan = nullptr;
+	const FStructPlanSetRef Plans = FStructPlanCache::Get().FindOrBuild(Struct, Plan);
+
+	WriteStruct(*Plan, StructData, OutData);
+}
+
+bool FirestoreStructCodec::Read(const UStruct* const Struct, void* const StructData, const MapFieldValue& Data)
+{
+	check(Struct && StructData);
+
+	const FStructPlan* Plan = nullptr;
+	const FStructPlanSetRef Plans = FStructPlanCache::Get().FindOrBuild(Struct, Plan);
+
+	return ReadStruct(*Plan, StructData, Data);
+}
+
+#endif // WITH_FIREBASE_FIRESTORE
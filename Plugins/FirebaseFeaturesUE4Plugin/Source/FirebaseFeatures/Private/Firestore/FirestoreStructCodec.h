@@ -0,0 +1,40 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/FieldValue.h"
+
+#if WITH_FIREBASE_FIRESTORE
+
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/map_field_value.h"
+THIRD_PARTY_INCLUDES_END
+
+/**
+ * Converts structs to Firestore documents and back using reflection.
+ *
+ * The properties of each struct are walked once and the resulting field plan
+ * (UTF-8 field name and converter of each property) is cached for the
+ * lifetime of the struct.
+ *
+ * Supported properties: booleans, numbers, enums (stored by name), strings,
+ * names, texts, FDateTime and FFirestoreTimestamp (stored as timestamps),
+ * FFirestoreGeoPoint, nested structs (stored as maps), byte arrays (stored as
+ * blobs), arrays and maps keyed by strings or names. Other properties, static
+ * arrays and transient properties are skipped.
+ */
+namespace FirestoreStructCodec
+{
+	/** Writes the struct's properties as fields of OutData. */
+	void Write(const UStruct* Struct, const void* StructData, firebase::firestore::MapFieldValue& OutData);
+
+	/**
+	 * Reads the fields into the struct's properties. Properties without a
+	 * matching field are left untouched.
+	 * @return False if a field's type couldn't be converted to its property.
+	 */
+	bool Read(const UStruct* Struct, void* StructData, const firebase::firestore::MapFieldValue& Data);
+}
+
+#endif // WITH_FIREBASE_FIRESTORE
@@ -0,0 +1,449 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/FirestoreWriteCoalescer.h"
+#include "Firestore/DocumentReference.h"
+#include "FirebaseSdk/FirebaseConfig.h"
+#include "Containers/Ticker.h"
+#include "Misc/CoreDelegates.h"
+
+namespace
+{
+	// Sentinels (Delete, ServerTimestamp, ArrayUnion, Increment, ...) come after Map in the native type.
+	bool IsSentinel(const FFirestoreFieldValue& Value)
+	{
+		return Value.GetType() > EFirestoreFieldValueType::Map;
+	}
+
+	bool IsMap(const FFirestoreFieldValue& Value)
+	{
+		return Value.GetType() == EFirestoreFieldValueType::Map;
+	}
+
+	// If one of the field paths is nested in the other, e.g. "stats" and "stats.kills".
+	bool IsNestedPath(const FString& A, const FString& B)
+	{
+		const FString& Shorter = A.Len() < B.Len() ? A : B;
+		const FString& Longer  = A.Len() < B.Len() ? B : A;
+
+		return Longer.Len() > Shorter.Len() && Longer[Shorter.Len()] == TEXT('.') && Longer.StartsWith(Shorter, ESearchCase::CaseSensitive);
+	}
+
+	// If the map has the key with another case, which its case-insensitive lookup would match.
+	bool HasKeyInOtherCase(const TMap<FString, FFirestoreFieldValue>& Fields, const FString& Key)
+	{
+		for (const TPair<FString, FFirestoreFieldValue>& Field : Fields)
+		{
+			if (Field.Key.Equals(Key, ESearchCase::IgnoreCase) && !Field.Key.Equals(Key, ESearchCase::CaseSensitive))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// If the batch was rejected because of one of its writes, without being applied, so the
+	// writes of the other documents can be committed again on their own.
+	bool IsRejectedWrite(const EFirestoreError Error)
+	{
+		switch (Error)
+		{
+		case EFirestoreError::InvalidArgument:
+		case EFirestoreError::NotFound:
+		case EFirestoreError::AlreadyExists:
+		case EFirestoreError::PermissionDenied:
+		case EFirestoreError::FailedPrecondition:
+		case EFirestoreError::OutOfRange:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+}
+
+FFirestoreWriteCoalescer& FFirestoreWriteCoalescer::Get()
+{
+	// Never destroyed: the queued document references can't outlive the UObject system.
+	static FFirestoreWriteCoalescer* const Instance = new FFirestoreWriteCoalescer();
+	return *Instance;
+}
+
+FFirestoreWriteCoalescer::FFirestoreWriteCoalescer()
+	: Window(FMath::Max(UFirebaseConfig::Get()->WriteCoalescingWindow, 0.f))
+	, NumPendingWrites(0)
+{
+	FCoreDelegates::OnPreExit.AddRaw(this, &FFirestoreWriteCoalescer::HandlePreExit);
+}
+
+bool FFirestoreWriteCoalescer::IsEnabled() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	// The window is only read and written on the game thread.
+	return IsInGameThread() && Window > 0.f;
+#else
+	return false;
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreWriteCoalescer::SetWindow(const float Seconds)
+{
+	check(IsInGameThread());
+
+	Window = FMath::Max(Seconds, 0.f);
+
+	if (Window == 0.f)
+	{
+		Flush();
+	}
+}
+
+float FFirestoreWriteCoalescer::GetWindow() const
+{
+	check(IsInGameThread());
+
+	return Window;
+}
+
+void FFirestoreWriteCoalescer::Set(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+	const FFirestoreSetOptions& Options, FFirestoreCallback Callback)
+{
+	FPendingDocument& Pending = FindOrAddDocument(Document, MoveTemp(Callback));
+	const int32 NumWrites = Pending.Writes.Num();
+
+	switch (Options.GetType())
+	{
+	case EFirestoreSetOptionsType::Overwrite:
+		// The document is replaced: the writes queued before don't matter anymore.
+		Pending.Writes.Reset();
+		Pending.Writes.Add({ EWriteType::Set, Data });
+		break;
+
+	case EFirestoreSetOptionsType::MergeAll:
+		if (Pending.Writes.Num() == 0 || !TryMerge(Pending.Writes.Last(), EWriteType::SetMerge, Data))
+		{
+			Pending.Writes.Add({ EWriteType::SetMerge, Data });
+		}
+		break;
+
+	case EFirestoreSetOptionsType::MergeSpecific:
+		Pending.Writes.Add({ EWriteType::SetMergeSpecific, Data, {}, Options });
+		break;
+	}
+
+	OnWriteQueued(Pending.Writes.Num() - NumWrites);
+}
+
+void FFirestoreWriteCoalescer::Update(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+	FFirestoreCallback Callback)
+{
+	FPendingDocument& Pending = FindOrAddDocument(Document, MoveTemp(Callback));
+	const int32 NumWrites = Pending.Writes.Num();
+
+	if (NumWrites == 0 || !TryMerge(Pending.Writes.Last(), EWriteType::Update, Data))
+	{
+		Pending.Writes.Add({ EWriteType::Update, Data });
+	}
+
+	OnWriteQueued(Pending.Writes.Num() - NumWrites);
+}
+
+void FFirestoreWriteCoalescer::Update(UFirestoreDocumentReference* const Document, const TMap<FFirestoreFieldPath, FFirestoreFieldValue>& Data,
+	FFirestoreCallback Callback)
+{
+	FPendingDocument& Pending = FindOrAddDocument(Document, MoveTemp(Callback));
+
+	Pending.Writes.Add({ EWriteType::UpdatePaths, {}, Data });
+
+	OnWriteQueued(1);
+}
+
+void FFirestoreWriteCoalescer::Delete(UFirestoreDocumentReference* const Document, FFirestoreCallback Callback)
+{
+	FPendingDocument& Pending = FindOrAddDocument(Document, MoveTemp(Callback));
+	const int32 NumWrites = Pending.Writes.Num();
+
+	Pending.Writes.Reset();
+	Pending.Writes.Add({ EWriteType::Delete });
+
+	OnWriteQueued(Pending.Writes.Num() - NumWrites);
+}
+
+FFirestoreWriteCoalescer::FPendingDocument& FFirestoreWriteCoalescer::FindOrAddDocument(UFirestoreDocumentReference* const Document,
+	FFirestoreCallback&& Callback)
+{
+	check(IsInGameThread());
+
+	const FString Path = Document->GetPath();
+
+	FPendingDocument* Pending = PendingDocuments.Find(Path);
+
+	if (!Pending)
+	{
+		Pending = &PendingDocuments.Add(Path);
+		Pending->Document.Reset(Document);
+	}
+
+	if (Callback.IsBound())
+	{
+		Pending->Callbacks.Add(MoveTemp(Callback));
+	}
+
+	return *Pending;
+}
+
+bool FFirestoreWriteCoalescer::TryMerge(FWrite& Into, const EWriteType Type, const TMap<FString, FFirestoreFieldValue>& Fields)
+{
+	const bool bIntoSet = Into.Type == EWriteType::Set || Into.Type == EWriteType::SetMerge;
+
+	// An update fails if the document doesn't exist, so it can't be merged into a write that creates it
+	// unless this write is a set, and a merge can't be merged into an update for the same reason.
+	const bool bCanMerge =
+		(Type == EWriteType::Update	  && (Into.Type == EWriteType::Update || bIntoSet)) ||
+		(Type == EWriteType::SetMerge && bIntoSet);
+
+	if (!bCanMerge)
+	{
+		return false;
+	}
+
+	for (const TPair<FString, FFirestoreFieldValue>& Field : Fields)
+	{
+		const bool bSentinel = IsSentinel(Field.Value);
+
+		// Update keys are field paths while set keys are field names.
+		if (Type == EWriteType::Update && bIntoSet && Field.Key.Contains(TEXT(".")))
+		{
+			return false;
+		}
+
+		// Sentinels apply to the stored value, not to the value of the set.
+		if (Into.Type == EWriteType::Set && bSentinel)
+		{
+			return false;
+		}
+
+		// An update replaces maps while a merge merges them.
+		if (Type == EWriteType::Update && Into.Type == EWriteType::SetMerge && IsMap(Field.Value))
+		{
+			return false;
+		}
+
+		if (Into.Type == EWriteType::Update)
+		{
+			for (const TPair<FString, FFirestoreFieldValue>& Existing : Into.Fields)
+			{
+				if (IsNestedPath(Existing.Key, Field.Key))
+				{
+					return false;
+				}
+			}
+		}
+
+		// Field names are case-sensitive but the write's map isn't: "Score" and "score"
+		// can't be in the same write without one replacing the other.
+		if (HasKeyInOtherCase(Into.Fields, Field.Key))
+		{
+			return false;
+		}
+
+		if (const FFirestoreFieldValue* const Existing = Into.Fields.Find(Field.Key))
+		{
+			if (bSentinel || IsSentinel(*Existing))
+			{
+				return false;
+			}
+
+			if (Type == EWriteType::SetMerge && IsMap(*Existing) && IsMap(Field.Value))
+			{
+				return false;
+			}
+		}
+	}
+
+	for (const TPair<FString, FFirestoreFieldValue>& Field : Fields)
+	{
+		Into.Fields.Add(Field.Key, Field.Value);
+	}
+
+	return true;
+}
+
+void FFirestoreWriteCoalescer::OnWriteQueued(const int32 NumAddedWrites)
+{
+	NumPendingWrites += NumAddedWrites;
+
+	if (NumPendingWrites >= MaxBatchSize)
+	{
+		Flush();
+	}
+	else if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FFirestoreWriteCoalescer::HandleWindowElapsed), Window);
+	}
+}
+
+bool FFirestoreWriteCoalescer::HandleWindowElapsed(float DeltaTime)
+{
+	TickerHandle.Reset();
+
+	Flush();
+
+	return false;
+}
+
+void FFirestoreWriteCoalescer::HandlePreExit()
+{
+	Flush();
+}
+
+void FFirestoreWriteCoalescer::Flush(FFirestoreCallback Callback)
+{
+	check(IsInGameThread());
+
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	if (PendingDocuments.Num() == 0)
+	{
+		Callback.ExecuteIfBound(EFirestoreError::Ok);
+		return;
+	}
+
+	TCaseSensitiveMap<FPendingDocument> Documents = MoveTemp(PendingDocuments);
+	PendingDocuments.Reset();
+	NumPendingWrites = 0;
+
+	const TSharedRef<FFlushState> State = MakeShared<FFlushState>();
+	State->Callback = MoveTemp(Callback);
+
+	FWriteBatch Batch = UFirestore::Batch();
+	int32 BatchSize = 0;
+	TArray<FPendingDocument> BatchDocuments;
+
+	const auto CommitBatch = [&]() -> void
+	{
+		if (BatchSize == 0)
+		{
+			return;
+		}
+
+		++State->NumBatches;
+
+		// Shared so the document references are released on the game thread, once used,
+		// and not with the SDK's copies of the callback.
+		const TSharedRef<TArray<FPendingDocument>, ESPMode::ThreadSafe> Parts =
+			MakeShared<TArray<FPendingDocument>, ESPMode::ThreadSafe>(MoveTemp(BatchDocuments));
+
+		Batch.Commit(FFirestoreCallback::CreateLambda([State, Parts](const EFirestoreError Error) -> void
+		{
+			// The writes of unrelated callers share the batch: one of them being rejected
+			// must not fail the others, which are committed again one document at a time.
+			if (IsRejectedWrite(Error) && Parts->Num() > 1)
+			{
+				UE_LOG(LogFirestore, Warning, TEXT("Coalesced write batch rejected (code: %d). Committing its %d documents separately."),
+					Error, Parts->Num());
+
+				for (const FPendingDocument& Pending : *Parts)
+				{
+					CommitDocument(Pending, State);
+				}
+			}
+			else
+			{
+				for (const FPendingDocument& Pending : *Parts)
+				{
+					for (const FFirestoreCallback& WriteCallback : Pending.Callbacks)
+					{
+						WriteCallback.ExecuteIfBound(Error);
+					}
+				}
+
+				State->AddResult(Error);
+			}
+
+			Parts->Empty();
+
+			State->CompleteBatch();
+		}));
+
+		Batch = UFirestore::Batch();
+		BatchSize = 0;
+		BatchDocuments.Reset();
+	};
+
+	for (TPair<FString, FPendingDocument>& Entry : Documents)
+	{
+		FPendingDocument& Pending = Entry.Value;
+
+		// Keeps the writes of a document in one batch when they fit.
+		if (BatchSize + Pending.Writes.Num() > MaxBatchSize)
+		{
+			CommitBatch();
+		}
+
+		// The part of the document's writes in the current batch, to commit them again alone.
+		FPendingDocument* Part = &BatchDocuments.Add_GetRef({ Pending.Document });
+
+		for (const FWrite& Write : Pending.Writes)
+		{
+			if (BatchSize == MaxBatchSize)
+			{
+				CommitBatch();
+				Part = &BatchDocuments.Add_GetRef({ Pending.Document });
+			}
+
+			AddWrite(Batch, Pending.Document.Get(), Write);
+			Part->Writes.Add(Write);
+
+			++BatchSize;
+		}
+
+		Part->Callbacks = MoveTemp(Pending.Callbacks);
+	}
+
+	CommitBatch();
+
+	UE_LOG(LogFirestore, Verbose, TEXT("Committed coalesced writes of %d document(s) in %d batch(es)."),
+		Documents.Num(), State->NumBatches);
+}
+
+void FFirestoreWriteCoalescer::CommitDocument(const FPendingDocument& Pending, const TSharedRef<FFlushState>& State)
+{
+	FWriteBatch Batch = UFirestore::Batch();
+
+	for (const FWrite& Write : Pending.Writes)
+	{
+		AddWrite(Batch, Pending.Document.Get(), Write);
+	}
+
+	++State->NumBatches;
+
+	Batch.Commit(FFirestoreCallback::CreateLambda([State, Callbacks = Pending.Callbacks](const EFirestoreError Error) -> void
+	{
+		for (const FFirestoreCallback& WriteCallback : Callbacks)
+		{
+			WriteCallback.ExecuteIfBound(Error);
+		}
+
+		State->AddResult(Error);
+		State->CompleteBatch();
+	}));
+}
+
+void FFirestoreWriteCoalescer::AddWrite(FWriteBatch& Batch, UFirestoreDocumentReference* const Document, const FWrite& Write)
+{
+	switch (Write.Type)
+	{
+	case EWriteType::Set:				Batch.Set(Document, Write.Fields);								break;
+	case EWriteType::SetMerge:			Batch.Set(Document, Write.Fields, FFirestoreSetOptions::Merge()); break;
+	case EWriteType::SetMergeSpecific:	Batch.Set(Document, Write.Fields, Write.Options);				break;
+	case EWriteType::Update:			Batch.Update(Document, Write.Fields);							break;
+	case EWriteType::UpdatePaths:		Batch.Update(Document, Write.PathFields);						break;
+	case EWriteType::Delete:			Batch.Delete(Document);											break;
+	}
+}
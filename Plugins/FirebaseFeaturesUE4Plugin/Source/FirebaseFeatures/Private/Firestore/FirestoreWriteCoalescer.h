@@ -0,0 +1,127 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/FieldValue.h"
+#include "Firestore/FieldPath.h"
+#include "FirebaseSdk/CaseSensitiveKeyFuncs.h"
+#include "UObject/StrongObjectPtr.h"
+
+class UFirestoreDocumentReference;
+
+/**
+ * Queues the document writes made from the game thread during a time window, merges the
+ * writes to the same document when it doesn't change the result and commits them in
+ * write batches.
+ *
+ * Writes to a document are kept in order. Two writes are merged only if applying the
+ * merged one gives the same document, otherwise both are committed in the same batch.
+ *
+ * A batch is atomic: when it is rejected because of one of its writes, the documents it
+ * contained are committed again one batch each so unrelated writes still succeed.
+ *
+ * Game thread only.
+ */
+class FFirestoreWriteCoalescer
+{
+public:
+	// Maximum number of writes Firestore accepts in a single batch.
+	static constexpr int32 MaxBatchSize = 500;
+
+	static FFirestoreWriteCoalescer& Get();
+
+	/** @return If the writes made from the calling thread should go through the coalescer. */
+	bool IsEnabled() const;
+
+	void  SetWindow(const float Seconds);
+	float GetWindow() const;
+
+	void Set   (UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+		const FFirestoreSetOptions& Options, FFirestoreCallback Callback);
+	void Update(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+		FFirestoreCallback Callback);
+	void Update(UFirestoreDocumentReference* const Document, const TMap<FFirestoreFieldPath, FFirestoreFieldValue>& Data,
+		FFirestoreCallback Callback);
+	void Delete(UFirestoreDocumentReference* const Document, FFirestoreCallback Callback);
+
+	/** Commits the queued writes. Callback is called once they are all committed. */
+	void Flush(FFirestoreCallback Callback = FFirestoreCallback());
+
+private:
+	FFirestoreWriteCoalescer();
+
+	enum class EWriteType : uint8
+	{
+		Set,
+		SetMerge,
+		SetMergeSpecific,
+		Update,
+		UpdatePaths,
+		Delete,
+	};
+
+	struct FWrite
+	{
+		EWriteType Type;
+		TMap<FString, FFirestoreFieldValue> Fields;
+		TMap<FFirestoreFieldPath, FFirestoreFieldValue> PathFields;
+		FFirestoreSetOptions Options;
+	};
+
+	struct FPendingDocument
+	{
+		TStrongObjectPtr<UFirestoreDocumentReference> Document;
+		TArray<FWrite> Writes;
+		TArray<FFirestoreCallback> Callbacks;
+	};
+
+	/** Batch callbacks are called on the game thread, after all the batches are committed here. */
+	struct FFlushState
+	{
+		int32 NumBatches = 0;
+		EFirestoreError FirstError = EFirestoreError::Ok;
+		FFirestoreCallback Callback;
+
+		void AddResult(const EFirestoreError Error)
+		{
+			if (FirstError == EFirestoreError::Ok)
+			{
+				FirstError = Error;
+			}
+		}
+
+		void CompleteBatch()
+		{
+			if (--NumBatches == 0)
+			{
+				Callback.ExecuteIfBound(FirstError);
+			}
+		}
+	};
+
+	FPendingDocument& FindOrAddDocument(UFirestoreDocumentReference* const Document, FFirestoreCallback&& Callback);
+
+	/** Adds the fields to the last queued write if the result is the same as applying both writes. */
+	static bool TryMerge(FWrite& Into, const EWriteType Type, const TMap<FString, FFirestoreFieldValue>& Fields);
+
+	static void AddWrite(FWriteBatch& Batch, UFirestoreDocumentReference* const Document, const FWrite& Write);
+
+	/** Commits the writes of a document of a rejected batch on their own. */
+	static void CommitDocument(const FPendingDocument& Pending, const TSharedRef<FFlushState>& State);
+
+	/** Flushes if a batch is full, otherwise starts the window if it isn't running. */
+	void OnWriteQueued(const int32 NumAddedWrites);
+	bool HandleWindowElapsed(float DeltaTime);
+	void HandlePreExit();
+
+private:
+	float Window;
+
+	/** Documents with queued writes, in the order they were first written. Keyed case-sensitively as paths are. */
+	TCaseSensitiveMap<FPendingDocument> PendingDocuments;
+	int32 NumPendingWrites;
+
+	FDelegateHandle TickerHandle;
+};
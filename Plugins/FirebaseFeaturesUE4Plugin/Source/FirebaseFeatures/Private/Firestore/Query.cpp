@@ -2,6 +2,7 @@
 
 #include "Firestore/Query.h"
 #include "Firestore/DocumentChange.h"
+#include "Firestore/QueryResultCache.h"
 
 #if WITH_FIREBASE_FIRESTORE 
     THIRD_PARTY_INCLUDES_START
@@ -13,6 +14,8 @@
 #endif // WITH_FIREBASE_FIRESTORE 
 
 #include "Async/Async.h"
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
+#include "Firestore/FirestoreSnapshotPoller.h"
 
 
 FQuerySnapshotListenerHandle::FQuerySnapshotListenerHandle(FQuerySnapshotListenerHandle&& Other)
@@ -30,6 +33,7 @@ FQuerySnapshotListenerHandle& FQuerySnapshotListenerHandle::operator=(FQuerySnap
 #if WITH_FIREBASE_FIRESTORE
 	Listener = MoveTemp(Other.Listener);
 #endif
+	PolledListenerId = Other.PolledListenerId;
 	return *this;
 }
 
@@ -38,6 +42,7 @@ FQuerySnapshotListenerHandle& FQuerySnapshotListenerHandle::operator=(const FQue
 #if WITH_FIREBASE_FIRESTORE
 	Listener = Other.Listener;
 #endif
+	PolledListenerId = Other.PolledListenerId;
 	return *this;
 }
 
@@ -48,10 +53,20 @@ FQuerySnapshotListenerHandle::FQuerySnapshotListenerHandle(firebase::firestore::
 }
 #endif
 
+FQuerySnapshotListenerHandle::FQuerySnapshotListenerHandle(const uint64 InPolledListenerId)
+	: PolledListenerId(InPolledListenerId)
+{
+}
+
 void FQuerySnapshotListenerHandle::Remove()
 {
-#if WITH_FIREBASE_FIRESTORE
+#if WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS
 	Listener.Remove();
+#elif WITH_FIREBASE_FIRESTORE
+	if (PolledListenerId != 0)
+	{
+		FFirestoreSnapshotPoller::Get().Remove(PolledListenerId);
+	}
 #endif
 }
 
@@ -451,9 +466,16 @@ UFirestoreQuery* UFirestoreQuery::EndAtValues(const TArray<FFirestoreFieldValue>
 void UFirestoreQuery::Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const
 {
 #if WITH_FIREBASE_FIRESTORE 
+	GetNative(*Reference, Source, MoveTemp(Callback));
+#endif // WITH_FIREBASE_FIRESTORE 
+}
+
+#if WITH_FIREBASE_FIRESTORE 
+void UFirestoreQuery::GetNative(const firebase::firestore::Query& Query, const EFirestoreSource Source, FFirestoreQueryCallback Callback)
+{
 	using namespace firebase;
 
-	Reference->Get(static_cast<firestore::Source>(Source)).OnCompletion(
+	Query.Get(static_cast<firestore::Source>(Source)).OnCompletion(
 		[Callback = MoveTemp(Callback)](const Future<firestore::QuerySnapshot>& Result) mutable -> void
 	{
 		const EFirestoreError Error = (EFirestoreError)Result.error();
@@ -490,14 +512,19 @@ void UFirestoreQuery::Get(const EFirestoreSource Source, FFirestoreQueryCallback
 			Callback.ExecuteIfBound(Error, MoveTemp(Snapshots), MoveTemp(QueryChanges));
 		});
 	});
-#endif // WITH_FIREBASE_FIRESTORE 
 }
+#endif // WITH_FIREBASE_FIRESTORE 
 
 void UFirestoreQuery::Get(FFirestoreQueryCallback Callback) const
 {
 	Get(EFirestoreSource::Default, MoveTemp(Callback));
 }
 
+void UFirestoreQuery::GetCached(const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback) const
+{
+	FFirestoreQueryResultCache::Get().GetQuery(FFirestoreQueryBuilder(this), Source, MoveTemp(Callback));
+}
+
 FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotListener(FQuerySnapshotListener Listener)
 {
 	return AddSnapshotListener(FQuerySnapshotListenerCallback::CreateLambda(
@@ -515,20 +542,30 @@ FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotListener(FQuerySnapshot
 
 FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotListener(FQuerySnapshotListenerCallback Callback)
 {
-#if !PLATFORM_LINUX && WITH_FIREBASE_FIRESTORE && defined(FIREBASE_USE_STD_FUNCTION) && !PLATFORM_IOS
-	return Reference->AddSnapshotListener([Listener = MoveTemp(Callback)]
-#if FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
-	(const firebase::firestore::QuerySnapshot& Result, firebase::firestore::Error Error) -> void
+#if WITH_FIREBASE_FIRESTORE
+	return AddNativeSnapshotListener(*Reference, MoveTemp(Callback));
 #else
-	(const firebase::firestore::QuerySnapshot& Result, firebase::firestore::Error Error, const std::string& Message) -> void
+	Callback.ExecuteIfBound(EFirestoreError::Unavailable, {}, {});
+	return FQuerySnapshotListenerHandle();
 #endif
-	{
-#if !FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
-		if (Error != firebase::firestore::Error::kErrorOk)
-		{
-			UE_LOG(LogFirestore, Error, TEXT("Failed to add snapshot listener: %s"), UTF8_TO_TCHAR(Message.c_str()));
-		}
+}
+
+FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotDiffListener(FQuerySnapshotDiffListenerCallback Callback)
+{
+#if WITH_FIREBASE_FIRESTORE
+	return AddNativeSnapshotDiffListener(*Reference, MoveTemp(Callback));
+#else
+	Callback.ExecuteIfBound(EFirestoreError::Unavailable, FFirestoreQuerySnapshotDiff());
+	return FQuerySnapshotListenerHandle();
 #endif
+}
+
+#if WITH_FIREBASE_FIRESTORE
+FQuerySnapshotListenerHandle UFirestoreQuery::AddNativeSnapshotListener(firebase::firestore::Query& Query, FQuerySnapshotListenerCallback Callback)
+{
+	return AddRawSnapshotListener(Query, [Listener = MoveTemp(Callback)](const firebase::firestore::QuerySnapshot& Result,
+		const std::vector<firebase::firestore::DocumentSnapshot>*, const EFirestoreError Error) -> void
+	{
 		TArray<FFirestoreDocumentSnapshot> Snapshots;
 
 		Snapshots.Reserve(Result.documents().size());
@@ -538,7 +575,8 @@ FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotListener(FQuerySnapshot
 			Snapshots.Emplace(FFirestoreDocumentSnapshot(Document));
 		}
 
-		AsyncTask(ENamedThreads::GameThread, [RawDocumentChanges = Result.DocumentChanges(), Listener, Snapshots = MoveTemp(Snapshots), Error]() -> void
+		// Not coalesced: the document changes of each snapshot must be delivered.
+		FFirebaseEventDispatcher::Get().Dispatch([RawDocumentChanges = Result.DocumentChanges(), Listener, Snapshots = MoveTemp(Snapshots), Error]() -> void
 		{
 			TArray<UFirestoreDocumentChange*> Changes;
 			Changes.Reserve(RawDocumentChanges.size());
@@ -550,14 +588,62 @@ FQuerySnapshotListenerHandle UFirestoreQuery::AddSnapshotListener(FQuerySnapshot
 				*DocChange->Internal = Change;
 			}
 
-			Listener.ExecuteIfBound((EFirestoreError)Error, Snapshots, Changes);
+			Listener.ExecuteIfBound(Error, Snapshots, Changes);
 		});		
 	});
+}
+
+FQuerySnapshotListenerHandle UFirestoreQuery::AddNativeSnapshotDiffListener(firebase::firestore::Query& Query, FQuerySnapshotDiffListenerCallback Callback)
+{
+	return AddRawSnapshotListener(Query, [Listener = MoveTemp(Callback)](const firebase::firestore::QuerySnapshot& Result,
+		const std::vector<firebase::firestore::DocumentSnapshot>* PreviousDocuments, const EFirestoreError Error) -> void
+	{
+		// Only the changed documents are converted, the rest stays in the native snapshot.
+		FFirestoreQuerySnapshotDiff Diff;
+
+		if (Error == EFirestoreError::Ok)
+		{
+			Diff = PreviousDocuments ? FFirestoreQuerySnapshotDiff(Result, *PreviousDocuments) : FFirestoreQuerySnapshotDiff(Result);
+		}
+
+		FFirebaseEventDispatcher::Get().Dispatch([Listener, Diff = MoveTemp(Diff), Error]() -> void
+		{
+			Listener.ExecuteIfBound(Error, Diff);
+		});
+	});
+}
+
+FQuerySnapshotListenerHandle UFirestoreQuery::AddRawSnapshotListener(firebase::firestore::Query& Query, FRawSnapshotListener Listener,
+	const bool bIncludeMetadataChanges)
+{
+#if WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS
+	const firebase::firestore::MetadataChanges MetadataChanges = bIncludeMetadataChanges ?
+		firebase::firestore::MetadataChanges::kInclude : firebase::firestore::MetadataChanges::kExclude;
+
+	return FQuerySnapshotListenerHandle(Query.AddSnapshotListener(MetadataChanges, [Listener = MoveTemp(Listener)]
+#if FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
+	(const firebase::firestore::QuerySnapshot& Result, firebase::firestore::Error Error) -> void
+#else
+	(const firebase::firestore::QuerySnapshot& Result, firebase::firestore::Error Error, const std::string& Message) -> void
+#endif
+	{
+#if !FIREBASE_SDK_SMALLER_THAN(8, 9, 0)
+		if (Error != firebase::firestore::Error::kErrorOk)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Failed to add snapshot listener: %s"), UTF8_TO_TCHAR(Message.c_str()));
+		}
+#endif
+		Listener(Result, nullptr, (EFirestoreError)Error);
+	}));
 #else 
-	Callback.ExecuteIfBound(EFirestoreError::Unavailable, {}, {});
-	return FQuerySnapshotListenerHandle();
+	return FQuerySnapshotListenerHandle(FFirestoreSnapshotPoller::Get().AddQuery(Query, [Listener = MoveTemp(Listener)]
+	(const firebase::firestore::QuerySnapshot& Result, const std::vector<firebase::firestore::DocumentSnapshot>& PreviousDocuments, const EFirestoreError Error) -> void
+	{
+		Listener(Result, &PreviousDocuments, Error);
+	}));
 #endif
 }
+#endif // WITH_FIREBASE_FIRESTORE
 
 bool UFirestoreQuery::IsValid() const
 {
@@ -0,0 +1,774 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/QueryBuilder.h"
+#include "Firestore/CollectionReference.h"
+#include "Hash/CityHash.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/document_reference.h"
+#	include "firebase/firestore/geo_point.h"
+#	include "firebase/firestore/timestamp.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+#if WITH_FIREBASE_FIRESTORE
+namespace
+{
+	uint32 HashString(const std::string& String)
+	{
+		return CityHash32(String.data(), (uint32)String.size());
+	}
+
+	/**
+	 * Hashes the type and the payload of the value, without converting it to a string.
+	 * Values of different types have different hashes, as they aren't equal either.
+	 */
+	uint32 HashValue(const firebase::firestore::FieldValue& Value)
+	{
+		using firebase::firestore::FieldValue;
+
+		const uint32 TypeHash = GetTypeHash((uint8)Value.type());
+
+		switch (Value.type())
+		{
+		case FieldValue::Type::kBoolean:
+			return HashCombine(TypeHash, GetTypeHash(Value.boolean_value()));
+
+		case FieldValue::Type::kInteger:
+			return HashCombine(TypeHash, GetTypeHash(Value.integer_value()));
+
+		case FieldValue::Type::kDouble:
+			return HashCombine(TypeHash, GetTypeHash(Value.double_value()));
+
+		case FieldValue::Type::kTimestamp:
+		{
+			const firebase::Timestamp Timestamp = Value.timestamp_value();
+			return HashCombine(TypeHash, HashCombine(GetTypeHash(Timestamp.seconds()), GetTypeHash(Timestamp.nanoseconds())));
+		}
+
+		case FieldValue::Type::kString:
+			return HashCombine(TypeHash, HashString(Value.string_value()));
+
+		case FieldValue::Type::kBlob:
+			return HashCombine(TypeHash, CityHash32((const char*)Value.blob_value(), (uint32)Value.blob_size()));
+
+		case FieldValue::Type::kReference:
+			return HashCombine(TypeHash, HashString(Value.reference_value().path()));
+
+		case FieldValue::Type::kGeoPoint:
+		{
+			const firebase::firestore::GeoPoint GeoPoint = Value.geo_point_value();
+			return HashCombine(TypeHash, HashCombine(GetTypeHash(GeoPoint.latitude()), GetTypeHash(GeoPoint.longitude())));
+		}
+
+		case FieldValue::Type::kArray:
+		{
+			uint32 ArrayHash = TypeHash;
+
+			for (const FieldValue& Element : Value.array_value())
+			{
+				ArrayHash = HashCombine(ArrayHash, HashValue(Element));
+			}
+
+			return ArrayHash;
+		}
+
+		case FieldValue::Type::kMap:
+		{
+			// The fields aren't ordered: their hashes are summed.
+			uint32 FieldsHash = 0;
+
+			for (const auto& Field : Value.map_value())
+			{
+				FieldsHash += HashCombine(HashString(Field.first), HashValue(Field.second));
+			}
+
+			return HashCombine(TypeHash, FieldsHash);
+		}
+
+		default:
+			return TypeHash;
+		}
+	}
+
+	/**
+	 * Native queries built recently, looked up by builder. Reusing a built query avoids
+	 * creating one native query per clause when the same query is run again.
+	 */
+	class FQueryCache
+	{
+	public:
+		static constexpr int32 MaxEntries = 64;
+
+		static FQueryCache& Get()
+		{
+			// Never destroyed: cached queries can't outlive the SDK.
+			static FQueryCache* const Instance = new FQueryCache();
+			return *Instance;
+		}
+
+		firebase::firestore::Query FindOrBuild(const FFirestoreQueryBuilder& Key, TFunctionRef<firebase::firestore::Query()> BuildQuery)
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+
+				for (const TUniquePtr<FEntry>& Entry : Entries)
+				{
+					// Queries are invalidated when Firestore is terminated.
+					if (Entry->Key.GetHash() == Key.GetHash() && Entry->Key == Key && Entry->Query.is_valid())
+					{
+						Entry->LastUse = ++UseCount;
+						return Entry->Query;
+					}
+				}
+			}
+
+			firebase::firestore::Query Query = BuildQuery();
+
+			FScopeLock Lock(&CriticalSection);
+
+			if (Entries.Num() >= MaxEntries)
+			{
+				int32 LeastRecentlyUsed = 0;
+				for (int32 i = 1; i < Entries.Num(); ++i)
+				{
+					if (Entries[i]->LastUse < Entries[LeastRecentlyUsed]->LastUse)
+					{
+						LeastRecentlyUsed = i;
+					}
+				}
+
+				Entries.RemoveAtSwap(LeastRecentlyUsed, 1, false);
+			}
+
+			Entries.Add(MakeUnique<FEntry>(FEntry{ Key, Query, ++UseCount }));
+
+			return Query;
+		}
+
+	private:
+		struct FEntry
+		{
+			FFirestoreQueryBuilder Key;
+			firebase::firestore::Query Query;
+			uint64 LastUse;
+		};
+
+		FCriticalSection CriticalSection;
+		TArray<TUniquePtr<FEntry>> Entries;
+		uint64 UseCount = 0;
+	};
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+// FFirestoreQueryBuilder
+
+FFirestoreQueryBuilder::FFirestoreQueryBuilder()
+	: BaseHash(0)
+	, Hash(0)
+{
+}
+
+FFirestoreQueryBuilder::FFirestoreQueryBuilder(const UFirestoreQuery* const InBase)
+	: FFirestoreQueryBuilder()
+{
+	Reset(InBase);
+}
+
+FFirestoreQueryBuilder::FFirestoreQueryBuilder(const FFirestoreQueryBuilder& Other)
+	: FFirestoreQueryBuilder()
+{
+	*this = Other;
+}
+
+FFirestoreQueryBuilder::FFirestoreQueryBuilder(FFirestoreQueryBuilder&& Other)
+	: FFirestoreQueryBuilder()
+{
+	*this = MoveTemp(Other);
+}
+
+FFirestoreQueryBuilder::~FFirestoreQueryBuilder()
+{
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::operator=(const FFirestoreQueryBuilder& Other)
+{
+	if (this != &Other)
+	{
+#if WITH_FIREBASE_FIRESTORE
+		Base	= Other.Base ? MakeUnique<firebase::firestore::Query>(*Other.Base) : TUniquePtr<firebase::firestore::Query>();
+		Clauses = Other.Clauses;
+#endif // WITH_FIREBASE_FIRESTORE
+		BaseHash = Other.BaseHash;
+		Hash	 = Other.Hash;
+	}
+
+	return *this;
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::operator=(FFirestoreQueryBuilder&& Other)
+{
+	if (this != &Other)
+	{
+#if WITH_FIREBASE_FIRESTORE
+		Base	= MoveTemp(Other.Base);
+		Clauses = MoveTemp(Other.Clauses);
+		Other.Clauses.clear();
+#endif // WITH_FIREBASE_FIRESTORE
+		BaseHash = Other.BaseHash;
+		Hash	 = Other.Hash;
+
+		Other.BaseHash = Other.Hash = 0;
+	}
+
+	return *this;
+}
+
+void FFirestoreQueryBuilder::Reset(const UFirestoreQuery* const InBase)
+{
+	const UFirestoreCollectionReference* const Collection = Cast<UFirestoreCollectionReference>(InBase);
+
+	BaseHash = Collection ? GetTypeHash(Collection->GetPath()) : 0;
+
+#if WITH_FIREBASE_FIRESTORE
+	Base = InBase && InBase->Reference ? MakeUnique<firebase::firestore::Query>(*InBase->Reference) : TUniquePtr<firebase::firestore::Query>();
+#endif // WITH_FIREBASE_FIRESTORE
+
+	Reset();
+}
+
+void FFirestoreQueryBuilder::Reset()
+{
+#if WITH_FIREBASE_FIRESTORE
+	Clauses.clear();
+#endif // WITH_FIREBASE_FIRESTORE
+
+	Hash = BaseHash;
+}
+
+#if WITH_FIREBASE_FIRESTORE
+#	define ADD_FIELD_CLAUSE(ClauseType, Field, Value) return AddFieldClause(EClauseType::ClauseType, Field, Value)
+#	define ADD_CURSOR_CLAUSE(ClauseType, Value) return AddCursorClause(EClauseType::ClauseType, Value)
+#else
+#	define ADD_FIELD_CLAUSE(ClauseType, Field, Value) return *this
+#	define ADD_CURSOR_CLAUSE(ClauseType, Value) return *this
+#endif // WITH_FIREBASE_FIRESTORE
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereEqualTo(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereEqualTo(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereLessThan(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereLessThan, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereLessThan(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereLessThan, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereLessThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereLessThanOrEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereLessThanOrEqualTo(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereLessThanOrEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereGreaterThan(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereGreaterThan, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereGreaterThan(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereGreaterThan, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereGreaterThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereGreaterThanOrEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereGreaterThanOrEqualTo(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereGreaterThanOrEqualTo, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereArrayContains(const FString& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereArrayContains, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereArrayContains(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	ADD_FIELD_CLAUSE(WhereArrayContains, Field, Value);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereArrayContainsAny(const FString& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_FIELD_CLAUSE(WhereArrayContainsAny, Field, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereArrayContainsAny(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_FIELD_CLAUSE(WhereArrayContainsAny, Field, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereIn(const FString& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_FIELD_CLAUSE(WhereIn, Field, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::WhereIn(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_FIELD_CLAUSE(WhereIn, Field, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::StartAt(const FFirestoreDocumentSnapshot& Snapshot)
+{
+	ADD_CURSOR_CLAUSE(StartAt, Snapshot);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::StartAt(const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_CURSOR_CLAUSE(StartAt, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::StartAfter(const FFirestoreDocumentSnapshot& Snapshot)
+{
+	ADD_CURSOR_CLAUSE(StartAfter, Snapshot);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::StartAfter(const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_CURSOR_CLAUSE(StartAfter, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::EndBefore(const FFirestoreDocumentSnapshot& Snapshot)
+{
+	ADD_CURSOR_CLAUSE(EndBefore, Snapshot);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::EndBefore(const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_CURSOR_CLAUSE(EndBefore, Values);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::EndAt(const FFirestoreDocumentSnapshot& Snapshot)
+{
+	ADD_CURSOR_CLAUSE(EndAt, Snapshot);
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::EndAt(const TArray<FFirestoreFieldValue>& Values)
+{
+	ADD_CURSOR_CLAUSE(EndAt, Values);
+}
+
+#undef ADD_FIELD_CLAUSE
+#undef ADD_CURSOR_CLAUSE
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::OrderBy(const FString& Field, const EFirestoreQueryDirection Direction)
+{
+#if WITH_FIREBASE_FIRESTORE
+	FClause Clause;
+	Clause.Type	  = EClauseType::OrderBy;
+	Clause.Field  = TCHAR_TO_UTF8(*Field);
+	Clause.Number = (int32)Direction;
+
+	AddClause(MoveTemp(Clause));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return *this;
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::OrderBy(const FFirestoreFieldPath& Field, const EFirestoreQueryDirection Direction)
+{
+#if WITH_FIREBASE_FIRESTORE
+	FClause Clause;
+	Clause.Type			 = EClauseType::OrderBy;
+	Clause.FieldPath	 = Field;
+	Clause.bUseFieldPath = true;
+	Clause.Number		 = (int32)Direction;
+
+	AddClause(MoveTemp(Clause));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return *this;
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::Limit(const int32 InLimit)
+{
+#if WITH_FIREBASE_FIRESTORE
+	FClause Clause;
+	Clause.Type	  = EClauseType::Limit;
+	Clause.Number = InLimit;
+
+	AddClause(MoveTemp(Clause));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return *this;
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::LimitToLast(const int32 InLimit)
+{
+#if WITH_FIREBASE_FIRESTORE
+	FClause Clause;
+	Clause.Type	  = EClauseType::LimitToLast;
+	Clause.Number = InLimit;
+
+	AddClause(MoveTemp(Clause));
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return *this;
+}
+
+void FFirestoreQueryBuilder::Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	UFirestoreQuery::GetNative(Build(), Source, MoveTemp(Callback));
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreQueryBuilder::Get(FFirestoreQueryCallback Callback) const
+{
+	Get(EFirestoreSource::Default, MoveTemp(Callback));
+}
+
+FQuerySnapshotListenerHandle FFirestoreQueryBuilder::AddSnapshotListener(FQuerySnapshotListenerCallback Callback) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	firebase::firestore::Query Query = Build();
+	return UFirestoreQuery::AddNativeSnapshotListener(Query, MoveTemp(Callback));
+#else
+	Callback.ExecuteIfBound(EFirestoreError::Unavailable, {}, {});
+	return FQuerySnapshotListenerHandle();
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+FQuerySnapshotListenerHandle FFirestoreQueryBuilder::AddSnapshotDiffListener(FQuerySnapshotDiffListenerCallback Callback) const
+{
+#if WITH_FIREBASE_FIRESTORE
+	firebase::firestore::Query Query = Build();
+	return UFirestoreQuery::AddNativeSnapshotDiffListener(Query, MoveTemp(Callback));
+#else
+	Callback.ExecuteIfBound(EFirestoreError::Unavailable, FFirestoreQuerySnapshotDiff());
+	return FQuerySnapshotListenerHandle();
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+UFirestoreQuery* FFirestoreQueryBuilder::ToQuery() const
+{
+	UFirestoreQuery* const Query = NewObject<UFirestoreQuery>();
+
+#if WITH_FIREBASE_FIRESTORE
+	*Query->Reference = Build();
+#endif // WITH_FIREBASE_FIRESTORE
+
+	return Query;
+}
+
+bool FFirestoreQueryBuilder::IsValid() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	return Base && Base->is_valid();
+#else
+	return false;
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+bool FFirestoreQueryBuilder::operator==(const FFirestoreQueryBuilder& Other) const
+{
+	if (Hash != Other.Hash || BaseHash != Other.BaseHash)
+	{
+		return false;
+	}
+
+#if WITH_FIREBASE_FIRESTORE
+	if (!Base || !Other.Base)
+	{
+		return !Base && !Other.Base && Clauses == Other.Clauses;
+	}
+
+	return *Base == *Other.Base && Clauses == Other.Clauses;
+#else
+	return true;
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+#if WITH_FIREBASE_FIRESTORE
+firebase::firestore::Query FFirestoreQueryBuilder::Build() const
+{
+	if (!Base)
+	{
+		UE_LOG(LogFirestore, Error, TEXT("Tried to build a query without base query."));
+		return firebase::firestore::Query();
+	}
+
+	if (Clauses.empty())
+	{
+		return *Base;
+	}
+
+	return FQueryCache::Get().FindOrBuild(*this, [this]() -> firebase::firestore::Query
+	{
+		firebase::firestore::Query Query = *Base;
+
+		for (const FClause& Clause : Clauses)
+		{
+			Query = ApplyClause(Query, Clause);
+		}
+
+		return Query;
+	});
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddClause(FClause&& Clause)
+{
+	Hash = HashCombine(Hash, Clause.GetHash());
+	Clauses.push_back(MoveTemp(Clause));
+	return *this;
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddFieldClause(const EClauseType Type, const FString& Field, const FFirestoreFieldValue& Value)
+{
+	FClause Clause;
+	Clause.Type	 = Type;
+	Clause.Field = TCHAR_TO_UTF8(*Field);
+	Clause.Values.push_back(Value.ToNative());
+
+	return AddClause(MoveTemp(Clause));
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddFieldClause(const EClauseType Type, const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)
+{
+	FClause Clause;
+	Clause.Type			 = Type;
+	Clause.FieldPath	 = Field;
+	Clause.bUseFieldPath = true;
+	Clause.Values.push_back(Value.ToNative());
+
+	return AddClause(MoveTemp(Clause));
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddFieldClause(const EClauseType Type, const FString& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	FClause Clause;
+	Clause.Type	 = Type;
+	Clause.Field = TCHAR_TO_UTF8(*Field);
+
+	Clause.Values.reserve(Values.Num());
+	for (const FFirestoreFieldValue& Value : Values)
+	{
+		Clause.Values.push_back(Value.ToNative());
+	}
+
+	return AddClause(MoveTemp(Clause));
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddFieldClause(const EClauseType Type, const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values)
+{
+	FClause Clause;
+	Clause.Type			 = Type;
+	Clause.FieldPath	 = Field;
+	Clause.bUseFieldPath = true;
+
+	Clause.Values.reserve(Values.Num());
+	for (const FFirestoreFieldValue& Value : Values)
+	{
+		Clause.Values.push_back(Value.ToNative());
+	}
+
+	return AddClause(MoveTemp(Clause));
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddCursorClause(const EClauseType Type, const FFirestoreDocumentSnapshot& Snapshot)
+{
+	FClause Clause;
+	Clause.Type		= Type;
+	Clause.Snapshot = Snapshot;
+
+	return AddClause(MoveTemp(Clause));
+}
+
+FFirestoreQueryBuilder& FFirestoreQueryBuilder::AddCursorClause(const EClauseType Type, const TArray<FFirestoreFieldValue>& Values)
+{
+	FClause Clause;
+	Clause.Type = Type;
+
+	Clause.Values.reserve(Values.Num());
+	for (const FFirestoreFieldValue& Value : Values)
+	{
+		Clause.Values.push_back(Value.ToNative());
+	}
+
+	return AddClause(MoveTemp(Clause));
+}
+
+firebase::firestore::Query FFirestoreQueryBuilder::ApplyClause(const firebase::firestore::Query& Query, const FClause& Clause)
+{
+#define APPLY_FIELD_CLAUSE(Method, ...) \
+	return Clause.bUseFieldPath ? Query.Method(Clause.FieldPath, __VA_ARGS__) : Query.Method(Clause.Field, __VA_ARGS__)
+
+	const bool bSnapshotCursor = Clause.Snapshot.is_valid();
+
+	switch (Clause.Type)
+	{
+	case EClauseType::WhereEqualTo:				 APPLY_FIELD_CLAUSE(WhereEqualTo,				Clause.Values[0]);
+	case EClauseType::WhereLessThan:			 APPLY_FIELD_CLAUSE(WhereLessThan,				Clause.Values[0]);
+	case EClauseType::WhereLessThanOrEqualTo:	 APPLY_FIELD_CLAUSE(WhereLessThanOrEqualTo,		Clause.Values[0]);
+	case EClauseType::WhereGreaterThan:			 APPLY_FIELD_CLAUSE(WhereGreaterThan,			Clause.Values[0]);
+	case EClauseType::WhereGreaterThanOrEqualTo: APPLY_FIELD_CLAUSE(WhereGreaterThanOrEqualTo,	Clause.Values[0]);
+	case EClauseType::WhereArrayContains:		 APPLY_FIELD_CLAUSE(WhereArrayContains,			Clause.Values[0]);
+	case EClauseType::WhereArrayContainsAny:	 APPLY_FIELD_CLAUSE(WhereArrayContainsAny,		Clause.Values);
+	case EClauseType::WhereIn:					 APPLY_FIELD_CLAUSE(WhereIn,					Clause.Values);
+	case EClauseType::OrderBy:					 APPLY_FIELD_CLAUSE(OrderBy,					(firebase::firestore::Query::Direction)Clause.Number);
+
+	case EClauseType::Limit:		return Query.Limit(Clause.Number);
+	case EClauseType::LimitToLast:	return Query.LimitToLast(Clause.Number);
+
+	case EClauseType::StartAt:		return bSnapshotCursor ? Query.StartAt(Clause.Snapshot)	   : Query.StartAt(Clause.Values);
+	case EClauseType::StartAfter:	return bSnapshotCursor ? Query.StartAfter(Clause.Snapshot) : Query.StartAfter(Clause.Values);
+	case EClauseType::EndBefore:	return bSnapshotCursor ? Query.EndBefore(Clause.Snapshot)  : Query.EndBefore(Clause.Values);
+	case EClauseType::EndAt:		return bSnapshotCursor ? Query.EndAt(Clause.Snapshot)	   : Query.EndAt(Clause.Values);
+	}
+
+#undef APPLY_FIELD_CLAUSE
+
+	return Query;
+}
+
+bool FFirestoreQueryBuilder::FClause::operator==(const FClause& Other) const
+{
+	if (Type != Other.Type || bUseFieldPath != Other.bUseFieldPath || Number != Other.Number)
+	{
+		return false;
+	}
+
+	if (bUseFieldPath ? !(FieldPath == Other.FieldPath) : Field != Other.Field)
+	{
+		return false;
+	}
+
+	if (Snapshot.is_valid() != Other.Snapshot.is_valid() || (Snapshot.is_valid() && !(Snapshot == Other.Snapshot)))
+	{
+		return false;
+	}
+
+	return Values == Other.Values;
+}
+
+uint32 FFirestoreQueryBuilder::FClause::GetHash() const
+{
+	uint32 ClauseHash = HashCombine(GetTypeHash((uint8)Type), GetTypeHash(Number));
+
+	ClauseHash = HashCombine(ClauseHash, bUseFieldPath ? (uint32)std::hash<firebase::firestore::FieldPath>()(FieldPath) : HashString(Field));
+
+	// Equal hashes are confirmed by comparing the values.
+	for (const firebase::firestore::FieldValue& Value : Values)
+	{
+		ClauseHash = HashCombine(ClauseHash, HashValue(Value));
+	}
+
+	if (Snapshot.is_valid())
+	{
+		ClauseHash = HashCombine(ClauseHash, HashString(Snapshot.reference().path()));
+	}
+
+	return ClauseHash;
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+// UFirestoreQueryBuilder
+
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::CreateQueryBuilder(UFirestoreQuery* const Query)
+{
+	UFirestoreQueryBuilder* const Builder = NewObject<UFirestoreQueryBuilder>();
+	Builder->Builder.Reset(Query);
+	return Builder;
+}
+
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::Reset(UFirestoreQuery* const Query)
+{
+	Builder.Reset(Query);
+	return this;
+}
+
+#define BUILDER_CLAUSE(Method, ...) \
+	Builder.Method(__VA_ARGS__);	\
+	return this
+
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereEqualTo(const FString& Field, const FFirestoreFieldValue& Value)							{ BUILDER_CLAUSE(WhereEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)		{ BUILDER_CLAUSE(WhereEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereLessThan(const FString& Field, const FFirestoreFieldValue& Value)							{ BUILDER_CLAUSE(WhereLessThan, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereLessThanFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)		{ BUILDER_CLAUSE(WhereLessThan, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereLessThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value)					{ BUILDER_CLAUSE(WhereLessThanOrEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereLessThanOrEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)	{ BUILDER_CLAUSE(WhereLessThanOrEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereGreaterThan(const FString& Field, const FFirestoreFieldValue& Value)						{ BUILDER_CLAUSE(WhereGreaterThan, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereGreaterThanFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)	{ BUILDER_CLAUSE(WhereGreaterThan, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereGreaterThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value)				{ BUILDER_CLAUSE(WhereGreaterThanOrEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereGreaterThanOrEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)	{ BUILDER_CLAUSE(WhereGreaterThanOrEqualTo, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereArrayContains(const FString& Field, const FFirestoreFieldValue& Value)						{ BUILDER_CLAUSE(WhereArrayContains, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereArrayContainsFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value)	{ BUILDER_CLAUSE(WhereArrayContains, Field, Value); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereArrayContainsAny(const FString& Field, const TArray<FFirestoreFieldValue>& Values)			{ BUILDER_CLAUSE(WhereArrayContainsAny, Field, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereArrayContainsAnyFieldPath(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values) { BUILDER_CLAUSE(WhereArrayContainsAny, Field, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereIn(const FString& Field, const TArray<FFirestoreFieldValue>& Values)						{ BUILDER_CLAUSE(WhereIn, Field, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::WhereInFieldPath(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values)	{ BUILDER_CLAUSE(WhereIn, Field, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::OrderBy(const FString& Field, EFirestoreQueryDirection Direction)								{ BUILDER_CLAUSE(OrderBy, Field, Direction); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::OrderByFieldPath(const FFirestoreFieldPath& Field, EFirestoreQueryDirection Direction)			{ BUILDER_CLAUSE(OrderBy, Field, Direction); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::Limit(int32 InLimit)																			{ BUILDER_CLAUSE(Limit, InLimit); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::LimitToLast(int32 InLimit)																		{ BUILDER_CLAUSE(LimitToLast, InLimit); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::StartAt(const FFirestoreDocumentSnapshot& Snapshot)												{ BUILDER_CLAUSE(StartAt, Snapshot); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::StartAtFieldValue(const TArray<FFirestoreFieldValue>& Values)									{ BUILDER_CLAUSE(StartAt, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::StartAfter(const FFirestoreDocumentSnapshot& Snapshot)											{ BUILDER_CLAUSE(StartAfter, Snapshot); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::StartAfterFieldValue(const TArray<FFirestoreFieldValue>& Values)								{ BUILDER_CLAUSE(StartAfter, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::EndBefore(const FFirestoreDocumentSnapshot& Snapshot)											{ BUILDER_CLAUSE(EndBefore, Snapshot); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::EndBeforeFieldValue(const TArray<FFirestoreFieldValue>& Values)									{ BUILDER_CLAUSE(EndBefore, Values); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::EndAt(const FFirestoreDocumentSnapshot& Snapshot)												{ BUILDER_CLAUSE(EndAt, Snapshot); }
+UFirestoreQueryBuilder* UFirestoreQueryBuilder::EndAtFieldValue(const TArray<FFirestoreFieldValue>& Values)										{ BUILDER_CLAUSE(EndAt, Values); }
+
+#undef BUILDER_CLAUSE
+
+UFirestoreQuery* UFirestoreQueryBuilder::ToQuery() const
+{
+	return Builder.ToQuery();
+}
+
+FQuerySnapshotListenerHandle UFirestoreQueryBuilder::AddSnapshotListener(FQuerySnapshotListener Listener)
+{
+	return Builder.AddSnapshotListener(FQuerySnapshotListenerCallback::CreateLambda(
+		[Listener = MoveTemp(Listener)]
+		(
+			const EFirestoreError Error,
+			const TArray<FFirestoreDocumentSnapshot>& Snapshots,
+			const TArray<UFirestoreDocumentChange*>& Changes
+		) -> void
+		{
+			Listener.ExecuteIfBound(Error, Snapshots, Changes);
+		}
+	));
+}
+
+void UFirestoreQueryBuilder::GetDocuments(const EFirestoreSource Source, FQueryBuilderGetCallback Callback) const
+{
+	Builder.Get(Source, FFirestoreQueryCallback::CreateLambda([Callback = MoveTemp(Callback)]
+		(EFirestoreError Error, TArray<FFirestoreDocumentSnapshot> Snapshots, TArray<UFirestoreDocumentChange*> Changes) -> void
+	{
+		Callback.ExecuteIfBound(Error, Snapshots, Changes);
+	}));
+}
+
+void UFirestoreQueryBuilder::Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const
+{
+	Builder.Get(Source, MoveTemp(Callback));
+}
@@ -0,0 +1,244 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/QueryCursor.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/future.h"
+#	include "firebase/firestore/query.h"
+#	include "firebase/firestore/query_snapshot.h"
+#	include "firebase/firestore/document_snapshot.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+#include "Async/Async.h"
+
+struct FFirestoreQueryCursor::FPage
+{
+	EFirestoreError Error = EFirestoreError::Ok;
+
+	/** Converted on the SDK's thread. */
+	TArray<FFirestoreDocumentSnapshot> Documents;
+
+#if WITH_FIREBASE_FIRESTORE
+	TUniquePtr<firebase::firestore::DocumentSnapshot> LastDocument;
+#endif
+};
+
+TSharedRef<FFirestoreQueryCursor, ESPMode::ThreadSafe> FFirestoreQueryCursor::Create(const FFirestoreQueryBuilder& Query,
+	const FFirestoreQueryCursorSettings& Settings)
+{
+	check(IsInGameThread());
+
+	const TSharedRef<FFirestoreQueryCursor, ESPMode::ThreadSafe> Cursor = MakeShareable(new FFirestoreQueryCursor(Query, Settings));
+
+	Cursor->ReadAhead();
+
+	return Cursor;
+}
+
+FFirestoreQueryCursor::FFirestoreQueryCursor(const FFirestoreQueryBuilder& InQuery, const FFirestoreQueryCursorSettings& InSettings)
+	: Settings(InSettings)
+	, Error(EFirestoreError::Ok)
+	, NumDocuments(0)
+	, bReading(false)
+	, bReadAll(false)
+	, bCancelled(false)
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (InQuery.IsValid())
+	{
+		Query = MakeUnique<firebase::firestore::Query>(InQuery.Build().Limit(FMath::Max(Settings.PageSize, 1)));
+	}
+	else
+#endif // WITH_FIREBASE_FIRESTORE
+	{
+		UE_LOG(LogFirestore, Error, TEXT("Query cursor created with an invalid query."));
+		Error = EFirestoreError::InvalidArgument;
+	}
+}
+
+FFirestoreQueryCursor::~FFirestoreQueryCursor() = default;
+
+void FFirestoreQueryCursor::Next(FFirestoreQueryPageCallback Callback)
+{
+	check(IsInGameThread());
+
+	if (PendingCallback.IsBound())
+	{
+		UE_LOG(LogFirestore, Error, TEXT("Query cursor's next page requested before the previous one was delivered."));
+		Callback.ExecuteIfBound(EFirestoreError::FailedPrecondition, {});
+		return;
+	}
+
+	if (bCancelled)
+	{
+		Callback.ExecuteIfBound(EFirestoreError::Cancelled, {});
+		return;
+	}
+
+	PendingCallback = MoveTemp(Callback);
+
+	Deliver();
+}
+
+void FFirestoreQueryCursor::ForEachPage(FFirestoreQueryPageDelegate OnPage, FFirestoreCallback OnComplete)
+{
+	// The callback keeps the cursor alive until the iteration completes.
+	Next(FFirestoreQueryPageCallback::CreateLambda([Cursor = AsShared(), OnPage = MoveTemp(OnPage), OnComplete = MoveTemp(OnComplete)]
+		(const EFirestoreError PageError, const TArray<FFirestoreDocumentSnapshot>& Page) -> void
+	{
+		if (PageError != EFirestoreError::Ok || Page.Num() == 0)
+		{
+			OnComplete.ExecuteIfBound(PageError);
+		}
+		else if (!OnPage.IsBound() || !OnPage.Execute(Page))
+		{
+			Cursor->Cancel();
+			OnComplete.ExecuteIfBound(EFirestoreError::Ok);
+		}
+		else
+		{
+			// The pending callback is cleared before being called, so the next page can be requested from it.
+			Cursor->ForEachPage(OnPage, OnComplete);
+		}
+	}));
+}
+
+void FFirestoreQueryCursor::Cancel()
+{
+	check(IsInGameThread());
+
+	bCancelled = true;
+
+	PendingCallback.Unbind();
+	Pages.Empty();
+}
+
+bool FFirestoreQueryCursor::IsDone() const
+{
+	return bCancelled || Error != EFirestoreError::Ok || (bReadAll && Pages.Num() == 0);
+}
+
+void FFirestoreQueryCursor::ReadAhead()
+{
+	if (bReading || bReadAll || bCancelled || Error != EFirestoreError::Ok || Pages.Num() >= FMath::Max(Settings.ReadAhead, 1))
+	{
+		return;
+	}
+
+#if WITH_FIREBASE_FIRESTORE
+	bReading = true;
+
+	const firebase::firestore::Query PageQuery = LastDocument ? Query->StartAfter(*LastDocument) : *Query;
+
+	PageQuery.Get(static_cast<firebase::firestore::Source>(Settings.Source)).OnCompletion(
+		[WeakCursor = TWeakPtr<FFirestoreQueryCursor, ESPMode::ThreadSafe>(AsShared())](const firebase::Future<firebase::firestore::QuerySnapshot>& Result) -> void
+	{
+		FPage Page;
+
+		Page.Error = (EFirestoreError)Result.error();
+
+		if (Page.Error != EFirestoreError::Ok)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Query cursor failed to read a page. Reason: %s."), UTF8_TO_TCHAR(Result.error_message()));
+		}
+		else if (const firebase::firestore::QuerySnapshot* const Snapshot = Result.result())
+		{
+			const std::vector<firebase::firestore::DocumentSnapshot> Documents = Snapshot->documents();
+
+			Page.Documents.Reserve(Documents.size());
+
+			for (const firebase::firestore::DocumentSnapshot& Document : Documents)
+			{
+				Page.Documents.Emplace(FFirestoreDocumentSnapshot(Document));
+			}
+
+			if (!Documents.empty())
+			{
+				Page.LastDocument = MakeUnique<firebase::firestore::DocumentSnapshot>(Documents.back());
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakCursor, Page = MoveTemp(Page)]() mutable -> void
+		{
+			if (const TSharedPtr<FFirestoreQueryCursor, ESPMode::ThreadSafe> Cursor = WeakCursor.Pin())
+			{
+				Cursor->HandlePage(MoveTemp(Page));
+			}
+		});
+	});
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreQueryCursor::HandlePage(FPage&& Page)
+{
+	bReading = false;
+
+	if (bCancelled)
+	{
+		return;
+	}
+
+	if (Page.Error != EFirestoreError::Ok)
+	{
+		Error = Page.Error;
+	}
+	else
+	{
+		// A short page is the last one.
+		bReadAll = Page.Documents.Num() < FMath::Max(Settings.PageSize, 1);
+
+#if WITH_FIREBASE_FIRESTORE
+		if (Page.LastDocument)
+		{
+			LastDocument = MoveTemp(Page.LastDocument);
+		}
+#endif
+
+		if (Page.Documents.Num() > 0)
+		{
+			Pages.Add(MoveTemp(Page.Documents));
+		}
+	}
+
+	ReadAhead();
+	Deliver();
+}
+
+void FFirestoreQueryCursor::Deliver()
+{
+	if (!PendingCallback.IsBound())
+	{
+		return;
+	}
+
+	if (Pages.Num() > 0)
+	{
+		// Released once the callback returns.
+		const TArray<FFirestoreDocumentSnapshot> Page = MoveTemp(Pages[0]);
+		Pages.RemoveAt(0, 1, false);
+
+		NumDocuments += Page.Num();
+
+		// A page was consumed: there is room to read one more.
+		ReadAhead();
+
+		const FFirestoreQueryPageCallback Callback = MoveTemp(PendingCallback);
+		PendingCallback.Unbind();
+
+		Callback.ExecuteIfBound(EFirestoreError::Ok, Page);
+	}
+	else if (Error != EFirestoreError::Ok || bReadAll)
+	{
+		const FFirestoreQueryPageCallback Callback = MoveTemp(PendingCallback);
+		PendingCallback.Unbind();
+
+		Callback.ExecuteIfBound(Error, {});
+	}
+	else
+	{
+		// Waiting for the page being read.
+		ReadAhead();
+	}
+}
@@ -0,0 +1,389 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/QueryResultCache.h"
+#include "FirebaseSdk/FirebaseConfig.h"
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/document_reference.h"
+#	include "firebase/firestore/document_snapshot.h"
+#	include "firebase/firestore/query_snapshot.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+struct FFirestoreQueryResultCache::FEntry
+{
+	FFirestoreQueryBuilder Query;
+
+	FQuerySnapshotListenerHandle Listener;
+
+	/** Documents of the listener's last snapshot. */
+	TArray<FFirestoreDocumentSnapshot> Snapshots;
+
+	/** Callbacks waiting for the listener's first snapshot. */
+	TArray<FFirestoreCachedQueryCallback> PendingCallbacks;
+
+	/** Callbacks waiting for the listener's first snapshot, requiring results from the server. */
+	TArray<FFirestoreCachedQueryCallback> ServerCallbacks;
+
+	int64 NumBytes = 0;
+
+	bool bHasResults = false;
+	bool bFromCache  = false;
+	bool bRemoved    = false;
+
+	bool HasPendingCallbacks() const
+	{
+		return PendingCallbacks.Num() > 0 || ServerCallbacks.Num() > 0;
+	}
+};
+
+#if WITH_FIREBASE_FIRESTORE
+namespace
+{
+	// Rough size of the native objects backing a value or a snapshot.
+	constexpr int64 NativeValueOverhead    = 32;
+	constexpr int64 NativeSnapshotOverhead = 256;
+
+	int64 EstimateSize(const firebase::firestore::FieldValue& Value)
+	{
+		using firebase::firestore::FieldValue;
+
+		int64 NumBytes = NativeValueOverhead;
+
+		switch (Value.type())
+		{
+		case FieldValue::Type::kString:
+			NumBytes += Value.string_value().size();
+			break;
+
+		case FieldValue::Type::kBlob:
+			NumBytes += Value.blob_size();
+			break;
+
+		case FieldValue::Type::kReference:
+			NumBytes += Value.reference_value().path().size();
+			break;
+
+		case FieldValue::Type::kArray:
+			for (const FieldValue& Element : Value.array_value())
+			{
+				NumBytes += EstimateSize(Element);
+			}
+			break;
+
+		case FieldValue::Type::kMap:
+			for (const auto& Field : Value.map_value())
+			{
+				NumBytes += Field.first.size() + EstimateSize(Field.second);
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		return NumBytes;
+	}
+
+	int64 EstimateSize(const firebase::firestore::DocumentSnapshot& Document)
+	{
+		int64 NumBytes = sizeof(FFirestoreDocumentSnapshot) + NativeSnapshotOverhead + Document.reference().path().size();
+
+		for (const auto& Field : Document.GetData())
+		{
+			NumBytes += Field.first.size() + EstimateSize(Field.second);
+		}
+
+		return NumBytes;
+	}
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+FFirestoreQueryResultCache& FFirestoreQueryResultCache::Get()
+{
+	// Never destroyed: listeners can't be removed once the SDK is gone.
+	static FFirestoreQueryResultCache* const Instance = new FFirestoreQueryResultCache();
+	return *Instance;
+}
+
+FFirestoreQueryResultCache::FFirestoreQueryResultCache()
+	: Budget(FMath::Max<int64>(UFirebaseConfig::Get()->QueryResultCacheSizeKB, 0) * 1024)
+	, UsedBytes(0)
+{
+}
+
+void FFirestoreQueryResultCache::GetQuery(const FFirestoreQueryBuilder& Query, FFirestoreCachedQueryCallback Callback)
+{
+	GetQuery(Query, EFirestoreSource::Default, MoveTemp(Callback));
+}
+
+void FFirestoreQueryResultCache::GetQuery(const FFirestoreQueryBuilder& Query, const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback)
+{
+	check(IsInGameThread());
+
+#if WITH_FIREBASE_FIRESTORE
+	if (Budget <= 0 || !Query.IsValid() || Source == EFirestoreSource::Server)
+	{
+		GetUncached(Query, Source, MoveTemp(Callback));
+		return;
+	}
+
+	const bool bRequireServer = Source == EFirestoreSource::Default;
+
+	const int32 Index = FindEntry(Query);
+
+	if (Index != INDEX_NONE)
+	{
+		const FEntryRef Entry = Entries[Index];
+
+		Entries.RemoveAt(Index, 1, false);
+		Entries.Add(Entry);
+
+		if (Entry->bHasResults && (!bRequireServer || !Entry->bFromCache))
+		{
+			Callback.ExecuteIfBound(EFirestoreError::Ok, Entry->Snapshots);
+		}
+		else if (Entry->bHasResults)
+		{
+			// The listener only has results from Firestore's cache, likely offline: the
+			// SDK decides between the server and its cache.
+			GetUncached(Query, Source, MoveTemp(Callback));
+		}
+		else
+		{
+			(bRequireServer ? Entry->ServerCallbacks : Entry->PendingCallbacks).Add(MoveTemp(Callback));
+		}
+
+		return;
+	}
+
+	const FEntryRef Entry = MakeShared<FEntry, ESPMode::ThreadSafe>();
+
+	Entry->Query = Query;
+	(bRequireServer ? Entry->ServerCallbacks : Entry->PendingCallbacks).Add(MoveTemp(Callback));
+
+	Entries.Add(Entry);
+
+	firebase::firestore::Query NativeQuery = Query.Build();
+
+	Entry->Listener = UFirestoreQuery::AddRawSnapshotListener(NativeQuery, [WeakEntry = TWeakPtr<FEntry, ESPMode::ThreadSafe>(Entry), Channel = FFirebaseEventDispatcher::CreateChannel()](const firebase::firestore::QuerySnapshot& Result,
+		const std::vector<firebase::firestore::DocumentSnapshot>*, const EFirestoreError Error) -> void
+	{
+		// The query was removed from the cache, skip the conversion.
+		if (!WeakEntry.IsValid())
+		{
+			return;
+		}
+
+		TArray<FFirestoreDocumentSnapshot> Snapshots;
+		int64 NumBytes = sizeof(FEntry);
+		bool bFromCache = false;
+
+		if (Error == EFirestoreError::Ok)
+		{
+			bFromCache = Result.metadata().is_from_cache();
+
+			const std::vector<firebase::firestore::DocumentSnapshot> Documents = Result.documents();
+
+			Snapshots.Reserve(Documents.size());
+
+			for (const firebase::firestore::DocumentSnapshot& Document : Documents)
+			{
+				NumBytes += EstimateSize(Document);
+				Snapshots.Emplace(FFirestoreDocumentSnapshot(Document));
+			}
+		}
+
+		// Only the last snapshot is kept, the ones not handled yet can be skipped.
+		FFirebaseEventDispatcher::Get().Dispatch(Channel, [WeakEntry, Error, Snapshots = MoveTemp(Snapshots), NumBytes, bFromCache]() mutable -> void
+		{
+			if (const TSharedPtr<FEntry, ESPMode::ThreadSafe> Entry = WeakEntry.Pin())
+			{
+				FFirestoreQueryResultCache::Get().HandleSnapshot(Entry.ToSharedRef(), Error, MoveTemp(Snapshots), NumBytes, bFromCache);
+			}
+		});
+	}, /* bIncludeMetadataChanges */ true);
+
+	EnforceBudget();
+#else
+	Callback.ExecuteIfBound(EFirestoreError::Unavailable, {});
+#endif
+}
+
+void FFirestoreQueryResultCache::Invalidate(const FFirestoreQueryBuilder& Query)
+{
+	check(IsInGameThread());
+
+	const int32 Index = FindEntry(Query);
+
+	if (Index != INDEX_NONE)
+	{
+		RemoveEntry(Index);
+	}
+}
+
+void FFirestoreQueryResultCache::Empty()
+{
+	check(IsInGameThread());
+
+	while (Entries.Num() > 0)
+	{
+		RemoveEntry(Entries.Num() - 1);
+	}
+}
+
+void FFirestoreQueryResultCache::SetBudget(const int64 Bytes)
+{
+	check(IsInGameThread());
+
+	Budget = FMath::Max<int64>(Bytes, 0);
+
+	if (Budget == 0)
+	{
+		Empty();
+	}
+	else
+	{
+		EnforceBudget();
+	}
+}
+
+int64 FFirestoreQueryResultCache::GetBudget() const
+{
+	return Budget;
+}
+
+int64 FFirestoreQueryResultCache::GetUsedBytes() const
+{
+	return UsedBytes;
+}
+
+int32 FFirestoreQueryResultCache::FindEntry(const FFirestoreQueryBuilder& Query) const
+{
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FEntry& Entry = *Entries[i];
+
+		if (Entry.Query.GetHash() == Query.GetHash() && Entry.Query == Query)
+		{
+			return i;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FFirestoreQueryResultCache::RemoveEntry(const int32 Index)
+{
+	const FEntryRef Entry = Entries[Index];
+
+	Entries.RemoveAt(Index);
+
+	Entry->bRemoved = true;
+	Entry->Listener.Remove();
+
+	UsedBytes -= Entry->NumBytes;
+
+	// Callbacks still waiting for the listener are answered by the SDK instead.
+	for (FFirestoreCachedQueryCallback& Callback : Entry->PendingCallbacks)
+	{
+		GetUncached(Entry->Query, EFirestoreSource::Cache, MoveTemp(Callback));
+	}
+
+	for (FFirestoreCachedQueryCallback& Callback : Entry->ServerCallbacks)
+	{
+		GetUncached(Entry->Query, EFirestoreSource::Default, MoveTemp(Callback));
+	}
+
+	Entry->PendingCallbacks.Empty();
+	Entry->ServerCallbacks.Empty();
+}
+
+void FFirestoreQueryResultCache::GetUncached(const FFirestoreQueryBuilder& Query, const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback)
+{
+	Query.Get(Source, FFirestoreQueryCallback::CreateLambda([Callback = MoveTemp(Callback)](EFirestoreError Error, TArray<FFirestoreDocumentSnapshot> Snapshots, TArray<UFirestoreDocumentChange*>) -> void
+	{
+		Callback.ExecuteIfBound(Error, Snapshots);
+	}));
+}
+
+void FFirestoreQueryResultCache::EnforceBudget()
+{
+	int32 Index = 0;
+
+	while ((Entries.Num() > MaxEntries || UsedBytes > Budget) && Index < Entries.Num())
+	{
+		// Keeps the queries still waiting for their first results.
+		if (Entries[Index]->HasPendingCallbacks())
+		{
+			++Index;
+			continue;
+		}
+
+		RemoveEntry(Index);
+	}
+}
+
+void FFirestoreQueryResultCache::HandleSnapshot(const FEntryRef& Entry, const EFirestoreError Error, TArray<FFirestoreDocumentSnapshot>&& Snapshots,
+	const int64 NumBytes, const bool bFromCache)
+{
+	if (Entry->bRemoved)
+	{
+		return;
+	}
+
+	if (Error != EFirestoreError::Ok)
+	{
+		// The listener is stopped after an error, so the results can't be kept up to date.
+		TArray<FFirestoreCachedQueryCallback> Callbacks = MoveTemp(Entry->PendingCallbacks);
+		Callbacks.Append(MoveTemp(Entry->ServerCallbacks));
+
+		Entry->PendingCallbacks.Empty();
+		Entry->ServerCallbacks.Empty();
+
+		RemoveEntry(Entries.IndexOfByKey(Entry));
+
+		for (const FFirestoreCachedQueryCallback& Callback : Callbacks)
+		{
+			Callback.ExecuteIfBound(Error, {});
+		}
+
+		return;
+	}
+
+	UsedBytes += NumBytes - Entry->NumBytes;
+
+	Entry->NumBytes    = NumBytes;
+	Entry->Snapshots   = MoveTemp(Snapshots);
+	Entry->bHasResults = true;
+	Entry->bFromCache  = bFromCache;
+
+	const TArray<FFirestoreCachedQueryCallback> Callbacks = MoveTemp(Entry->PendingCallbacks);
+	const TArray<FFirestoreCachedQueryCallback> ServerCallbacks = MoveTemp(Entry->ServerCallbacks);
+
+	Entry->PendingCallbacks.Empty();
+	Entry->ServerCallbacks.Empty();
+
+	for (const FFirestoreCachedQueryCallback& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound(EFirestoreError::Ok, Entry->Snapshots);
+	}
+
+	for (const FFirestoreCachedQueryCallback& Callback : ServerCallbacks)
+	{
+		if (bFromCache)
+		{
+			// Results from Firestore's cache come first when it has the documents, and are
+			// the only ones offline: the SDK decides between the server and its cache.
+			GetUncached(Entry->Query, EFirestoreSource::Default, Callback);
+		}
+		else
+		{
+			Callback.ExecuteIfBound(EFirestoreError::Ok, Entry->Snapshots);
+		}
+	}
+
+	EnforceBudget();
+}
@@ -0,0 +1,181 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/QuerySnapshotDiff.h"
+
+#if WITH_FIREBASE_FIRESTORE
+	THIRD_PARTY_INCLUDES_START
+#		include "firebase/firestore/query_snapshot.h"
+#		include "firebase/firestore/document_change.h"
+#		include "firebase/firestore/document_reference.h"
+	THIRD_PARTY_INCLUDES_END
+
+#	include <algorithm>
+#	include <string>
+#	include <unordered_map>
+#endif // WITH_FIREBASE_FIRESTORE
+
+#if WITH_FIREBASE_FIRESTORE
+namespace
+{
+	int32 ToIndex(const std::size_t Index)
+	{
+		return Index == firebase::firestore::DocumentChange::npos ? INDEX_NONE : (int32)Index;
+	}
+
+	FFirestoreDocumentDiff MakeChange(const EDocumentChangeType Type, const int32 OldIndex, const int32 NewIndex,
+		const firebase::firestore::DocumentSnapshot& Document)
+	{
+		FFirestoreDocumentDiff Change;
+
+		Change.Type     = Type;
+		Change.OldIndex = OldIndex;
+		Change.NewIndex = NewIndex;
+		Change.Document = FFirestoreDocumentSnapshot(Document);
+
+		return Change;
+	}
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+FFirestoreQuerySnapshotDiff::FFirestoreQuerySnapshotDiff() = default;
+FFirestoreQuerySnapshotDiff::FFirestoreQuerySnapshotDiff(FFirestoreQuerySnapshotDiff&& Other) = default;
+FFirestoreQuerySnapshotDiff::~FFirestoreQuerySnapshotDiff() = default;
+
+FFirestoreQuerySnapshotDiff& FFirestoreQuerySnapshotDiff::operator=(FFirestoreQuerySnapshotDiff&& Other) = default;
+
+#if WITH_FIREBASE_FIRESTORE
+FFirestoreQuerySnapshotDiff::FFirestoreQuerySnapshotDiff(const firebase::firestore::QuerySnapshot& InSnapshot)
+	: Snapshot(MakeUnique<firebase::firestore::QuerySnapshot>(InSnapshot))
+{
+	const std::vector<firebase::firestore::DocumentChange> RawChanges = InSnapshot.DocumentChanges();
+
+	Changes.Reserve(RawChanges.size());
+
+	for (const firebase::firestore::DocumentChange& RawChange : RawChanges)
+	{
+		FFirestoreDocumentDiff& Change = Changes.Emplace_GetRef();
+
+		Change.Type     = (EDocumentChangeType)RawChange.type();
+		Change.OldIndex = ToIndex(RawChange.old_index());
+		Change.NewIndex = ToIndex(RawChange.new_index());
+		Change.Document = FFirestoreDocumentSnapshot(RawChange.document());
+	}
+}
+
+FFirestoreQuerySnapshotDiff::FFirestoreQuerySnapshotDiff(const firebase::firestore::QuerySnapshot& InSnapshot,
+	const std::vector<firebase::firestore::DocumentSnapshot>& PreviousDocuments)
+	: Snapshot(MakeUnique<firebase::firestore::QuerySnapshot>(InSnapshot))
+{
+	const std::vector<firebase::firestore::DocumentSnapshot> NewDocuments = InSnapshot.documents();
+
+	std::unordered_map<std::string, std::size_t> NewIndices;
+	std::unordered_map<std::string, std::size_t> OldIndices;
+
+	for (std::size_t i = 0; i < NewDocuments.size(); ++i)
+	{
+		NewIndices.emplace(NewDocuments[i].reference().path(), i);
+	}
+
+	// Paths of the results as the changes are applied.
+	std::vector<std::string> Paths;
+	Paths.reserve(FMath::Max(PreviousDocuments.size(), NewDocuments.size()));
+
+	for (std::size_t i = 0; i < PreviousDocuments.size(); ++i)
+	{
+		Paths.push_back(PreviousDocuments[i].reference().path());
+		OldIndices.emplace(Paths.back(), i);
+	}
+
+	// Removals come first, from the last one so the indices of the ones before don't move.
+	for (std::size_t i = PreviousDocuments.size(); i-- > 0;)
+	{
+		if (NewIndices.find(Paths[i]) == NewIndices.end())
+		{
+			Changes.Add(MakeChange(EDocumentChangeType::Removed, (int32)i, INDEX_NONE, PreviousDocuments[i]));
+			Paths.erase(Paths.begin() + i);
+		}
+	}
+
+	// Then the new results in order: once a document is handled, the results before it are the new ones.
+	for (std::size_t i = 0; i < NewDocuments.size(); ++i)
+	{
+		const firebase::firestore::DocumentSnapshot& Document = NewDocuments[i];
+		const std::string Path = Document.reference().path();
+
+		const auto OldIndex = OldIndices.find(Path);
+
+		if (OldIndex == OldIndices.end())
+		{
+			Changes.Add(MakeChange(EDocumentChangeType::Added, INDEX_NONE, (int32)i, Document));
+			Paths.insert(Paths.begin() + i, Path);
+		}
+		else if (i < Paths.size() && Paths[i] == Path)
+		{
+			if (!(Document == PreviousDocuments[OldIndex->second]))
+			{
+				Changes.Add(MakeChange(EDocumentChangeType::Modified, (int32)i, (int32)i, Document));
+			}
+		}
+		else
+		{
+			// Moved, which only happens when the ordered fields were modified.
+			const std::size_t CurrentIndex = std::find(Paths.begin() + i, Paths.end(), Path) - Paths.begin();
+
+			Paths.erase(Paths.begin() + CurrentIndex);
+			Paths.insert(Paths.begin() + i, Path);
+
+			Changes.Add(MakeChange(EDocumentChangeType::Modified, (int32)CurrentIndex, (int32)i, Document));
+		}
+	}
+}
+#endif // WITH_FIREBASE_FIRESTORE
+
+int32 FFirestoreQuerySnapshotDiff::Num() const
+{
+#if WITH_FIREBASE_FIRESTORE
+	if (Snapshot)
+	{
+		return (int32)Snapshot->size();
+	}
+#endif
+	return 0;
+}
+
+FFirestoreSnapshotMetadata FFirestoreQuerySnapshotDiff::GetMetadata() const
+{
+	FFirestoreSnapshotMetadata Metadata;
+#if WITH_FIREBASE_FIRESTORE
+	if (Snapshot)
+	{
+		const auto& RawMetadata = Snapshot->metadata();
+
+		Metadata.bHasPendingWrites = RawMetadata.has_pending_writes();
+		Metadata.bIsFromCache      = RawMetadata.is_from_cache();
+	}
+#endif
+	return Metadata;
+}
+
+const TArray<FFirestoreDocumentSnapshot>& FFirestoreQuerySnapshotDiff::GetDocuments() const
+{
+	if (!Documents)
+	{
+		Documents.Emplace();
+
+#if WITH_FIREBASE_FIRESTORE
+		if (Snapshot)
+		{
+			const std::vector<firebase::firestore::DocumentSnapshot> RawDocuments = Snapshot->documents();
+
+			Documents->Reserve(RawDocuments.size());
+
+			for (const firebase::firestore::DocumentSnapshot& Document : RawDocuments)
+			{
+				Documents->Emplace(FFirestoreDocumentSnapshot(Document));
+			}
+		}
+#endif
+	}
+
+	return *Documents;
+}
@@ -0,0 +1,386 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/ShardedCounter.h"
+#include "Firestore/CollectionReference.h"
+#include "Firestore/DocumentReference.h"
+#include "Firestore/FirestoreSnapshotPoller.h"
+#include "Firestore/QuerySnapshotDiff.h"
+#include "Firestore/TransactionRunner.h"
+
+#include "Async/Async.h"
+#include "Misc/Guid.h"
+
+struct FFirestoreShardedCounter::FReshard
+{
+	int32 NumRemaining = 0;
+
+	EFirestoreError FirstError = EFirestoreError::Ok;
+
+	FFirestoreCallback Callback;
+
+	/**
+	 * References used by the transactions, kept alive until they all complete as the update
+	 * functions run on the SDK's threads. Released on the game thread.
+	 */
+	TArray<TStrongObjectPtr<UFirestoreDocumentReference>> References;
+};
+
+TSharedRef<FFirestoreShardedCounter, ESPMode::ThreadSafe> FFirestoreShardedCounter::Create(UFirestoreCollectionReference* const Shards,
+	const FFirestoreShardedCounterSettings& Settings)
+{
+	check(IsInGameThread());
+	check(Shards);
+
+	const TSharedRef<FFirestoreShardedCounter, ESPMode::ThreadSafe> Counter = MakeShareable(new FFirestoreShardedCounter(Shards, Settings));
+
+	Counter->StartListening();
+
+	return Counter;
+}
+
+FFirestoreShardedCounter::FFirestoreShardedCounter(UFirestoreCollectionReference* const InCollection, const FFirestoreShardedCounterSettings& InSettings)
+	: Settings(InSettings)
+	, Collection(InCollection)
+	, PendingSum(0)
+	, InFlightSum(0)
+	, NextFlushId(0)
+	, ShardSum(0)
+	, bHasValue(false)
+	, ClientKey(GetTypeHash(FGuid::NewGuid()))
+{
+	const int32 NumShards = FMath::Max(Settings.NumShards, 1);
+
+	for (int32 i = 0; i < NumShards; ++i)
+	{
+		AddShard();
+	}
+}
+
+FFirestoreShardedCounter::~FFirestoreShardedCounter()
+{
+	Listener.Remove();
+
+	// The increments must not be lost with the counter.
+	CommitPending(FFirestoreCallback(), false);
+}
+
+void FFirestoreShardedCounter::StartListening()
+{
+	Listener = Collection->AddSnapshotDiffListener(FQuerySnapshotDiffListenerCallback::CreateSP(this, &FFirestoreShardedCounter::HandleSnapshot));
+}
+
+void FFirestoreShardedCounter::HandleSnapshot(const EFirestoreError Error, const FFirestoreQuerySnapshotDiff& Diff)
+{
+	if (Error != EFirestoreError::Ok)
+	{
+		UE_LOG(LogFirestore, Warning, TEXT("Sharded counter %s failed to read its shards. Code: %d."), *Collection->GetPath(), Error);
+		return;
+	}
+
+	for (const FFirestoreDocumentDiff& Change : Diff.GetChanges())
+	{
+		if (Change.Type == EDocumentChangeType::Removed)
+		{
+			ShardValues.Remove(Change.Document.GetId());
+			ReleaseShard(Change.Document.GetId(), false);
+		}
+		else
+		{
+			const FString ShardId = Change.Document.GetId();
+
+			ShardValues.Add(ShardId, Change.Document.Get(Settings.Field).ToInt64());
+
+			ReleaseShard(ShardId, Change.Document.GetMetadata().bHasPendingWrites);
+		}
+	}
+
+	ShardSum = 0;
+
+	for (const TPair<FString, int64>& ShardValue : ShardValues)
+	{
+		ShardSum += ShardValue.Value;
+	}
+
+	bHasValue = true;
+
+	OnValueChanged.ExecuteIfBound(GetValue());
+}
+
+void FFirestoreShardedCounter::ReleaseShard(const FString& ShardId, const bool bHasPendingWrites)
+{
+	for (int32 i = 0; i < InFlightFlushes.Num(); ++i)
+	{
+		FInFlightFlush& InFlight = InFlightFlushes[i];
+
+		// Local writes are reported with pending writes before being committed. Each one is
+		// matched with the oldest flush waiting for that shard as the writes to a shard are
+		// applied in order. A snapshot without pending writes delivered after flushes were
+		// committed includes their increments. A poll started before the commit may not,
+		// but it then reports another change and the shard is polled again shortly.
+		if (bHasPendingWrites == InFlight.bCommitted)
+		{
+			continue;
+		}
+
+		if (const int64* const Increment = InFlight.WaitingShards.Find(ShardId))
+		{
+			InFlightSum -= *Increment;
+			InFlight.WaitingShards.Remove(ShardId);
+
+			if (InFlight.WaitingShards.Num() == 0)
+			{
+				InFlightFlushes.RemoveAt(i--);
+			}
+
+			if (bHasPendingWrites)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void FFirestoreShardedCounter::Increment(const int64 ByValue)
+{
+	AddIncrement(ClientKey % (uint32)Shards.Num(), ByValue);
+}
+
+void FFirestoreShardedCounter::Increment(const int64 ByValue, const FString& Key)
+{
+	AddIncrement(GetTypeHash(Key) % (uint32)Shards.Num(), ByValue);
+}
+
+void FFirestoreShardedCounter::AddShard()
+{
+	Shards.Emplace(Collection->GetDocumentFromPath(FString::FromInt(Shards.Num())));
+	PendingIncrements.Add(0);
+}
+
+void FFirestoreShardedCounter::AddIncrement(const int32 Shard, const int64 ByValue)
+{
+	check(IsInGameThread());
+
+	PendingIncrements[Shard] += ByValue;
+	PendingSum += ByValue;
+
+	if (!FlushHandle.IsValid())
+	{
+		FlushHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateSP(this, &FFirestoreShardedCounter::HandleFlushTick), FMath::Max(Settings.FlushInterval, 0.f));
+	}
+
+	OnValueChanged.ExecuteIfBound(GetValue());
+}
+
+bool FFirestoreShardedCounter::HandleFlushTick(float DeltaTime)
+{
+	FlushHandle.Reset();
+
+	Flush();
+
+	return false;
+}
+
+void FFirestoreShardedCounter::Flush(const FFirestoreCallback& Callback)
+{
+	CommitPending(Callback, true);
+}
+
+void FFirestoreShardedCounter::CommitPending(const FFirestoreCallback& Callback, const bool bTrack)
+{
+	check(IsInGameThread());
+
+	if (FlushHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+		FlushHandle.Reset();
+	}
+
+	FWriteBatch Batch = UFirestore::Batch();
+	FInFlightFlush InFlight;
+
+	for (int32 i = 0; i < Shards.Num(); ++i)
+	{
+		if (PendingIncrements[i] != 0)
+		{
+			// Merged so the shard is created by its first increment.
+			Batch.Set(Shards[i].Get(), { { Settings.Field, FFirestoreFieldValue::Increment(PendingIncrements[i]) } }, FFirestoreSetOptions::Merge());
+
+			InFlight.WaitingShards.Add(FString::FromInt(i), PendingIncrements[i]);
+			PendingIncrements[i] = 0;
+		}
+	}
+
+	if (InFlight.WaitingShards.Num() == 0)
+	{
+		if (Callback.IsBound())
+		{
+			AsyncTask(ENamedThreads::GameThread, [Callback]() -> void
+			{
+				Callback.ExecuteIfBound(EFirestoreError::Ok);
+			});
+		}
+		return;
+	}
+
+	if (!bTrack)
+	{
+		PendingSum = 0;
+		Batch.Commit(Callback);
+		return;
+	}
+
+	// The increments are still counted until the shard values include them, so the value
+	// doesn't drop between the flush and the snapshot reporting it.
+	const uint32 FlushId = NextFlushId++;
+
+	InFlight.Id = FlushId;
+	InFlightFlushes.Add(MoveTemp(InFlight));
+
+	InFlightSum += PendingSum;
+	PendingSum   = 0;
+
+	Batch.Commit(FFirestoreCallback::CreateLambda([WeakCounter = TWeakPtr<FFirestoreShardedCounter, ESPMode::ThreadSafe>(AsShared()), FlushId, Callback]
+		(const EFirestoreError Error) -> void
+	{
+		if (const TSharedPtr<FFirestoreShardedCounter, ESPMode::ThreadSafe> Counter = WeakCounter.Pin())
+		{
+			Counter->CompleteFlush(FlushId, Error == EFirestoreError::Ok);
+		}
+
+		Callback.ExecuteIfBound(Error);
+	}));
+}
+
+void FFirestoreShardedCounter::CompleteFlush(const uint32 FlushId, const bool bCommitted)
+{
+	const int32 Index = InFlightFlushes.IndexOfByPredicate([FlushId](const FInFlightFlush& InFlight) -> bool
+	{
+		return InFlight.Id == FlushId;
+	});
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+#if !WITH_FIRESTORE_NATIVE_SNAPSHOT_LISTENERS
+	// Polled snapshots are read from the server and never have pending writes: the increments
+	// are counted until a snapshot read after the commit reports their shards.
+	if (bCommitted)
+	{
+		InFlightFlushes[Index].bCommitted = true;
+		return;
+	}
+#endif
+
+	// Either the write was rejected and won't be in the shard values, or it was committed
+	// after being reported with pending writes, which the listener might have merged with
+	// another write's snapshot.
+	for (const TPair<FString, int64>& Shard : InFlightFlushes[Index].WaitingShards)
+	{
+		InFlightSum -= Shard.Value;
+	}
+
+	InFlightFlushes.RemoveAt(Index);
+
+	OnValueChanged.ExecuteIfBound(GetValue());
+}
+
+int64 FFirestoreShardedCounter::GetValue() const
+{
+	return ShardSum + InFlightSum + PendingSum;
+}
+
+void FFirestoreShardedCounter::Reshard(const int32 NumShards, const FFirestoreCallback& Callback)
+{
+	check(IsInGameThread());
+
+	const int32 NewNumShards = FMath::Max(NumShards, 1);
+	const int32 OldNumShards = Shards.Num();
+
+	while (Shards.Num() < NewNumShards)
+	{
+		AddShard();
+	}
+
+	if (NewNumShards >= OldNumShards)
+	{
+		// Nothing to move: the new shards get the increments that follow.
+		if (Callback.IsBound())
+		{
+			AsyncTask(ENamedThreads::GameThread, [Callback]() -> void
+			{
+				Callback.ExecuteIfBound(EFirestoreError::Ok);
+			});
+		}
+		return;
+	}
+
+	const TSharedRef<FReshard, ESPMode::ThreadSafe> State = MakeShared<FReshard, ESPMode::ThreadSafe>();
+
+	State->NumRemaining = OldNumShards - NewNumShards;
+	State->Callback     = Callback;
+
+	// Increments not written yet go directly to the shard taking over.
+	for (int32 Shard = NewNumShards; Shard < OldNumShards; ++Shard)
+	{
+		PendingIncrements[Shard % NewNumShards] += PendingIncrements[Shard];
+	}
+
+	Shards.SetNum(NewNumShards);
+	PendingIncrements.SetNum(NewNumShards);
+
+	for (int32 Shard = NewNumShards; Shard < OldNumShards; ++Shard)
+	{
+		MoveShard(Shard, State);
+	}
+}
+
+void FFirestoreShardedCounter::MoveShard(const int32 Shard, const TSharedRef<FReshard, ESPMode::ThreadSafe>& Reshard)
+{
+	UFirestoreDocumentReference* const From = Collection->GetDocumentFromPath(FString::FromInt(Shard));
+	UFirestoreDocumentReference* const To   = Shards[Shard % Shards.Num()].Get();
+
+	Reshard->References.Emplace(From);
+	Reshard->References.Emplace(To);
+
+	FFirestoreTransactionRunner::Run({ From },
+		FFirestoreTransactionUpdateFunction::CreateLambda([From, To, Field = Settings.Field](const TArray<FFirestoreDocumentSnapshot>& Snapshots,
+			FFirestoreTransaction& Transaction, FString& ErrorMessage) -> EFirestoreError
+	{
+		if (!Snapshots[0].Exists())
+		{
+			return EFirestoreError::Ok;
+		}
+
+		const int64 Value = Snapshots[0].Get(Field).ToInt64();
+
+		Transaction.Delete(From);
+
+		if (Value != 0)
+		{
+			Transaction.Set(To, { { Field, FFirestoreFieldValue::Increment(Value) } }, FFirestoreSetOptions::Merge());
+		}
+
+		return EFirestoreError::Ok;
+	}),
+		FFirestoreTransactionRunnerCallback::CreateLambda([From, Reshard](const EFirestoreError Error, const int32) -> void
+	{
+		if (Error != EFirestoreError::Ok)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Failed to move sharded counter shard %s. Code: %d."), *From->GetPath(), Error);
+
+			if (Reshard->FirstError == EFirestoreError::Ok)
+			{
+				Reshard->FirstError = Error;
+			}
+		}
+
+		if (--Reshard->NumRemaining == 0)
+		{
+			Reshard->References.Empty();
+			Reshard->Callback.ExecuteIfBound(Reshard->FirstError);
+		}
+	}));
+}
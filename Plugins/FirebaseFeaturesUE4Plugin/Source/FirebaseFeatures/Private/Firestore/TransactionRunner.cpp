@@ -0,0 +1,307 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Firestore/TransactionRunner.h"
+#include "Firestore/DocumentReference.h"
+#include "FirebaseSdk/CaseSensitiveKeyFuncs.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/future.h"
+#	include "firebase/firestore.h"
+#	include "firebase/firestore/transaction.h"
+#	include "firebase/firestore/document_reference.h"
+THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+#include <vector>
+
+struct FFirestoreTransactionRunner::FRun
+{
+#if WITH_FIREBASE_FIRESTORE
+	/** Copies of the references, as the UObjects can be collected while an attempt runs. */
+	std::vector<firebase::firestore::DocumentReference> Reads;
+#endif // WITH_FIREBASE_FIRESTORE
+
+	TArray<FString> Paths;
+
+	FFirestoreTransactionUpdateFunction Update;
+	FFirestoreTransactionRunnerCallback Callback;
+	FFirestoreTransactionRunnerSettings Settings;
+
+	int32 NumAttempts = 0;
+
+	/** Times the SDK called the update function during the current attempt. */
+	std::atomic<int32> NumCalls { 0 };
+
+	/** If the last call of the update function returned an error, which the attempt failed with. */
+	std::atomic<bool> bUpdateFailed { false };
+};
+
+namespace
+{
+	// Weight of the latest attempt in the conflict rate.
+	constexpr float ConflictRateWeight = 0.2f;
+
+	// Documents above this conflict rate delay the first attempt of their transactions.
+	constexpr float HotConflictRate = 0.25f;
+
+	/** If the transaction can succeed when run again later. */
+	bool IsRetryableError(const EFirestoreError Error)
+	{
+		switch (Error)
+		{
+		case EFirestoreError::DeadlineExceeded:
+		case EFirestoreError::ResourceExhausted:
+		case EFirestoreError::FailedPrecondition:
+		case EFirestoreError::Aborted:
+		case EFirestoreError::Unavailable:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	/** If the transaction failed because a document it read was modified. */
+	bool IsConflictError(const EFirestoreError Error)
+	{
+		return Error == EFirestoreError::Aborted || Error == EFirestoreError::FailedPrecondition;
+	}
+
+	class FContentionRegistry
+	{
+	public:
+		static FContentionRegistry& Get()
+		{
+			// Never destroyed: attempts can complete during exit.
+			static FContentionRegistry* const Instance = new FContentionRegistry();
+			return *Instance;
+		}
+
+		void Record(const TArray<FString>& Paths, const int32 NumAttempts, const int32 NumConflicts)
+		{
+			FScopeLock Lock(&Section);
+
+			for (const FString& Path : Paths)
+			{
+				FFirestoreContentionStats& Stats = StatsByPath.FindOrAdd(Path);
+
+				Stats.NumAttempts  += NumAttempts;
+				Stats.NumConflicts += NumConflicts;
+
+				for (int32 i = 0; i < NumAttempts; ++i)
+				{
+					const float Conflict = i < NumConflicts ? 1.f : 0.f;
+					Stats.ConflictRate = FMath::Lerp(Stats.ConflictRate, Conflict, ConflictRateWeight);
+				}
+			}
+		}
+
+		FFirestoreContentionStats Find(const FString& Path) const
+		{
+			FScopeLock Lock(&Section);
+
+			const FFirestoreContentionStats* const Stats = StatsByPath.Find(Path);
+			return Stats ? *Stats : FFirestoreContentionStats();
+		}
+
+		float GetMaxConflictRate(const TArray<FString>& Paths) const
+		{
+			FScopeLock Lock(&Section);
+
+			float MaxRate = 0.f;
+
+			for (const FString& Path : Paths)
+			{
+				if (const FFirestoreContentionStats* const Stats = StatsByPath.Find(Path))
+				{
+					MaxRate = FMath::Max(MaxRate, Stats->ConflictRate);
+				}
+			}
+
+			return MaxRate;
+		}
+
+		void Empty()
+		{
+			FScopeLock Lock(&Section);
+			StatsByPath.Empty();
+		}
+
+	private:
+		mutable FCriticalSection Section;
+		// Firestore paths are case-sensitive.
+		TCaseSensitiveMap<FFirestoreContentionStats> StatsByPath;
+	};
+}
+
+void FFirestoreTransactionRunner::Run(const TArray<UFirestoreDocumentReference*>& Reads, FFirestoreTransactionUpdateFunction Update,
+	FFirestoreTransactionRunnerCallback Callback, const FFirestoreTransactionRunnerSettings& Settings)
+{
+	check(IsInGameThread());
+
+	const FRunRef Run = MakeShared<FRun, ESPMode::ThreadSafe>();
+
+	Run->Update   = MoveTemp(Update);
+	Run->Callback = MoveTemp(Callback);
+	Run->Settings = Settings;
+
+#if WITH_FIREBASE_FIRESTORE
+	Run->Reads.reserve(Reads.Num());
+#endif // WITH_FIREBASE_FIRESTORE
+	Run->Paths.Reserve(Reads.Num());
+
+	for (UFirestoreDocumentReference* const Read : Reads)
+	{
+		if (!Read)
+		{
+			UE_LOG(LogFirestore, Error, TEXT("Transaction runner was given an invalid document reference."));
+
+			AsyncTask(ENamedThreads::GameThread, [Run]() -> void
+			{
+				Run->Callback.ExecuteIfBound(EFirestoreError::InvalidArgument, 0);
+			});
+			return;
+		}
+
+#if WITH_FIREBASE_FIRESTORE
+		Run->Reads.push_back(*Read->GetInternal());
+#endif // WITH_FIREBASE_FIRESTORE
+		Run->Paths.Add(Read->GetPath());
+	}
+
+	// Transactions on hot documents start at a random time so a burst of them doesn't
+	// collide on the first attempt.
+	const float ConflictRate = FContentionRegistry::Get().GetMaxConflictRate(Run->Paths);
+
+	if (ConflictRate > HotConflictRate)
+	{
+		ScheduleAttempt(Run, FMath::FRandRange(0.f, GetBackoff(*Run)));
+	}
+	else
+	{
+		Attempt(Run);
+	}
+}
+
+FFirestoreContentionStats FFirestoreTransactionRunner::GetContentionStats(const FString& DocumentPath)
+{
+	return FContentionRegistry::Get().Find(DocumentPath);
+}
+
+void FFirestoreTransactionRunner::ResetContentionStats()
+{
+	FContentionRegistry::Get().Empty();
+}
+
+void FFirestoreTransactionRunner::Attempt(const FRunRef& Run)
+{
+	++Run->NumAttempts;
+	Run->NumCalls = 0;
+	Run->bUpdateFailed = false;
+
+#if WITH_FIREBASE_FIRESTORE
+	UFirestore::GetFirestore()->RunTransaction([Run](firebase::firestore::Transaction& RawTransaction, std::string& RawErrorMessage) -> firebase::firestore::Error
+	{
+		++Run->NumCalls;
+		Run->bUpdateFailed = false;
+
+		// All the reads are made before the update function so the documents are read
+		// as late as possible and the commit follows right after.
+		TArray<FFirestoreDocumentSnapshot> Snapshots;
+		Snapshots.Reserve(Run->Reads.size());
+
+		for (const firebase::firestore::DocumentReference& Read : Run->Reads)
+		{
+			firebase::firestore::Error Error = firebase::firestore::Error::kErrorOk;
+
+			firebase::firestore::DocumentSnapshot Snapshot = RawTransaction.Get(Read, &Error, &RawErrorMessage);
+
+			if (Error != firebase::firestore::Error::kErrorOk)
+			{
+				return Error;
+			}
+
+			Snapshots.Emplace(FFirestoreDocumentSnapshot(Snapshot));
+		}
+
+		FFirestoreTransaction Transaction(&RawTransaction);
+		FString ErrorMessage;
+
+		const EFirestoreError Error = Run->Update.IsBound() ?
+			Run->Update.Execute(Snapshots, Transaction, ErrorMessage) :
+			EFirestoreError::Ok;
+
+		RawErrorMessage = TCHAR_TO_UTF8(*ErrorMessage);
+		Run->bUpdateFailed = Error != EFirestoreError::Ok;
+
+		return (firebase::firestore::Error)Error;
+	}).OnCompletion([Run](const firebase::Future<void>& Future) -> void
+	{
+		const EFirestoreError Error = (EFirestoreError)Future.error();
+		const bool bUpdateFailed = Error != EFirestoreError::Ok && Run->bUpdateFailed.load();
+
+		// The SDK retries the update function itself when a read document was modified:
+		// each extra call is a conflict, and so is a failure with a conflict error, unless
+		// the update function returned it.
+		const int32 NumCalls     = FMath::Max(Run->NumCalls.load(), 1);
+		const int32 NumConflicts = NumCalls - 1 + (IsConflictError(Error) && !bUpdateFailed ? 1 : 0);
+
+		FContentionRegistry::Get().Record(Run->Paths, NumCalls, NumConflicts);
+
+		if (Error != EFirestoreError::Ok)
+		{
+			UE_LOG(LogFirestore, Warning, TEXT("Failed to run transaction (attempt %d). Code: %d. Message: %s"),
+				Run->NumAttempts, Error, UTF8_TO_TCHAR(Future.error_message()));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Run, Error, bUpdateFailed]() -> void
+		{
+			HandleAttempt(Run, Error, bUpdateFailed);
+		});
+	});
+#else
+	AsyncTask(ENamedThreads::GameThread, [Run]() -> void
+	{
+		HandleAttempt(Run, EFirestoreError::Unimplemented, false);
+	});
+#endif // WITH_FIREBASE_FIRESTORE
+}
+
+void FFirestoreTransactionRunner::HandleAttempt(const FRunRef& Run, const EFirestoreError Error, const bool bUpdateFailed)
+{
+	// Errors of the update function are the transaction's result, e.g. FailedPrecondition
+	// for insufficient funds: running it again would fail the same way.
+	if (Error != EFirestoreError::Ok && !bUpdateFailed && IsRetryableError(Error) && Run->NumAttempts < Run->Settings.MaxAttempts)
+	{
+		// Full jitter: concurrent clients failing together spread over the whole delay.
+		ScheduleAttempt(Run, FMath::FRandRange(0.f, GetBackoff(*Run)));
+		return;
+	}
+
+	Run->Callback.ExecuteIfBound(Error, Run->NumAttempts);
+}
+
+void FFirestoreTransactionRunner::ScheduleAttempt(const FRunRef& Run, const float Delay)
+{
+	FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Run](float) -> bool
+	{
+		Attempt(Run);
+		return false;
+	}), Delay);
+}
+
+float FFirestoreTransactionRunner::GetBackoff(const FRun& Run)
+{
+	const FFirestoreTransactionRunnerSettings& Settings = Run.Settings;
+
+	const float ConflictRate = FContentionRegistry::Get().GetMaxConflictRate(Run.Paths);
+	const float Exponential  = Settings.InitialBackoff * FMath::Pow(2.f, (float)FMath::Max(Run.NumAttempts - 1, 0));
+
+	return FMath::Min(Exponential * (1.f + Settings.ContentionScale * ConflictRate), Settings.MaxBackoff);
+}
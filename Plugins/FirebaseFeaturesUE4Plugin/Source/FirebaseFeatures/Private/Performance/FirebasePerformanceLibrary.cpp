@@ -1,7 +1,13 @@
 // Copyright Pandores Marketplace 2022. All Rights Reserved.
 
 #include "Performance/FirebasePerformanceLibrary.h"
+#include "Performance/FirebaseScopedTrace.h"
+#include "Performance/FirebaseTracePool.h"
+#include "Performance/FirebaseTraceSink.h"
 #include "FirebaseFeatures.h"
+#include "FirebaseSdk/CaseSensitiveKeyFuncs.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
 
 #if WITH_FIREBASE_PERFORMANCE
 #	if PLATFORM_IOS
@@ -16,12 +22,39 @@
 
 #if WITH_FIREBASE_PERFORMANCE && PLATFORM_ANDROID
 static jclass GjGameActivityClass = nullptr;
+static jclass GjStringClass		  = nullptr;
+
+// The JNIEnv is bound to the calling thread and stays valid until the thread exits
+// so we only look it up once per thread.
+static JNIEnv* GetPerformanceJavaEnv()
+{
+	static thread_local JNIEnv* CachedEnv = nullptr;
+
+	if (!CachedEnv)
+	{
+		CachedEnv = AndroidJavaEnv::GetJavaEnv();
+	}
+
+	return CachedEnv;
+}
+
+// Metrics are flushed from worker threads while the game thread creates traces: the first
+// calls can race to initialize the classes.
+static FCriticalSection GInitializationLock;
+static TAtomic<bool> GInitialized(false);
 
 void InitializeFirebasePerformance()
 {
+	if (GInitialized.Load())
+	{
+		return;
+	}
+
+	FScopeLock Lock(&GInitializationLock);
+
 	if (!GjGameActivityClass)
 	{
-		JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();
+		JNIEnv* const Env = GetPerformanceJavaEnv();
 
 		check(Env);
 
@@ -30,20 +63,34 @@ void InitializeFirebasePerformance()
 
 		GjGameActivityClass = (jclass)Env->NewGlobalRef((jobject)jActivityClass);
 		Env->DeleteLocalRef(jActivityClass);
+
+		jclass jStringClass = Env->FindClass("java/lang/String");
+		check(jStringClass);
+
+		GjStringClass = (jclass)Env->NewGlobalRef((jobject)jStringClass);
+		Env->DeleteLocalRef(jStringClass);
+
+		GInitialized.Store(true);
 	}
 }
 
 void TerminateFirebasePerformance()
 {
+	FScopeLock Lock(&GInitializationLock);
+
+	GInitialized.Store(false);
+
 	if (GjGameActivityClass)
 	{
-		JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();
+		JNIEnv* const Env = GetPerformanceJavaEnv();
 
 		check(Env);
 
 		Env->DeleteGlobalRef((jobject)GjGameActivityClass);
+		Env->DeleteGlobalRef((jobject)GjStringClass);
 
 		GjGameActivityClass = nullptr;
+		GjStringClass		= nullptr;
 	}
 }
 
@@ -55,7 +102,7 @@ void TerminateFirebasePerformance()
 			InitializeFirebasePerformance();																				\
 		}																													\
 																															\
-		JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();																	\
+		JNIEnv* const Env = GetPerformanceJavaEnv();																		\
 																															\
 		check(Env);																											\
 																															\
@@ -72,212 +119,743 @@ void TerminateFirebasePerformance()
 	} while(0)
 #endif
 
+namespace FirebasePerformance
+{
+	// Registered metrics are never released so handles stay valid for the whole process.
+	static constexpr int32 MaxRegisteredMetrics = 1024;
 
+	struct FRegisteredMetric
+	{
+		FString Name;
 #if WITH_FIREBASE_PERFORMANCE
-#if PLATFORM_IOS 
-FFirebaseTrace::FFirebaseTrace(FIRTrace* Native)
-	: Trace([Native retain])
-{
+#	if PLATFORM_IOS
+		NSString* NativeName = nil;
+#	elif PLATFORM_ANDROID
+		jstring NativeName = nullptr;
+#	endif
+#endif
+	};
+
+	static FRegisteredMetric GRegisteredMetrics[MaxRegisteredMetrics];
+
+	// Entries below this count are immutable and can be read without locking.
+	static TAtomic<int32> GRegisteredMetricCount(0);
+
+	static FCriticalSection GRegistrationLock;
+
+	// Firebase metric names are case-sensitive: "hits" and "Hits" are two metrics.
+	static TCaseSensitiveMap<int32> GRegisteredMetricIndices;
+
+	static FCriticalSection GInvalidMetricsLock;
+	static TSet<int32> GLoggedInvalidMetrics;
+
+	static const FRegisteredMetric* FindRegisteredMetric(const FFirebaseMetricHandle Metric)
+	{
+		if (Metric.IsValid() && Metric.GetIndex() < GRegisteredMetricCount.Load())
+		{
+			return &GRegisteredMetrics[Metric.GetIndex()];
+		}
+
+		// Metrics are set every frame: logged once per handle so a bad handle doesn't flood the log.
+		{
+			FScopeLock Lock(&GInvalidMetricsLock);
+
+			bool bAlreadyLogged = false;
+			GLoggedInvalidMetrics.Add(Metric.GetIndex(), &bAlreadyLogged);
+
+			if (!bAlreadyLogged)
+			{
+				UE_LOG(LogFirebasePerformance, Warning, TEXT("Invalid metric handle %d. Its values are ignored."), Metric.GetIndex());
+			}
+		}
+
+		return nullptr;
+	}
+
+	static FRWLock GTraceSinksLock;
+	static TArray<FFirebaseTraceSinkRef> GTraceSinks;
+
+	// Lets traces skip the lock when no sink is registered, which is the common case.
+	static TAtomic<int32> GTraceSinkCount(0);
+
+	static TAtomic<uint64> GNextTraceId(1);
+
+	template<typename FunctorType>
+	static void ForEachTraceSink(FunctorType&& Functor)
+	{
+		if (GTraceSinkCount.Load(EMemoryOrder::Relaxed) == 0)
+		{
+			return;
+		}
+
+		FReadScopeLock Lock(GTraceSinksLock);
+
+		for (const FFirebaseTraceSinkRef& Sink : GTraceSinks)
+		{
+			Functor(*Sink);
+		}
+	}
+
+#if WITH_FIREBASE_PERFORMANCE && PLATFORM_ANDROID
+	static int32 CountRegisteredMetrics(TArrayView<const FFirebaseMetricHandle> MetricHandles)
+	{
+		int32 NumRegistered = 0;
+
+		for (const FFirebaseMetricHandle& Metric : MetricHandles)
+		{
+			if (FindRegisteredMetric(Metric))
+			{
+				++NumRegistered;
+			}
+		}
+
+		return NumRegistered;
+	}
+
+	// Registered names are global refs so only the two arrays are allocated per batch.
+	// The caller owns the arrays' local refs as batches are typically sent from native
+	// threads that never return to Java.
+	// The arrays are sized with CountRegisteredMetrics(): invalid handles are skipped, like
+	// on the other platforms, and the valid metrics are packed at the start.
+	static void FillJavaMetricArrays(JNIEnv* const Env, TArrayView<const FFirebaseMetricHandle> MetricHandles,
+		TArrayView<const int64> Values, const int32 NumRegistered, jobjectArray jNames, jlongArray jValues)
+	{
+		static_assert(sizeof(jlong) == sizeof(int64), "jlong and int64 must have the same size.");
+
+		if (NumRegistered == MetricHandles.Num())
+		{
+			for (int32 i = 0; i < MetricHandles.Num(); ++i)
+			{
+				Env->SetObjectArrayElement(jNames, i, GRegisteredMetrics[MetricHandles[i].GetIndex()].NativeName);
+			}
+
+			Env->SetLongArrayRegion(jValues, 0, Values.Num(), (const jlong*)Values.GetData());
+			return;
+		}
+
+		int32 Packed = 0;
+
+		for (int32 i = 0; i < MetricHandles.Num() && Packed < NumRegistered; ++i)
+		{
+			if (const FRegisteredMetric* const Registered = FindRegisteredMetric(MetricHandles[i]))
+			{
+				Env->SetObjectArrayElement(jNames, Packed, Registered->NativeName);
+				Env->SetLongArrayRegion(jValues, Packed, 1, (const jlong*)&Values[i]);
+
+				++Packed;
+			}
+		}
+	}
+#endif
 }
 
-#elif PLATFORM_ANDROID
-FFirebaseTrace::FFirebaseTrace(jobject Native)
+
+/**
+ * Owns the platform's trace object. Shared between the copies of an FFirebaseTrace
+ * so copying a trace never creates a JNI global reference or retains the object.
+ */
+class FFirebaseNativeTrace
 {
-	JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();
+public:
+#if WITH_FIREBASE_PERFORMANCE
+#if PLATFORM_IOS
+	explicit FFirebaseNativeTrace(FIRTrace* InTrace)
+		: Trace([InTrace retain])
+	{
+	}
 
-	check(Env);
+	~FFirebaseNativeTrace()
+	{
+		[Trace release], Trace = nil;
+	}
 
-	Trace = Env->NewGlobalRef(Native);
+	FIRTrace* Trace;
+#elif PLATFORM_ANDROID
+	explicit FFirebaseNativeTrace(jobject InTrace)
+	{
+		JNIEnv* const Env = GetPerformanceJavaEnv();
 
-	Env->DeleteLocalRef(Native);
+		check(Env);
+
+		Trace = Env->NewGlobalRef(InTrace);
+
+		Env->DeleteLocalRef(InTrace);
+	}
+
+	~FFirebaseNativeTrace()
+	{
+		JNIEnv* const Env = GetPerformanceJavaEnv();
+
+		check(Env);
+
+		Env->DeleteGlobalRef(Trace);
+		Trace = nullptr;
+	}
+
+	jobject Trace;
+#else
+	explicit FFirebaseNativeTrace(FString InName)
+		: Id(FirebasePerformance::GNextTraceId.IncrementExchange())
+		, Name(MoveTemp(InName))
+	{
+	}
+
+	// Identifies the trace in the sinks' events.
+	const uint64 Id;
+
+	FString Name;
+	// Metric names are case-sensitive on the mobile SDKs this emulates.
+	TCaseSensitiveMap<int64> Metrics;
+#endif
+#endif
+};
+
+#if WITH_FIREBASE_PERFORMANCE
+#if PLATFORM_IOS 
+FFirebaseTrace::FFirebaseTrace(FIRTrace* InNative)
+{
+	if (InNative != nil)
+	{
+		Native = MakeShared<FFirebaseNativeTrace, ESPMode::ThreadSafe>(InNative);
+	}
+}
+
+#elif PLATFORM_ANDROID
+FFirebaseTrace::FFirebaseTrace(jobject InNative)
+{
+	if (InNative != nullptr)
+	{
+		Native = MakeShared<FFirebaseNativeTrace, ESPMode::ThreadSafe>(InNative);
+	}
 }
 #else
 FFirebaseTrace::FFirebaseTrace(FString InName)
-	: Name(MoveTemp(InName))
+	: Native(MakeShared<FFirebaseNativeTrace, ESPMode::ThreadSafe>(MoveTemp(InName)))
 {
 }
 #endif
 #endif
 
 FFirebaseTrace::FFirebaseTrace()
-#if PLATFORM_IOS
-	: Trace(nil)
-#elif PLATFORM_ANDROID
-	: Trace(nullptr)
-#endif
 {
-
 }
 
 FFirebaseTrace::~FFirebaseTrace()
 {
-#if WITH_FIREBASE_PERFORMANCE
-#if PLATFORM_IOS
-	[Trace release], Trace = nil;
-#elif PLATFORM_ANDROID
-	JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();
-
-	check(Env);
-
-	Env->DeleteGlobalRef(Trace);
-	Trace = nullptr;
-#endif
-#endif
 }
 
 FFirebaseTrace::FFirebaseTrace(const FFirebaseTrace& Other)
+	: Native(Other.Native)
 {
-	*this = Other;
 }
 
 FFirebaseTrace::FFirebaseTrace(FFirebaseTrace&& Other)
+	: Native(MoveTemp(Other.Native))
 {
-	*this = MoveTemp(Other);
 }
 
 FFirebaseTrace& FFirebaseTrace::operator=(FFirebaseTrace&& Other)
+{
+	Native = MoveTemp(Other.Native);
+
+	return *this;
+}
+
+FFirebaseTrace& FFirebaseTrace::operator=(const FFirebaseTrace& Other)
+{
+	Native = Other.Native;
+
+	return *this;
+}
+
+bool FFirebaseTrace::IsValid() const
+{
+	return Native.IsValid();
+}
+
+FString FFirebaseTrace::GetName() const
 {
 #if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return FString();
+	}
+
 #if PLATFORM_IOS
-	Trace = Other.Trace;
-	Other.Trace = nil;
+	return FString([Native->Trace name]);
 #elif PLATFORM_ANDROID
-	Trace = Other.Trace;
-	Other.Trace = nullptr;
+	return TEXT("");
 #else
-	Metrics = MoveTemp(Other.Metrics);
+	return Native->Name;
 #endif
+#else
+	return FString{};
 #endif
-
-	return *this;
 }
 
-FFirebaseTrace& FFirebaseTrace::operator=(const FFirebaseTrace& Other)
+void FFirebaseTrace::Start()
 {
 #if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
 #if PLATFORM_IOS
-	Trace = [Other.Trace retain];
+	[Native->Trace start];
 #elif PLATFORM_ANDROID
-	JNIEnv* const Env = AndroidJavaEnv::GetJavaEnv();
+	CALL_PERFORMANCE("FIR_PR_StartTrace", "(Lcom/google/firebase/perf/metrics/Trace;)V", Void, void(), Native->Trace);
+#else
+	UE_LOG(LogFirebasePerformance, Verbose, TEXT("Started trace %s execution."), *Native->Name);
 
-	check(Env);
+	FirebasePerformance::ForEachTraceSink([this](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnTraceStarted(Native->Id, Native->Name);
+	});
+#endif
+#endif
+}
 
-	Trace = Env->NewGlobalRef(Other.Trace);
+void FFirebaseTrace::Stop()
+{
+#if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
+#if PLATFORM_IOS
+	[Native->Trace stop];
+#elif PLATFORM_ANDROID
+	CALL_PERFORMANCE("FIR_PR_StopTrace", "(Lcom/google/firebase/perf/metrics/Trace;)V", Void, void(), Native->Trace);
 #else
-	Metrics = Other.Metrics;
+	UE_LOG(LogFirebasePerformance, Verbose, TEXT("Stopped trace %s execution."), *Native->Name);
+
+	FirebasePerformance::ForEachTraceSink([this](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnTraceStopped(Native->Id);
+	});
 #endif
 #endif
+}
 
-	return *this;
+void FFirebaseTrace::IncrementMetric(const FString& MetricName, const int64 ByValue)
+{
+#if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
+#if PLATFORM_IOS
+	[Native->Trace incrementMetric: MetricName.GetNSString()
+	                         byInt: ByValue];
+#elif PLATFORM_ANDROID
+	CALL_PERFORMANCE("FIR_PR_IncrementMetric", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;J)V", Void,
+		void(), Native->Trace, *FJavaHelper::ToJavaString(Env, MetricName), (jlong)ByValue);
+#else
+	Native->Metrics.FindOrAdd(MetricName, 0LL) += ByValue;
+
+	FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnMetricIncremented(Native->Id, MetricName, ByValue);
+	});
+#endif
+#endif
 }
 
-FString FFirebaseTrace::GetName() const
+int64 FFirebaseTrace::GetMetricValue(const FString& MetricName) const
 {
 #if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return 0LL;
+	}
+
 #if PLATFORM_IOS
-	return Trace == nil ? TEXT("INVALID_TRACE") : FString([Trace name]);
+	return [Native->Trace valueForIntMetric: MetricName.GetNSString()] ;
 #elif PLATFORM_ANDROID
-	return TEXT("");
+	CALL_PERFORMANCE("FIR_PR_GetMetricValue", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;)J", Long,
+		0LL, Native->Trace, *FJavaHelper::ToJavaString(Env, MetricName));
 #else
-	return Name;
+	return Native->Metrics.Contains(MetricName) ? Native->Metrics[MetricName] : 0LL;
 #endif
 #else
-	return FString{};
+	return 0LL;
 #endif
 }
 
-void FFirebaseTrace::Start()
+void FFirebaseTrace::SetMetricValue(const FString& MetricName, const int64 Value)
 {
 #if WITH_FIREBASE_PERFORMANCE
-#if PLATFORM_IOS
-	if (Trace != nil)
+	if (!Native.IsValid())
 	{
-		[Trace start];
+		return;
 	}
+
+#if PLATFORM_IOS
+	[Native->Trace setIntValue: Value
+	                 forMetric: MetricName.GetNSString()];
 #elif PLATFORM_ANDROID
-	CALL_PERFORMANCE("FIR_PR_StartTrace", "(Lcom/google/firebase/perf/metrics/Trace;)V", Void, void(), Trace);
+	CALL_PERFORMANCE("FIR_PR_SetMetricValue", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;J)V", Void,
+		void(), Native->Trace, *FJavaHelper::ToJavaString(Env, MetricName), (jlong)Value);
 #else
-	UE_LOG(LogFirebasePerformance, Log, TEXT("Started trace %s execution."), *Name);
+	Native->Metrics.Add(MetricName, Value);
+
+	FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnMetricSet(Native->Id, MetricName, Value);
+	});
 #endif
 #endif
 }
 
-void FFirebaseTrace::Stop()
+void FFirebaseTrace::SetMetricValues(TArrayView<const FString> MetricNames, TArrayView<const int64> Values)
 {
+	check(MetricNames.Num() == Values.Num());
+
+	if (MetricNames.Num() == 0)
+	{
+		return;
+	}
+
 #if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
 #if PLATFORM_IOS
-	if (Trace != nil)
+	for (int32 i = 0; i < MetricNames.Num(); ++i)
 	{
-		[Trace stop];
+		[Native->Trace setIntValue: Values[i]
+		                 forMetric: MetricNames[i].GetNSString()];
 	}
 #elif PLATFORM_ANDROID
-	CALL_PERFORMANCE("FIR_PR_StopTrace", "(Lcom/google/firebase/perf/metrics/Trace;)V", Void, void(), Trace);
+	// The arrays' local refs must be released explicitly as this is
+	// typically called from a native thread that never returns to Java.
+	InitializeFirebasePerformance();
+
+	JNIEnv* const ArgsEnv = GetPerformanceJavaEnv();
+
+	check(ArgsEnv);
+
+	auto jNames  = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewObjectArray(MetricNames.Num(), GjStringClass, nullptr));
+	auto jValues = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewLongArray(Values.Num()));
+
+	for (int32 i = 0; i < MetricNames.Num(); ++i)
+	{
+		ArgsEnv->SetObjectArrayElement(*jNames, i, *FJavaHelper::ToJavaString(ArgsEnv, MetricNames[i]));
+	}
+
+	ArgsEnv->SetLongArrayRegion(*jValues, 0, Values.Num(), (const jlong*)Values.GetData());
+
+	CALL_PERFORMANCE("FIR_PR_SetMetricValues", "(Lcom/google/firebase/perf/metrics/Trace;[Ljava/lang/String;[J)V", Void,
+		void(), Native->Trace, *jNames, *jValues);
 #else
-	UE_LOG(LogFirebasePerformance, Log, TEXT("Stopped trace %s execution."), *Name);
+	for (int32 i = 0; i < MetricNames.Num(); ++i)
+	{
+		Native->Metrics.Add(MetricNames[i], Values[i]);
+	}
+
+	FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+	{
+		for (int32 i = 0; i < MetricNames.Num(); ++i)
+		{
+			Sink.OnMetricSet(Native->Id, MetricNames[i], Values[i]);
+		}
+	});
 #endif
 #endif
 }
 
-void FFirebaseTrace::IncrementMetric(const FString& MetricName, const int64 ByValue)
+FFirebaseMetricHandle FFirebaseTrace::RegisterMetric(const FString& MetricName)
 {
+	using namespace FirebasePerformance;
+
+	FScopeLock Lock(&GRegistrationLock);
+
+	if (const int32* const ExistingIndex = GRegisteredMetricIndices.Find(MetricName))
+	{
+		return FFirebaseMetricHandle(*ExistingIndex);
+	}
+
+	const int32 Index = GRegisteredMetricCount.Load();
+
+	if (Index >= MaxRegisteredMetrics)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to register metric %s: too many metrics registered (max: %d)."), *MetricName, MaxRegisteredMetrics);
+		return FFirebaseMetricHandle();
+	}
+
+	FRegisteredMetric& Metric = GRegisteredMetrics[Index];
+
+	Metric.Name = MetricName;
+
 #if WITH_FIREBASE_PERFORMANCE
 #if PLATFORM_IOS
-	if (Trace != nil)
+	Metric.NativeName = [MetricName.GetNSString() retain];
+#elif PLATFORM_ANDROID
+	JNIEnv* const Env = GetPerformanceJavaEnv();
+
+	check(Env);
+
+	Metric.NativeName = (jstring)Env->NewGlobalRef(*FJavaHelper::ToJavaString(Env, MetricName));
+#endif
+#endif
+
+	GRegisteredMetricIndices.Add(MetricName, Index);
+
+	// Publishes the entry to lock-free readers.
+	GRegisteredMetricCount.Store(Index + 1);
+
+	return FFirebaseMetricHandle(Index);
+}
+
+FString FFirebaseTrace::GetMetricName(const FFirebaseMetricHandle Metric)
+{
+	const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(Metric);
+
+	return Registered ? Registered->Name : FString();
+}
+
+void FFirebaseTrace::IncrementMetric(const FFirebaseMetricHandle Metric, const int64 ByValue)
+{
+	const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(Metric);
+
+	if (!Registered)
 	{
-		[Trace incrementMetric: MetricName.GetNSString()
-                         byInt: ByValue];
+		return;
 	}
+
+#if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
+#if PLATFORM_IOS
+	[Native->Trace incrementMetric: Registered->NativeName
+	                         byInt: ByValue];
 #elif PLATFORM_ANDROID
 	CALL_PERFORMANCE("FIR_PR_IncrementMetric", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;J)V", Void,
-		void(), Trace, *FJavaHelper::ToJavaString(Env, MetricName), (jlong)ByValue);
+		void(), Native->Trace, Registered->NativeName, (jlong)ByValue);
 #else
-	Metrics.FindOrAdd(MetricName, 0LL) += ByValue;
+	Native->Metrics.FindOrAdd(Registered->Name, 0LL) += ByValue;
+
+	FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnMetricIncremented(Native->Id, Registered->Name, ByValue);
+	});
 #endif
 #endif
 }
 
-int64 FFirebaseTrace::GetMetricValue(const FString& MetricName) const
+int64 FFirebaseTrace::GetMetricValue(const FFirebaseMetricHandle Metric) const
 {
+	const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(Metric);
+
+	if (!Registered)
+	{
+		return 0LL;
+	}
+
 #if WITH_FIREBASE_PERFORMANCE
-#if PLATFORM_IOS
-	if (Trace != nil)
+	if (!Native.IsValid())
 	{
-		return [Trace valueForIntMetric: MetricName.GetNSString()] ;
+		return 0LL;
 	}
-	return 0LL;
+
+#if PLATFORM_IOS
+	return [Native->Trace valueForIntMetric: Registered->NativeName];
 #elif PLATFORM_ANDROID
 	CALL_PERFORMANCE("FIR_PR_GetMetricValue", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;)J", Long,
-		0LL, Trace, *FJavaHelper::ToJavaString(Env, MetricName));
+		0LL, Native->Trace, Registered->NativeName);
 #else
-	return Metrics.Contains(MetricName) ? Metrics[MetricName] : 0LL;
+	const int64* const Value = Native->Metrics.Find(Registered->Name);
+	return Value ? *Value : 0LL;
 #endif
 #else
 	return 0LL;
 #endif
 }
 
-void FFirebaseTrace::SetMetricValue(const FString& MetricName, const int64 Value)
+void FFirebaseTrace::SetMetricValue(const FFirebaseMetricHandle Metric, const int64 Value)
 {
+	const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(Metric);
+
+	if (!Registered)
+	{
+		return;
+	}
+
 #if WITH_FIREBASE_PERFORMANCE
-#if PLATFORM_IOS
-	if (Trace != nil)
+	if (!Native.IsValid())
 	{
-		[Trace setIntValue: Value
-                 forMetric: MetricName.GetNSString()];
+		return;
 	}
+
+#if PLATFORM_IOS
+	[Native->Trace setIntValue: Value
+	                 forMetric: Registered->NativeName];
 #elif PLATFORM_ANDROID
 	CALL_PERFORMANCE("FIR_PR_SetMetricValue", "(Lcom/google/firebase/perf/metrics/Trace;Ljava/lang/String;J)V", Void,
-		void(), Trace, *FJavaHelper::ToJavaString(Env, MetricName), (jlong)Value);
+		void(), Native->Trace, Registered->NativeName, (jlong)Value);
 #else
-	Metrics.Add(MetricName, Value);
+	Native->Metrics.Add(Registered->Name, Value);
+
+	FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+	{
+		Sink.OnMetricSet(Native->Id, Registered->Name, Value);
+	});
+#endif
+#endif
+}
+
+void FFirebaseTrace::SetMetricValues(TArrayView<const FFirebaseMetricHandle> MetricHandles, TArrayView<const int64> Values)
+{
+	check(MetricHandles.Num() == Values.Num());
+
+	if (MetricHandles.Num() == 0)
+	{
+		return;
+	}
+
+#if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
+#if PLATFORM_IOS
+	for (int32 i = 0; i < MetricHandles.Num(); ++i)
+	{
+		if (const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(MetricHandles[i]))
+		{
+			[Native->Trace setIntValue: Values[i]
+			                 forMetric: Registered->NativeName];
+		}
+	}
+#elif PLATFORM_ANDROID
+	InitializeFirebasePerformance();
+
+	JNIEnv* const ArgsEnv = GetPerformanceJavaEnv();
+
+	check(ArgsEnv);
+
+	const int32 NumRegistered = FirebasePerformance::CountRegisteredMetrics(MetricHandles);
+
+	if (NumRegistered == 0)
+	{
+		return;
+	}
+
+	auto jNames  = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewObjectArray(NumRegistered, GjStringClass, nullptr));
+	auto jValues = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewLongArray(NumRegistered));
+
+	FirebasePerformance::FillJavaMetricArrays(ArgsEnv, MetricHandles, Values, NumRegistered, *jNames, *jValues);
+
+	CALL_PERFORMANCE("FIR_PR_SetMetricValues", "(Lcom/google/firebase/perf/metrics/Trace;[Ljava/lang/String;[J)V", Void,
+		void(), Native->Trace, *jNames, *jValues);
+#else
+	for (int32 i = 0; i < MetricHandles.Num(); ++i)
+	{
+		if (const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(MetricHandles[i]))
+		{
+			Native->Metrics.Add(Registered->Name, Values[i]);
+
+			FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+			{
+				Sink.OnMetricSet(Native->Id, Registered->Name, Values[i]);
+			});
+		}
+	}
+#endif
+#endif
+}
+
+void FFirebaseTrace::IncrementMetrics(TArrayView<const FFirebaseMetricHandle> MetricHandles, TArrayView<const int64> ByValues)
+{
+	check(MetricHandles.Num() == ByValues.Num());
+
+	if (MetricHandles.Num() == 0)
+	{
+		return;
+	}
+
+#if WITH_FIREBASE_PERFORMANCE
+	if (!Native.IsValid())
+	{
+		return;
+	}
+
+#if PLATFORM_IOS
+	for (int32 i = 0; i < MetricHandles.Num(); ++i)
+	{
+		if (const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(MetricHandles[i]))
+		{
+			[Native->Trace incrementMetric: Registered->NativeName
+			                         byInt: ByValues[i]];
+		}
+	}
+#elif PLATFORM_ANDROID
+	InitializeFirebasePerformance();
+
+	JNIEnv* const ArgsEnv = GetPerformanceJavaEnv();
+
+	check(ArgsEnv);
+
+	const int32 NumRegistered = FirebasePerformance::CountRegisteredMetrics(MetricHandles);
+
+	if (NumRegistered == 0)
+	{
+		return;
+	}
+
+	auto jNames  = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewObjectArray(NumRegistered, GjStringClass, nullptr));
+	auto jValues = NewScopedJavaObject(ArgsEnv, ArgsEnv->NewLongArray(NumRegistered));
+
+	FirebasePerformance::FillJavaMetricArrays(ArgsEnv, MetricHandles, ByValues, NumRegistered, *jNames, *jValues);
+
+	CALL_PERFORMANCE("FIR_PR_IncrementMetrics", "(Lcom/google/firebase/perf/metrics/Trace;[Ljava/lang/String;[J)V", Void,
+		void(), Native->Trace, *jNames, *jValues);
+#else
+	for (int32 i = 0; i < MetricHandles.Num(); ++i)
+	{
+		if (const FirebasePerformance::FRegisteredMetric* const Registered = FirebasePerformance::FindRegisteredMetric(MetricHandles[i]))
+		{
+			Native->Metrics.FindOrAdd(Registered->Name, 0LL) += ByValues[i];
+
+			FirebasePerformance::ForEachTraceSink([&](IFirebaseTraceSink& Sink)
+			{
+				Sink.OnMetricIncremented(Native->Id, Registered->Name, ByValues[i]);
+			});
+		}
+	}
 #endif
 #endif
 }
 
+void FirebasePerformance::AddTraceSink(const FFirebaseTraceSinkRef& Sink)
+{
+	FWriteScopeLock Lock(GTraceSinksLock);
+
+	GTraceSinks.AddUnique(Sink);
+	GTraceSinkCount.Store(GTraceSinks.Num());
+}
+
+void FirebasePerformance::RemoveTraceSink(const FFirebaseTraceSinkRef& Sink)
+{
+	FWriteScopeLock Lock(GTraceSinksLock);
+
+	GTraceSinks.Remove(Sink);
+	GTraceSinkCount.Store(GTraceSinks.Num());
+}
+
 FFirebaseTrace UFirebasePerformanceLibrary::CreateTrace(const FString& TraceName)
 {
 #if WITH_FIREBASE_PERFORMANCE
-	UE_LOG(LogFirebasePerformance, Log, TEXT("Creating new trace named %s."), *TraceName);
+	UE_LOG(LogFirebasePerformance, Verbose, TEXT("Creating new trace named %s."), *TraceName);
 
 #if PLATFORM_IOS
 	if (TraceName.IsEmpty())
@@ -320,6 +898,40 @@ FFirebaseTrace UFirebasePerformanceLibrary::CreateAndStartTrace(const FString& T
 #endif
 }
 
+void UFirebasePerformanceLibrary::PrewarmTraces(const TArray<FString>& TraceNames, const int32 CountPerName)
+{
+#if WITH_FIREBASE_PERFORMANCE
+	for (const FString& TraceName : TraceNames)
+	{
+		if (TraceName.IsEmpty())
+		{
+			UE_LOG(LogFirebasePerformance, Warning, TEXT("Can't prewarm a trace with an empty name."));
+			continue;
+		}
+
+		FFirebaseTracePool::Get().Prewarm(FirebasePerformance::HashTraceName(*TraceName), TraceName, CountPerName);
+	}
+#endif
+}
+
+FFirebaseTraceHandle UFirebasePerformanceLibrary::AcquireTrace(const FString& TraceName)
+{
+#if WITH_FIREBASE_PERFORMANCE
+	return FFirebaseTraceHandle(FFirebaseTracePool::Get().Acquire(FirebasePerformance::HashTraceName(*TraceName), *TraceName));
+#else
+	return FFirebaseTraceHandle();
+#endif
+}
+
+FFirebaseTraceHandle UFirebasePerformanceLibrary::AcquireAndStartTrace(const FString& TraceName)
+{
+	FFirebaseTraceHandle Trace = AcquireTrace(TraceName);
+
+	Trace->Start();
+
+	return Trace;
+}
+
 void UFirebasePerformanceLibrary::SetInstrumentationEnabled(const bool bEnabled)
 {
 #if WITH_FIREBASE_PERFORMANCE
@@ -0,0 +1,39 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Performance/FirebaseScopedTrace.h"
+#include "Performance/FirebaseTracePool.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarFirebaseScopedTraces(
+	TEXT("firebase.Performance.ScopedTraces"),
+	1,
+	TEXT("If scoped Firebase traces (FIREBASE_SCOPED_TRACE) are recorded.\n")
+	TEXT(" 0: off\n")
+	TEXT(" 1: on (default)"),
+	ECVF_Default);
+
+FScopedFirebaseTrace::FScopedFirebaseTrace(const uint32 NameHash, const TCHAR* const Name)
+	: bActive(false)
+{
+#if WITH_FIREBASE_PERFORMANCE
+	if (CVarFirebaseScopedTraces.GetValueOnAnyThread() != 0)
+	{
+		Trace = FFirebaseTracePool::Get().Acquire(NameHash, Name);
+		Trace.Start();
+		bActive = true;
+	}
+#endif
+}
+
+FScopedFirebaseTrace::FScopedFirebaseTrace(const FString& Name)
+	: FScopedFirebaseTrace(FirebasePerformance::HashTraceName(*Name), *Name)
+{
+}
+
+FScopedFirebaseTrace::~FScopedFirebaseTrace()
+{
+	if (bActive)
+	{
+		Trace.Stop();
+	}
+}
@@ -0,0 +1,118 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Performance/FirebaseTraceAccumulator.h"
+#include "FirebaseFeatures.h"
+#include "FirebaseSdk/FirebaseConfig.h"
+#include "Misc/ScopeLock.h"
+
+FFirebaseTraceAccumulator::FFirebaseTraceAccumulator(FFirebaseTrace InTrace, const float FlushInterval)
+	: NumSlots(0)
+	, Trace(MoveTemp(InTrace))
+	, bStopped(false)
+{
+	for (std::atomic<int64>& Delta : Deltas)
+	{
+		Delta.store(0, std::memory_order_relaxed);
+	}
+
+	const float Interval = FlushInterval < 0.f ? UFirebaseConfig::Get()->PerformanceAccumulatorFlushInterval : FlushInterval;
+
+	if (Interval > 0.f)
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FFirebaseTraceAccumulator::HandleFlushTick), Interval);
+	}
+}
+
+FFirebaseTraceAccumulator::~FFirebaseTraceAccumulator()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+
+	Flush();
+}
+
+int32 FFirebaseTraceAccumulator::AddMetric(const FString& MetricName)
+{
+	const FFirebaseMetricHandle Handle = FFirebaseTrace::RegisterMetric(MetricName);
+
+	if (!Handle.IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	FScopeLock Lock(&TraceLock);
+
+	const int32 Count = NumSlots.load(std::memory_order_relaxed);
+
+	for (int32 Slot = 0; Slot < Count; ++Slot)
+	{
+		if (Handles[Slot] == Handle)
+		{
+			return Slot;
+		}
+	}
+
+	if (Count >= MaxSlots)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to add metric %s to accumulator: all %d slots are used."), *MetricName, MaxSlots);
+		return INDEX_NONE;
+	}
+
+	Handles[Count] = Handle;
+
+	// Publishes the slot to the threads flushing.
+	NumSlots.store(Count + 1, std::memory_order_release);
+
+	return Count;
+}
+
+void FFirebaseTraceAccumulator::Flush()
+{
+	FFirebaseMetricHandle BatchHandles[MaxSlots];
+	int64 BatchValues[MaxSlots];
+	int32 BatchNum = 0;
+
+	FScopeLock Lock(&TraceLock);
+
+	const int32 Count = NumSlots.load(std::memory_order_acquire);
+
+	for (int32 Slot = 0; Slot < Count; ++Slot)
+	{
+		const int64 Delta = Deltas[Slot].exchange(0, std::memory_order_relaxed);
+
+		if (Delta != 0)
+		{
+			BatchHandles[BatchNum] = Handles[Slot];
+			BatchValues [BatchNum] = Delta;
+			++BatchNum;
+		}
+	}
+
+	if (BatchNum > 0 && !bStopped)
+	{
+		Trace.IncrementMetrics(MakeArrayView(BatchHandles, BatchNum), MakeArrayView(BatchValues, BatchNum));
+	}
+}
+
+void FFirebaseTraceAccumulator::Stop()
+{
+	Flush();
+
+	FScopeLock Lock(&TraceLock);
+
+	if (!bStopped)
+	{
+		Trace.Stop();
+		bStopped = true;
+	}
+}
+
+bool FFirebaseTraceAccumulator::HandleFlushTick(float DeltaTime)
+{
+	Flush();
+
+	return true;
+}
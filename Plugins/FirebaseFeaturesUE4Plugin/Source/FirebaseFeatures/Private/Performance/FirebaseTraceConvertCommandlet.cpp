@@ -0,0 +1,301 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Performance/FirebaseTraceConvertCommandlet.h"
+#include "Performance/FirebaseTraceFile.h"
+#include "FirebaseFeatures.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	struct FTraceFileContents
+	{
+		FirebaseTraceFile::FHeader Header;
+		TMap<uint32, FString> Names;
+		// From the oldest to the newest.
+		TArray<FirebaseTraceFile::FRecord> Records;
+	};
+
+	bool ReadTraceFile(const FString& Path, FTraceFileContents& OutContents)
+	{
+		using namespace FirebaseTraceFile;
+
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *Path))
+		{
+			UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to read trace file %s."), *Path);
+			return false;
+		}
+
+		if (Data.Num() < sizeof(FHeader))
+		{
+			UE_LOG(LogFirebasePerformance, Error, TEXT("%s is not a trace file."), *Path);
+			return false;
+		}
+
+		FHeader& Header = OutContents.Header;
+		FMemory::Memcpy(&Header, Data.GetData(), sizeof(FHeader));
+
+		if (Header.Magic != Magic || Header.Version != Version)
+		{
+			UE_LOG(LogFirebasePerformance, Error, TEXT("%s is not a trace file or was written by another version of the plugin."), *Path);
+			return false;
+		}
+
+		const uint64 ExpectedSize = sizeof(FHeader) + (uint64)Header.NameTableCapacity + Header.RingCapacity * sizeof(FRecord);
+		if ((uint64)Data.Num() < ExpectedSize || Header.NameTableSize > Header.NameTableCapacity || Header.RingCapacity == 0)
+		{
+			UE_LOG(LogFirebasePerformance, Error, TEXT("Trace file %s is truncated or corrupted."), *Path);
+			return false;
+		}
+
+		const uint8* const NameTable = Data.GetData() + sizeof(FHeader);
+		uint32 NameOffset = 0;
+		while (NameOffset + sizeof(FNameEntry) <= Header.NameTableSize)
+		{
+			FNameEntry Entry;
+			FMemory::Memcpy(&Entry, NameTable + NameOffset, sizeof(FNameEntry));
+			NameOffset += sizeof(FNameEntry);
+
+			if (NameOffset + Entry.Length > Header.NameTableSize)
+			{
+				break;
+			}
+
+			const FUTF8ToTCHAR Name((const ANSICHAR*)(NameTable + NameOffset), Entry.Length);
+			OutContents.Names.Add(Entry.Id, FString(Name.Length(), Name.Get()));
+
+			NameOffset += Entry.Length;
+		}
+
+		const FRecord* const Ring = (const FRecord*)(NameTable + Header.NameTableCapacity);
+		const uint64 RecordCount = FMath::Min(Header.RecordCount, Header.RingCapacity);
+
+		OutContents.Records.Reserve(RecordCount);
+		for (uint64 Index = Header.RecordCount - RecordCount; Index < Header.RecordCount; ++Index)
+		{
+			OutContents.Records.Add(Ring[Index % Header.RingCapacity]);
+		}
+
+		if (Header.RecordCount > Header.RingCapacity)
+		{
+			UE_LOG(LogFirebasePerformance, Warning, TEXT("The ring wrapped: the %llu oldest records were overwritten."), Header.RecordCount - Header.RingCapacity);
+		}
+
+		return true;
+	}
+
+	FString EscapeJson(const FString& Value)
+	{
+		FString Escaped;
+		Escaped.Reserve(Value.Len());
+
+		for (const TCHAR Character : Value)
+		{
+			switch (Character)
+			{
+			case TEXT('"'):  Escaped += TEXT("\\\""); break;
+			case TEXT('\\'): Escaped += TEXT("\\\\"); break;
+			case TEXT('\n'): Escaped += TEXT("\\n");  break;
+			case TEXT('\r'): Escaped += TEXT("\\r");  break;
+			case TEXT('\t'): Escaped += TEXT("\\t");  break;
+			default:
+				if (Character < 0x20)
+				{
+					Escaped += FString::Printf(TEXT("\\u%04x"), (uint32)Character);
+				}
+				else
+				{
+					Escaped.AppendChar(Character);
+				}
+			}
+		}
+
+		return Escaped;
+	}
+
+	FString EscapeCsv(const FString& Value)
+	{
+		if (!Value.Contains(TEXT(",")) && !Value.Contains(TEXT("\"")) && !Value.Contains(TEXT("\n")))
+		{
+			return Value;
+		}
+
+		return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+
+	/** Replays the records, keeping track of the trace names and of the metrics' values. */
+	class FTraceReplay
+	{
+	public:
+		explicit FTraceReplay(const FTraceFileContents& InContents)
+			: Contents(InContents)
+		{
+		}
+
+		template<typename FunctorType>
+		void ForEachRecord(FunctorType&& Functor)
+		{
+			using namespace FirebaseTraceFile;
+
+			for (const FRecord& Record : Contents.Records)
+			{
+				int64 MetricValue = 0;
+
+				switch (Record.Type)
+				{
+				case ERecordType::TraceStarted:
+					TraceNames.Add(Record.TraceId, GetName(Record.NameId));
+					break;
+
+				case ERecordType::MetricIncremented:
+					MetricValue = (MetricValues.FindOrAdd(TPair<uint64, uint32>(Record.TraceId, Record.NameId), 0) += Record.Value);
+					break;
+
+				case ERecordType::MetricSet:
+					MetricValue = (MetricValues.FindOrAdd(TPair<uint64, uint32>(Record.TraceId, Record.NameId)) = Record.Value);
+					break;
+
+				case ERecordType::TraceStopped:
+					break;
+
+				default:
+					continue;
+				}
+
+				const FString* const TraceName = TraceNames.Find(Record.TraceId);
+
+				Functor(Record, TraceName ? *TraceName : FString::Printf(TEXT("Trace%llu"), Record.TraceId), MetricValue);
+			}
+		}
+
+		FString GetName(const uint32 NameId) const
+		{
+			const FString* const Name = Contents.Names.Find(NameId);
+			return Name ? *Name : TEXT("<unknown>");
+		}
+
+	private:
+		const FTraceFileContents& Contents;
+		TMap<uint64, FString> TraceNames;
+		TMap<TPair<uint64, uint32>, int64> MetricValues;
+	};
+
+	FString ConvertToCsv(const FTraceFileContents& Contents)
+	{
+		using namespace FirebaseTraceFile;
+
+		FString Csv = TEXT("TimestampUs,Event,TraceId,Trace,Metric,Delta,Value\n");
+
+		FTraceReplay Replay(Contents);
+		Replay.ForEachRecord([&](const FRecord& Record, const FString& TraceName, const int64 MetricValue)
+		{
+			switch (Record.Type)
+			{
+			case ERecordType::TraceStarted:
+				Csv += FString::Printf(TEXT("%llu,Start,%llu,%s,,,\n"), Record.TimestampUs, Record.TraceId, *EscapeCsv(TraceName));
+				break;
+
+			case ERecordType::TraceStopped:
+				Csv += FString::Printf(TEXT("%llu,Stop,%llu,%s,,,\n"), Record.TimestampUs, Record.TraceId, *EscapeCsv(TraceName));
+				break;
+
+			case ERecordType::MetricIncremented:
+				Csv += FString::Printf(TEXT("%llu,Increment,%llu,%s,%s,%lld,%lld\n"), Record.TimestampUs, Record.TraceId,
+					*EscapeCsv(TraceName), *EscapeCsv(Replay.GetName(Record.NameId)), Record.Value, MetricValue);
+				break;
+
+			case ERecordType::MetricSet:
+				Csv += FString::Printf(TEXT("%llu,Set,%llu,%s,%s,,%lld\n"), Record.TimestampUs, Record.TraceId,
+					*EscapeCsv(TraceName), *EscapeCsv(Replay.GetName(Record.NameId)), MetricValue);
+				break;
+			}
+		});
+
+		return Csv;
+	}
+
+	// Traces are async spans and metrics counters in the Chrome trace event format.
+	FString ConvertToChromeJson(const FTraceFileContents& Contents)
+	{
+		using namespace FirebaseTraceFile;
+
+		TArray<FString> Events;
+		Events.Reserve(Contents.Records.Num());
+
+		FTraceReplay Replay(Contents);
+		Replay.ForEachRecord([&](const FRecord& Record, const FString& TraceName, const int64 MetricValue)
+		{
+			switch (Record.Type)
+			{
+			case ERecordType::TraceStarted:
+			case ERecordType::TraceStopped:
+				Events.Add(FString::Printf(TEXT("{\"name\":\"%s\",\"cat\":\"firebase\",\"ph\":\"%s\",\"id\":%llu,\"ts\":%llu,\"pid\":0,\"tid\":0}"),
+					*EscapeJson(TraceName), Record.Type == ERecordType::TraceStarted ? TEXT("b") : TEXT("e"), Record.TraceId, Record.TimestampUs));
+				break;
+
+			case ERecordType::MetricIncremented:
+			case ERecordType::MetricSet:
+				Events.Add(FString::Printf(TEXT("{\"name\":\"%s\",\"cat\":\"firebase\",\"ph\":\"C\",\"id\":%llu,\"ts\":%llu,\"pid\":0,\"tid\":0,\"args\":{\"%s\":%lld}}"),
+					*EscapeJson(TraceName), Record.TraceId, Record.TimestampUs, *EscapeJson(Replay.GetName(Record.NameId)), MetricValue));
+				break;
+			}
+		});
+
+		return FString::Printf(TEXT("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"startUnixTimeUs\":%lld},\"traceEvents\":[\n%s\n]}\n"),
+			Contents.Header.StartUnixTimeUs, *FString::Join(Events, TEXT(",\n")));
+	}
+}
+
+UFirebaseTraceConvertCommandlet::UFirebaseTraceConvertCommandlet()
+{
+	IsClient		= false;
+	IsServer		= false;
+	IsEditor		= false;
+	LogToConsole	= true;
+	ShowErrorCount	= true;
+}
+
+int32 UFirebaseTraceConvertCommandlet::Main(const FString& Params)
+{
+	FString InPath;
+	if (!FParse::Value(*Params, TEXT("In="), InPath))
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Usage: -run=FirebaseTraceConvert -In=<TraceFile> [-Out=<OutputFile>] [-Format=Csv|Json]"));
+		return 1;
+	}
+
+	FString OutPath;
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	FString Format;
+	if (!FParse::Value(*Params, TEXT("Format="), Format))
+	{
+		Format = FPaths::GetExtension(OutPath);
+	}
+
+	const bool bCsv = Format.Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+
+	if (OutPath.IsEmpty())
+	{
+		OutPath = FPaths::ChangeExtension(InPath, bCsv ? TEXT("csv") : TEXT("json"));
+	}
+
+	FTraceFileContents Contents;
+	if (!ReadTraceFile(InPath, Contents))
+	{
+		return 1;
+	}
+
+	const FString Output = bCsv ? ConvertToCsv(Contents) : ConvertToChromeJson(Contents);
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to write %s."), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogFirebasePerformance, Display, TEXT("Converted %d record(s) from %s to %s."), Contents.Records.Num(), *InPath, *OutPath);
+
+	return 0;
+}
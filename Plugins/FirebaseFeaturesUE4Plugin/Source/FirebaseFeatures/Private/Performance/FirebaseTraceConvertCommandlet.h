@@ -0,0 +1,23 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FirebaseTraceConvertCommandlet.generated.h"
+
+/**
+ * Converts a trace file recorded on desktop by the trace file sink to CSV or Chrome trace JSON.
+ *
+ * Usage: -run=FirebaseTraceConvert -In=<TraceFile> [-Out=<OutputFile>] [-Format=Csv|Json]
+ * The format defaults to the output file's extension, then to JSON.
+ */
+UCLASS()
+class UFirebaseTraceConvertCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UFirebaseTraceConvertCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,65 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Layout of the files written by FFirebaseTraceFileSink:
+ *  - a FHeader;
+ *  - a name table of NameTableCapacity bytes, filled with FNameEntry followed by the name in UTF-8;
+ *  - a ring of RingCapacity FRecord. The ring holds the last Min(RecordCount, RingCapacity) records,
+ *    the oldest one being at index RecordCount % RingCapacity once the ring wrapped.
+ */
+namespace FirebaseTraceFile
+{
+	static constexpr uint32 Magic   = 0x43525446; // "FTRC"
+	static constexpr uint32 Version = 1;
+
+	// Id used when a name couldn't be added to a full name table.
+	static constexpr uint32 UnknownNameId = 0;
+
+	enum class ERecordType : uint8
+	{
+		TraceStarted	  = 1,
+		TraceStopped	  = 2,
+		MetricIncremented = 3,
+		MetricSet		  = 4,
+	};
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NameTableCapacity;
+		uint32 NameTableSize;
+		uint64 RingCapacity;
+		// Written after each record so a reader never sees a partially written one.
+		uint64 RecordCount;
+		// UTC time of the first record's timestamp, in microseconds since the Unix epoch.
+		int64  StartUnixTimeUs;
+		uint32 NextNameId;
+		uint32 Padding[5];
+	};
+
+	struct FNameEntry
+	{
+		uint32 Id;
+		uint32 Length;
+	};
+
+	struct FRecord
+	{
+		ERecordType Type;
+		uint8  Padding[3];
+		// Trace name for TraceStarted, metric name for the metric records.
+		uint32 NameId;
+		uint64 TraceId;
+		// Microseconds since StartUnixTimeUs.
+		uint64 TimestampUs;
+		int64  Value;
+	};
+
+	static_assert(sizeof(FHeader) == 64, "The header's layout must not change.");
+	static_assert(sizeof(FRecord) == 32, "The record's layout must not change.");
+}
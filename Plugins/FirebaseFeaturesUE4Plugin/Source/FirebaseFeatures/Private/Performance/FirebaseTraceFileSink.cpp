@@ -0,0 +1,259 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Performance/FirebaseTraceFileSink.h"
+
+#if WITH_FIREBASE_TRACE_FILE_SINK
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_WINDOWS
+#	include "Windows/AllowWindowsPlatformTypes.h"
+#	include <windows.h>
+#	include "Windows/HideWindowsPlatformTypes.h"
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+namespace
+{
+	static constexpr uint32 NameTableCapacity = 64 * 1024;
+	static constexpr int64  MinRingCapacity   = 1024;
+}
+
+TSharedPtr<FFirebaseTraceFileSink, ESPMode::ThreadSafe> FFirebaseTraceFileSink::Create(const FString& Path, const int64 FileSize)
+{
+	TSharedPtr<FFirebaseTraceFileSink, ESPMode::ThreadSafe> Sink = MakeShareable(new FFirebaseTraceFileSink());
+
+	if (!Sink->Map(Path, FileSize))
+	{
+		return nullptr;
+	}
+
+	return Sink;
+}
+
+FFirebaseTraceFileSink::~FFirebaseTraceFileSink()
+{
+	Unmap();
+}
+
+bool FFirebaseTraceFileSink::Map(const FString& Path, const int64 FileSize)
+{
+	using namespace FirebaseTraceFile;
+
+	const int64 RingCapacity = (FileSize - (int64)sizeof(FHeader) - NameTableCapacity) / (int64)sizeof(FRecord);
+
+	if (RingCapacity < MinRingCapacity)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Trace file size %lld is too small to record traces."), FileSize);
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+
+	const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+
+#if PLATFORM_WINDOWS
+	FileHandle = ::CreateFileW(*FullPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (FileHandle == INVALID_HANDLE_VALUE)
+	{
+		FileHandle = nullptr;
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to create trace file %s (error: %u)."), *FullPath, ::GetLastError());
+		return false;
+	}
+
+	MappingHandle = ::CreateFileMappingW(FileHandle, nullptr, PAGE_READWRITE, (DWORD)(FileSize >> 32), (DWORD)(FileSize & 0xFFFFFFFF), nullptr);
+
+	if (MappingHandle)
+	{
+		Mapping = (uint8*)::MapViewOfFile(MappingHandle, FILE_MAP_WRITE, 0, 0, FileSize);
+	}
+
+	if (!Mapping)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to map trace file %s (error: %u)."), *FullPath, ::GetLastError());
+		Unmap();
+		return false;
+	}
+#else
+	FileDescriptor = ::open(TCHAR_TO_UTF8(*FullPath), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (FileDescriptor < 0)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to create trace file %s (errno: %d)."), *FullPath, errno);
+		return false;
+	}
+
+	if (::ftruncate(FileDescriptor, FileSize) != 0)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to resize trace file %s (errno: %d)."), *FullPath, errno);
+		Unmap();
+		return false;
+	}
+
+	void* const MappedAddress = ::mmap(nullptr, FileSize, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+
+	if (MappedAddress == MAP_FAILED)
+	{
+		UE_LOG(LogFirebasePerformance, Error, TEXT("Failed to map trace file %s (errno: %d)."), *FullPath, errno);
+		Unmap();
+		return false;
+	}
+
+	Mapping = (uint8*)MappedAddress;
+#endif
+
+	MappingSize = FileSize;
+
+	Header	  = (FHeader*)Mapping;
+	NameTable = Mapping + sizeof(FHeader);
+	Records	  = (FRecord*)(NameTable + NameTableCapacity);
+
+	FMemory::Memzero(Header, sizeof(FHeader));
+
+	Header->Magic			  = Magic;
+	Header->Version			  = Version;
+	Header->NameTableCapacity = NameTableCapacity;
+	Header->NameTableSize	  = 0;
+	Header->RingCapacity	  = RingCapacity;
+	Header->RecordCount		  = 0;
+	Header->StartUnixTimeUs	  = (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTicks() / ETimespan::TicksPerMicrosecond;
+	Header->NextNameId		  = UnknownNameId + 1;
+
+	StartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogFirebasePerformance, Log, TEXT("Recording traces to %s (%lld records)."), *FullPath, RingCapacity);
+
+	return true;
+}
+
+void FFirebaseTraceFileSink::Unmap()
+{
+#if PLATFORM_WINDOWS
+	if (Mapping)
+	{
+		::FlushViewOfFile(Mapping, 0);
+		::UnmapViewOfFile(Mapping);
+	}
+
+	if (MappingHandle)
+	{
+		::CloseHandle(MappingHandle);
+	}
+
+	if (FileHandle)
+	{
+		::CloseHandle(FileHandle);
+	}
+
+	MappingHandle = nullptr;
+	FileHandle	  = nullptr;
+#else
+	if (Mapping)
+	{
+		::msync(Mapping, MappingSize, MS_SYNC);
+		::munmap(Mapping, MappingSize);
+	}
+
+	if (FileDescriptor >= 0)
+	{
+		::close(FileDescriptor);
+	}
+
+	FileDescriptor = -1;
+#endif
+
+	Mapping		= nullptr;
+	MappingSize = 0;
+	Header		= nullptr;
+	NameTable	= nullptr;
+	Records		= nullptr;
+}
+
+void FFirebaseTraceFileSink::OnTraceStarted(const uint64 TraceId, const FString& TraceName)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	WriteRecord(FirebaseTraceFile::ERecordType::TraceStarted, FindOrAddName(TraceName), TraceId, 0);
+}
+
+void FFirebaseTraceFileSink::OnTraceStopped(const uint64 TraceId)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	WriteRecord(FirebaseTraceFile::ERecordType::TraceStopped, FirebaseTraceFile::UnknownNameId, TraceId, 0);
+}
+
+void FFirebaseTraceFileSink::OnMetricIncremented(const uint64 TraceId, const FString& MetricName, const int64 ByValue)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	WriteRecord(FirebaseTraceFile::ERecordType::MetricIncremented, FindOrAddName(MetricName), TraceId, ByValue);
+}
+
+void FFirebaseTraceFileSink::OnMetricSet(const uint64 TraceId, const FString& MetricName, const int64 Value)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	WriteRecord(FirebaseTraceFile::ERecordType::MetricSet, FindOrAddName(MetricName), TraceId, Value);
+}
+
+uint32 FFirebaseTraceFileSink::FindOrAddName(const FString& Name)
+{
+	using namespace FirebaseTraceFile;
+
+	if (const uint32* const ExistingId = NameIds.Find(Name))
+	{
+		return *ExistingId;
+	}
+
+	FTCHARToUTF8 Utf8Name(*Name);
+
+	const uint32 EntrySize = sizeof(FNameEntry) + Utf8Name.Length();
+
+	if (Header->NameTableSize + EntrySize > Header->NameTableCapacity)
+	{
+		UE_LOG(LogFirebasePerformance, Warning, TEXT("Trace file's name table is full. %s will be recorded without name."), *Name);
+		NameIds.Add(Name, UnknownNameId);
+		return UnknownNameId;
+	}
+
+	const uint32 Id = Header->NextNameId++;
+
+	FNameEntry Entry;
+	Entry.Id	 = Id;
+	Entry.Length = Utf8Name.Length();
+
+	uint8* const EntryData = NameTable + Header->NameTableSize;
+	FMemory::Memcpy(EntryData, &Entry, sizeof(FNameEntry));
+	FMemory::Memcpy(EntryData + sizeof(FNameEntry), Utf8Name.Get(), Utf8Name.Length());
+
+	// Published after the entry so readers of a live file never see a partial name.
+	Header->NameTableSize += EntrySize;
+
+	NameIds.Add(Name, Id);
+
+	return Id;
+}
+
+void FFirebaseTraceFileSink::WriteRecord(const FirebaseTraceFile::ERecordType Type, const uint32 NameId, const uint64 TraceId, const int64 Value)
+{
+	FirebaseTraceFile::FRecord& Record = Records[Header->RecordCount % Header->RingCapacity];
+
+	Record.Type		   = Type;
+	Record.NameId	   = NameId;
+	Record.TraceId	   = TraceId;
+	Record.TimestampUs = (uint64)((FPlatformTime::Seconds() - StartTime) * 1000000.);
+	Record.Value	   = Value;
+
+	FPlatformMisc::MemoryBarrier();
+
+	Header->RecordCount++;
+}
+
+#endif // WITH_FIREBASE_TRACE_FILE_SINK
@@ -0,0 +1,71 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FirebaseFeatures.h"
+#include "FirebaseSdk/CaseSensitiveKeyFuncs.h"
+#include "Performance/FirebaseTraceFile.h"
+#include "Performance/FirebaseTraceSink.h"
+
+#define WITH_FIREBASE_TRACE_FILE_SINK (WITH_FIREBASE_PERFORMANCE && (PLATFORM_WINDOWS || PLATFORM_MAC || PLATFORM_LINUX))
+
+#if WITH_FIREBASE_TRACE_FILE_SINK
+
+/**
+ * Trace sink writing compact binary records to a memory-mapped ring file (see FirebaseTraceFile).
+ * Records are written straight into the mapping so they survive a crash of the process, and the
+ * oldest records are overwritten once the ring is full.
+ * Files are converted to CSV or Chrome trace JSON with the FirebaseTraceConvert commandlet.
+ */
+class FFirebaseTraceFileSink final : public IFirebaseTraceSink
+{
+public:
+	/**
+	 * Creates, or truncates, the file at Path and maps it.
+	 *
+	 * @param Path The path of the file.
+	 * @param FileSize The size of the file in bytes.
+	 * @return The sink or null if the file couldn't be mapped.
+	 */
+	static TSharedPtr<FFirebaseTraceFileSink, ESPMode::ThreadSafe> Create(const FString& Path, const int64 FileSize);
+
+	virtual ~FFirebaseTraceFileSink();
+
+	virtual void OnTraceStarted(const uint64 TraceId, const FString& TraceName) override;
+	virtual void OnTraceStopped(const uint64 TraceId) override;
+	virtual void OnMetricIncremented(const uint64 TraceId, const FString& MetricName, const int64 ByValue) override;
+	virtual void OnMetricSet(const uint64 TraceId, const FString& MetricName, const int64 Value) override;
+
+private:
+	FFirebaseTraceFileSink() = default;
+
+	bool Map(const FString& Path, const int64 FileSize);
+	void Unmap();
+
+	uint32 FindOrAddName(const FString& Name);
+	void WriteRecord(const FirebaseTraceFile::ERecordType Type, const uint32 NameId, const uint64 TraceId, const int64 Value);
+
+private:
+	FCriticalSection Lock;
+
+	uint8* Mapping = nullptr;
+	int64  MappingSize = 0;
+
+	FirebaseTraceFile::FHeader* Header	= nullptr;
+	uint8*						NameTable = nullptr;
+	FirebaseTraceFile::FRecord* Records	= nullptr;
+
+	// Names differing only by case are different metrics and traces.
+	TCaseSensitiveMap<uint32> NameIds;
+	double StartTime = 0.;
+
+#if PLATFORM_WINDOWS
+	void* FileHandle	= nullptr;
+	void* MappingHandle = nullptr;
+#else
+	int32 FileDescriptor = -1;
+#endif
+};
+
+#endif // WITH_FIREBASE_TRACE_FILE_SINK
@@ -0,0 +1,93 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#include "Performance/FirebaseTracePool.h"
+#include "FirebaseFeatures.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+FFirebaseTracePool& FFirebaseTracePool::Get()
+{
+	static FFirebaseTracePool Pool;
+	return Pool;
+}
+
+FFirebaseTrace FFirebaseTracePool::Acquire(const uint32 NameHash, const TCHAR* Name)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// Only prewarmed names are pooled: pooling every acquired name would keep traces
+		// ready, forever, for names used once.
+		FEntry* const Entry = Entries.Find(NameHash);
+
+		if (Entry && Entry->Name.Equals(Name, ESearchCase::CaseSensitive))
+		{
+			if (Entry->FreeTraces.Num() > 0)
+			{
+				FFirebaseTrace Trace = Entry->FreeTraces.Pop(false);
+
+				RefillEntry(NameHash, *Entry);
+
+				return Trace;
+			}
+
+			RefillEntry(NameHash, *Entry);
+		}
+	}
+
+	return UFirebasePerformanceLibrary::CreateTrace(Name);
+}
+
+void FFirebaseTracePool::Prewarm(const uint32 NameHash, const FString& Name, const int32 Count)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (FEntry* const Entry = FindOrAddEntry(NameHash, *Name))
+	{
+		Entry->TargetCount = FMath::Max(Entry->TargetCount, Count);
+
+		RefillEntry(NameHash, *Entry);
+	}
+}
+
+FFirebaseTracePool::FEntry* FFirebaseTracePool::FindOrAddEntry(const uint32 NameHash, const TCHAR* Name)
+{
+	FEntry* Entry = Entries.Find(NameHash);
+
+	if (!Entry)
+	{
+		Entry = &Entries.Add(NameHash);
+		Entry->Name = Name;
+	}
+	else if (!Entry->Name.Equals(Name, ESearchCase::CaseSensitive))
+	{
+		UE_LOG(LogFirebasePerformance, Warning, TEXT("Trace names %s and %s have the same hash. Trace %s won't be pooled."), *Entry->Name, Name, Name);
+		return nullptr;
+	}
+
+	return Entry;
+}
+
+void FFirebaseTracePool::RefillEntry(const uint32 NameHash, FEntry& Entry)
+{
+	while (Entry.FreeTraces.Num() + Entry.PendingRefills < Entry.TargetCount)
+	{
+		++Entry.PendingRefills;
+
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, NameHash, Name = Entry.Name]() -> void
+		{
+			FFirebaseTrace NewTrace = UFirebasePerformanceLibrary::CreateTrace(Name);
+
+			FScopeLock ScopeLock(&Lock);
+
+			FEntry& RefilledEntry = Entries.FindChecked(NameHash);
+
+			if (NewTrace.IsValid())
+			{
+				RefilledEntry.FreeTraces.Add(MoveTemp(NewTrace));
+			}
+
+			--RefilledEntry.PendingRefills;
+		});
+	}
+}
@@ -0,0 +1,53 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Performance/FirebasePerformanceLibrary.h"
+
+/**
+ * Keeps pre-created, not yet started, native traces per prewarmed trace name so that starting
+ * a trace doesn't have to create it first. Native traces can't be restarted once stopped, so
+ * each acquired trace is replaced by a new one created on a background thread.
+ * Names that weren't prewarmed aren't pooled: their traces are created when acquired.
+ */
+class FFirebaseTracePool
+{
+public:
+	static FFirebaseTracePool& Get();
+
+	/**
+	 * Takes a pre-created trace for Name or creates one if none is available or Name
+	 * wasn't prewarmed. Thread-safe.
+	 *
+	 * @param NameHash The hash of Name, as computed by FirebasePerformance::HashTraceName().
+	 * @param Name The name of the trace.
+	 * @return The trace, not started.
+	 */
+	FFirebaseTrace Acquire(const uint32 NameHash, const TCHAR* Name);
+
+	/**
+	 * Makes sure at least Count traces are kept ready for Name, creating the missing
+	 * ones on a background thread. Thread-safe.
+	 */
+	void Prewarm(const uint32 NameHash, const FString& Name, const int32 Count);
+
+private:
+	struct FEntry
+	{
+		FString Name;
+		TArray<FFirebaseTrace> FreeTraces;
+		int32 PendingRefills = 0;
+		int32 TargetCount = 0;
+	};
+
+	/** Returns nullptr on hash collision. Must be called with Lock held. */
+	FEntry* FindOrAddEntry(const uint32 NameHash, const TCHAR* Name);
+
+	/** Must be called with Lock held. */
+	void RefillEntry(const uint32 NameHash, FEntry& Entry);
+
+private:
+	FCriticalSection Lock;
+	TMap<uint32, FEntry> Entries;
+};
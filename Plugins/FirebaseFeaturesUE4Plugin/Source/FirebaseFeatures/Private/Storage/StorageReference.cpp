@@ -5,6 +5,7 @@
 #include "FirebaseFeatures.h"
 
 #include "Async/Async.h"
+#include "FirebaseSdk/FirebaseEventDispatcher.h"
 
 #if WITH_FIREBASE_STORAGE
 THIRD_PARTY_INCLUDES_START
@@ -317,6 +318,7 @@ public:
 	) 
 		: OnProgressEvent(OnProgress)
 		, OnPausedEvent(OnProgress)
+		, ProgressChannel(FFirebaseEventDispatcher::CreateChannel())
 	{
 	}
 	virtual ~FStorageListener()
@@ -329,7 +331,7 @@ public:
 			FFirebaseStorageController Controller;
 			*Controller.Controller = *controller;
 			
-			AsyncTask(ENamedThreads::GameThread, [Local = this->OnPausedEvent, Controller = MoveTemp(Controller)]() mutable -> void
+			FFirebaseEventDispatcher::Get().Dispatch([Local = this->OnPausedEvent, Controller = MoveTemp(Controller)]() mutable -> void
 			{
 				Local.ExecuteIfBound(Controller);
 			});
@@ -343,7 +345,8 @@ public:
 			*Controller.Controller = *controller;
 			
 			const FFirebaseStorageControllerCallback& Local = OnProgressEvent;
-			AsyncTask(ENamedThreads::GameThread, [Local, Controller = MoveTemp(Controller)]() mutable -> void
+			// Only the latest progress matters.
+			FFirebaseEventDispatcher::Get().Dispatch(ProgressChannel, [Local, Controller = MoveTemp(Controller)]() mutable -> void
 			{
 				Local.ExecuteIfBound(Controller);
 			});
@@ -352,6 +355,7 @@ public:
 private:
 	FFirebaseStorageControllerCallback OnProgressEvent;
 	FFirebaseStorageControllerCallback OnPausedEvent;
+	FFirebaseEventDispatcher::FChannelRef ProgressChannel;
 };
 #endif
 
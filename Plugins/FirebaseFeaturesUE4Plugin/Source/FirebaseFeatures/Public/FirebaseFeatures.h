@@ -197,6 +197,10 @@ private:
 	void InitRemoteConfig();
 	void InitStorage();
 	void InitCrashlytics();
+	void InitPerformance();
+
+	void StartTraceRecording();
+	void StopTraceRecording();
 
 	static firebase::App* GetApp();
 	static void CreateApp();
@@ -217,6 +221,8 @@ private:
 
 	TSharedPtr<class FFirebaseAnalyticsProvider> AnalyticsProvider;
 
+	TSharedPtr<class IFirebaseTraceSink, ESPMode::ThreadSafe> TraceRecorder;
+
 	static FOnAuthEvent OnAuthStateChangedEvent;
 	static FOnAuthEvent OnIdTokenChangedEvent;
 
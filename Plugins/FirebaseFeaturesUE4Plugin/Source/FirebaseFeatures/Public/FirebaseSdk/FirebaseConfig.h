@@ -91,6 +91,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Google Play Games", Meta = (DisplayName = "Enable Google Play Games Sign In (Android)"))
 	bool bEnableGooglePlayGamesSignIn = false;
 
+	/**
+	 * Time in milliseconds the listeners' events can use on the game thread per tick. The remaining
+	 * events are run on the next ticks. Zero removes the limit.
+	 * Can be changed at runtime with FFirebaseEventDispatcher::SetBudget().
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Events", Meta = (DisplayName = "Event Dispatch Budget (ms)", ClampMin = "0"))
+	float EventDispatchBudget = 2.f;
+
 	// Gets the host of the Firestore backend to connect to.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Host"))
 	FString Host;
@@ -103,6 +111,59 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Persistence Enabled"))
 	bool bPersistenceEnabled = true;
 
+	/**
+	 * Time in seconds during which document writes made from the game thread are queued and merged
+	 * before being committed in one write batch. Zero disables coalescing.
+	 * Can be changed at runtime with UFirestore::SetWriteCoalescingWindow().
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Write Coalescing Window", ClampMin = "0"))
+	float WriteCoalescingWindow = 0.f;
+
+	/**
+	 * Memory, in KB, the query results cached by FFirestoreQueryResultCache can use.
+	 * Zero disables the cache.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Query Result Cache Size (KB)", ClampMin = "0"))
+	int32 QueryResultCacheSizeKB = 4096;
+
+	/**
+	 * On Linux, snapshot listeners poll their document or query. Interval in seconds between
+	 * two polls of a listener whose results just changed. The interval grows up to the maximum
+	 * while the results don't change.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Snapshot Polling Min Interval", ClampMin = "0.1"))
+	float SnapshotPollingMinInterval = 1.f;
+
+	// Interval in seconds between two polls of a snapshot listener whose results don't change.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Firestore", Meta = (DisplayName = "Snapshot Polling Max Interval", ClampMin = "0.1"))
+	float SnapshotPollingMaxInterval = 30.f;
+
+	/**
+	 * Default interval, in seconds, at which FFirebaseTraceAccumulator pushes the accumulated metric deltas
+	 * to Firebase Performance. Zero disables automatic flushes.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Performance", Meta = (DisplayName = "Accumulator Flush Interval", ClampMin = "0"))
+	float PerformanceAccumulatorFlushInterval = 5.f;
+
+	/**
+	 * Names of the traces for which native traces are pre-created at startup so that
+	 * UFirebasePerformanceLibrary::AcquireTrace() doesn't have to create them.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Performance", Meta = (DisplayName = "Prewarmed Trace Names"))
+	TArray<FString> PrewarmedTraceNames;
+
+	/**
+	 * If traces are recorded to Saved/Profiling/FirebaseTraces on Windows, Mac and Linux, where there is no
+	 * Firebase Performance SDK. Recording is also enabled with -FirebaseTraceFile=<Path>.
+	 * Recorded files are converted with -run=FirebaseTraceConvert.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Performance", Meta = (DisplayName = "Record Desktop Traces"))
+	bool bRecordDesktopTraces = false;
+
+	// Size of the desktop trace file in MB. The oldest records are overwritten once it's full.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, config, Category = "Performance", Meta = (DisplayName = "Desktop Trace File Size (MB)", ClampMin = "1"))
+	int32 DesktopTraceFileSizeMB = 16;
+
 	/**
  	 * If true, the crashes will be sent automatically, without displaying additional information.
 	 * If false, from the beginning information will be received about past crushes, and only then they will be sent.
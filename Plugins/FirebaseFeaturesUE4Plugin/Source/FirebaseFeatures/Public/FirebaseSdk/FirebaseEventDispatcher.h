@@ -0,0 +1,89 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+
+#include <atomic>
+
+/**
+ * Runs the events of the SDK's listeners on the game thread.
+ *
+ * SDK threads push events to a lock-free queue that the game thread drains once per
+ * tick, instead of creating a task for each event. Draining stops when the frame's
+ * budget is used and the remaining events run on the next ticks, in order.
+ *
+ * Listeners whose events carry their whole state (a document's snapshot, a value, ...)
+ * dispatch them on a channel: an event is skipped if a newer event of the same channel
+ * was queued after it, so a listener that fires faster than the game thread drains
+ * only costs one callback per drain.
+ */
+class FIREBASEFEATURES_API FFirebaseEventDispatcher
+{
+public:
+	/** Identifies the events of one listener. Events of a channel supersede each other. */
+	struct FChannel
+	{
+		std::atomic<uint64> LastSerial { 0 };
+	};
+
+	using FChannelRef = TSharedRef<FChannel, ESPMode::ThreadSafe>;
+
+	static FFirebaseEventDispatcher& Get();
+
+	/** @return A new channel for a listener's events. */
+	static FChannelRef CreateChannel();
+
+	/**
+	 * Queues an event to run on the game thread. Thread-safe.
+	 * @param Event The event.
+	 */
+	void Dispatch(TUniqueFunction<void()>&& Event);
+
+	/**
+	 * Queues an event that supersedes the events of the channel still queued. Thread-safe.
+	 * @param Channel The listener's channel.
+	 * @param Event The event.
+	 */
+	void Dispatch(const FChannelRef& Channel, TUniqueFunction<void()>&& Event);
+
+	/** Runs all the queued events, regardless of the budget. Game thread only. */
+	void Flush();
+
+	/** Sets the time in seconds the events can use per tick. Zero removes the limit. */
+	void  SetBudget(const float Seconds);
+	float GetBudget() const;
+
+	/** @return The number of events queued and not run yet, including superseded ones. */
+	int32 GetNumPendingEvents() const;
+
+private:
+	struct FEvent
+	{
+		TUniqueFunction<void()> Function;
+		TSharedPtr<FChannel, ESPMode::ThreadSafe> Channel;
+		uint64 Serial = 0;
+	};
+
+	FFirebaseEventDispatcher();
+
+	void Enqueue(FEvent&& Event);
+	void RegisterTicker();
+
+	bool HandleTick(float DeltaTime);
+
+	/** Runs the queued events until the queue is empty or the time limit is reached. */
+	void Drain(const double EndTime);
+
+private:
+	TQueue<FEvent, EQueueMode::Mpsc> Queue;
+
+	std::atomic<int32> NumPendingEvents;
+	std::atomic<bool>  bTickerRegistered;
+
+	float Budget;
+
+	FDelegateHandle TickerHandle;
+};
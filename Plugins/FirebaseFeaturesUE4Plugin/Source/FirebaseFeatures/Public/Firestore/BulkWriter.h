@@ -0,0 +1,150 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/FieldPath.h"
+#include "Firestore/FieldValue.h"
+
+/** Progress of a bulk writer. */
+struct FIREBASEFEATURES_API FFirestoreBulkWriterStats
+{
+	/** Writes added to the writer. */
+	int32 NumWrites = 0;
+
+	/** Writes committed successfully. */
+	int32 NumCommittedWrites = 0;
+
+	/** Writes of the batches that failed after all their attempts. */
+	int32 NumFailedWrites = 0;
+
+	/** Batches committed successfully. */
+	int32 NumCommittedBatches = 0;
+
+	/** Commits retried after a transient error. */
+	int32 NumRetries = 0;
+
+	/** Time in seconds since the first write was added. */
+	double ElapsedSeconds = 0.;
+
+	/** Committed writes per second since the first write was added. */
+	double WritesPerSecond = 0.;
+
+	/** Error of the first batch that failed after all its attempts. */
+	EFirestoreError FirstError = EFirestoreError::Ok;
+};
+
+DECLARE_DELEGATE_OneParam(FFirestoreBulkWriterCallback, const FFirestoreBulkWriterStats&);
+
+struct FFirestoreBulkWriterSettings
+{
+	/** Writes per batch. Firestore doesn't accept more than 500. */
+	int32 BatchSize = 500;
+
+	/** Batches committed concurrently. */
+	int32 MaxInFlightBatches = 8;
+
+	/** Attempts of a batch before its writes are counted as failed. */
+	int32 MaxAttempts = 5;
+
+	/** Delay in seconds before the first retry of a batch, doubled on each retry. */
+	float InitialBackoff = 0.5f;
+
+	/** Maximum delay in seconds before retrying a batch. */
+	float MaxBackoff = 30.f;
+};
+
+/**
+ * Writes an unbounded number of documents by splitting the writes in batches and
+ * committing several batches concurrently.
+ *
+ * Writes are converted to native values when added and sent as soon as a batch is
+ * full. Batches failing with a transient error (unavailable, aborted, deadline
+ * exceeded, ...) are retried with an exponential backoff. Errors that don't tell if the
+ * batch was applied (unknown, internal, deadline exceeded) are only retried for batches
+ * without increments or array unions and removals. Writes of different batches
+ * aren't atomic together and can be applied in any order: a document should only be
+ * written once per writer.
+ *
+ * Game thread only. The writer stays alive until its last batch completes.
+ *
+ * @code
+ * TSharedRef<FFirestoreBulkWriter> Writer = FFirestoreBulkWriter::Create();
+ * for (UFirestoreDocumentReference* const Document : Documents)
+ * {
+ *     Writer->Set(Document, Data);
+ * }
+ * Writer->Close(FFirestoreBulkWriterCallback::CreateLambda([](const FFirestoreBulkWriterStats& Stats) { ... }));
+ * @endcode
+ */
+class FIREBASEFEATURES_API FFirestoreBulkWriter : public TSharedFromThis<FFirestoreBulkWriter, ESPMode::ThreadSafe>
+{
+public:
+	static TSharedRef<FFirestoreBulkWriter, ESPMode::ThreadSafe> Create(const FFirestoreBulkWriterSettings& Settings = FFirestoreBulkWriterSettings());
+
+	~FFirestoreBulkWriter();
+
+	FFirestoreBulkWriter(const FFirestoreBulkWriter&) = delete;
+	FFirestoreBulkWriter& operator=(const FFirestoreBulkWriter&) = delete;
+
+	/** Adds a write setting the document's fields. */
+	void Set(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data,
+		const FFirestoreSetOptions& Options = FFirestoreSetOptions());
+
+	/** Adds a write updating the document's fields. Fields can contain dots to reference nested fields. */
+	void Update(UFirestoreDocumentReference* const Document, const TMap<FString, FFirestoreFieldValue>& Data);
+
+	/** Adds a write updating the document's fields. */
+	void Update(UFirestoreDocumentReference* const Document, const TMap<FFirestoreFieldPath, FFirestoreFieldValue>& Data);
+
+	/** Adds a write deleting the document. */
+	void Delete(UFirestoreDocumentReference* const Document);
+
+	/** Sends the current batch even if it isn't full. */
+	void Flush();
+
+	/**
+	 * Sends the remaining writes. No write can be added once closed.
+	 *
+	 * @param Callback Called on the game thread once all the batches completed.
+	 */
+	void Close(FFirestoreBulkWriterCallback Callback);
+
+	/** Called on the game thread each time a batch completes. */
+	FFirestoreBulkWriterCallback OnProgress;
+
+	/** @return The progress of the writer. */
+	FFirestoreBulkWriterStats GetStats() const;
+
+private:
+	struct FBatch;
+	using FBatchPtr = TSharedPtr<FBatch, ESPMode::ThreadSafe>;
+
+	explicit FFirestoreBulkWriter(const FFirestoreBulkWriterSettings& InSettings);
+
+	FBatch& GetCurrentBatch();
+	void OnWriteAdded();
+
+	void SendBatches();
+	void CommitBatch(const FBatchPtr& Batch);
+	void HandleBatchCompleted(const FBatchPtr& Batch, const EFirestoreError Error);
+	void TryComplete();
+
+	void UpdateStats();
+
+private:
+	const FFirestoreBulkWriterSettings Settings;
+
+	FBatchPtr CurrentBatch;
+	TArray<FBatchPtr> QueuedBatches;
+
+	int32 NumInFlightBatches;
+	int32 NumWaitingRetries;
+
+	double StartTime;
+	FFirestoreBulkWriterStats Stats;
+
+	bool bClosed;
+	FFirestoreBulkWriterCallback CompletionCallback;
+};
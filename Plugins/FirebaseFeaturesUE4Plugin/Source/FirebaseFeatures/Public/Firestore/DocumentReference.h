@@ -6,6 +6,7 @@
 #include "Firestore.h"
 #include "FirebaseFeatures.h"
 #include "Firestore/DocumentSnapshot.h"
+#include "Firestore/Query.h"
 #include "DocumentReference.generated.h"
 
 class UFirestoreCollectionReference;
@@ -104,6 +105,27 @@ public:
 		const FFirestoreSetOptions& Options = FFirestoreSetOptions(), FFirestoreCallback Callback = FFirestoreCallback());
 	void Set(const TMap<FString, FFirestoreFieldValue>& Data, FFirestoreCallback Callback = FFirestoreCallback());
 
+	/**
+	 * @brief Writes the properties of a struct to the document referred to by
+	 * this DocumentReference, one field per property named after it.
+	 *
+	 * Nested structs are written as maps. Properties that can't be stored in
+	 * Firestore are skipped.
+	 *
+	 * @param Struct The type of StructData.
+	 * @param StructData The struct to write.
+	 * @param Options An object to configure the Set() behavior (optional).
+	 * @param Callback A Callback that will be resolved when the write finishes.
+	 */
+	void SetStruct(const UStruct* Struct, const void* StructData,
+		const FFirestoreSetOptions& Options = FFirestoreSetOptions(), FFirestoreCallback Callback = FFirestoreCallback());
+
+	template<typename StructType>
+	void SetStruct(const StructType& Value, const FFirestoreSetOptions& Options = FFirestoreSetOptions(), FFirestoreCallback Callback = FFirestoreCallback())
+	{
+		SetStruct(StructType::StaticStruct(), &Value, Options, MoveTemp(Callback));
+	}
+
 	/**
 	 * @brief Updates fields in the document referred to by this
 	 * DocumentReference.
@@ -169,13 +191,14 @@ public:
      *
      * @param callback The callback to call. When this function is
      * called, snapshot value is valid if and only if error is Ok.
+     * @return An handle to remove the listener.
      *
-     * @note This method is not available when using the STLPort C++ runtime
-     * library.
+     * @note On Linux, the document is polled and the callback is called
+     * when it changed. Polling stops once the callback's object is destroyed.
      */
 	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|DocumentReference", meta = (Keywords = "listener add setup snapshot"))
-	void AddSnapshotListener(UPARAM(DisplayName = "Listener") FDocumentSnapshotListener Callback);
-	void AddSnapshotListener(FDocumentSnapshotListenerCallback Callback);
+	UPARAM(DisplayName = "Handle") FQuerySnapshotListenerHandle AddSnapshotListener(UPARAM(DisplayName = "Listener") FDocumentSnapshotListener Callback);
+	FQuerySnapshotListenerHandle AddSnapshotListener(FDocumentSnapshotListenerCallback Callback);
 
 	firebase::firestore::DocumentReference* GetInternal() const;
 
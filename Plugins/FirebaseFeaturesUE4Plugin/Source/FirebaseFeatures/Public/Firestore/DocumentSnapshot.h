@@ -80,6 +80,11 @@ private:
     friend class UFirestoreQuery;
     friend class UFirestoreDocumentChange;
     friend struct FFirestoreTransaction;
+    friend class FFirestoreQueryResultCache;
+    friend struct FFirestoreQuerySnapshotDiff;
+    friend class FFirestoreTransactionRunner;
+    friend class FFirestoreQueryCursor;
+    friend class FFirestoreMultiGet;
 
 #if WITH_FIREBASE_FIRESTORE
     FFirestoreDocumentSnapshot(const firebase::firestore::DocumentSnapshot& InSnapshot);
@@ -132,10 +137,36 @@ public:
      *
      * @return A map containing all fields in the document, or an empty map if the
      * document doesn't exist.
+     *
+     * @see FFirestoreDocumentView to read a few fields without converting the whole document.
      */
     TMap<FString, FFirestoreFieldValue> GetData(
         EFirestoreServerTimestampBehavior ServerTimestampBehavior = EFirestoreServerTimestampBehavior::Default) const;
 
+    /**
+     * @brief Reads the document's fields into the properties of a struct, the
+     * counterpart of UFirestoreDocumentReference::SetStruct().
+     *
+     * Properties without a matching field are left untouched.
+     *
+     * @param Struct The type of StructData.
+     * @param StructData The struct to fill.
+     * @param ServerTimestampBehavior Configures how server timestamps that have not yet
+     * been set to their final value are returned from the snapshot (optional).
+     *
+     * @return False if the document doesn't exist or if a field couldn't be
+     * converted to its property.
+     */
+    bool ToStruct(const UStruct* Struct, void* StructData,
+        EFirestoreServerTimestampBehavior ServerTimestampBehavior = EFirestoreServerTimestampBehavior::Default) const;
+
+    template<typename StructType>
+    bool ToStruct(StructType& OutValue,
+        EFirestoreServerTimestampBehavior ServerTimestampBehavior = EFirestoreServerTimestampBehavior::Default) const
+    {
+        return ToStruct(StructType::StaticStruct(), &OutValue, ServerTimestampBehavior);
+    }
+
     /**
      * @brief Retrieves a specific field from the document.
      *
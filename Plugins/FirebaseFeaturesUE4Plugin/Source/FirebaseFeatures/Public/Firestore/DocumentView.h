@@ -0,0 +1,232 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/FieldValue.h"
+#include "Firestore/FieldPath.h"
+#include "Firestore/DocumentSnapshot.h"
+
+#if WITH_FIREBASE_FIRESTORE
+	THIRD_PARTY_INCLUDES_START
+#		include "firebase/firestore/field_value.h"
+#		include "firebase/firestore/map_field_value.h"
+#		include "firebase/firestore/document_snapshot.h"
+	THIRD_PARTY_INCLUDES_END
+#endif // WITH_FIREBASE_FIRESTORE
+
+struct FFirestoreArrayView;
+struct FFirestoreMapView;
+
+/**
+ * The name of a field, converted to UTF-8 once. Names are case-sensitive.
+ * Keep one around, as a static for example, for fields read often.
+ */
+struct FIREBASEFEATURES_API FFirestoreFieldKey
+{
+public:
+	FFirestoreFieldKey(const TCHAR* const Name);
+	FFirestoreFieldKey(const FString& Name);
+
+#if WITH_FIREBASE_FIRESTORE
+	const std::string& Get() const { return Utf8; }
+
+private:
+	std::string Utf8;
+#endif // WITH_FIREBASE_FIRESTORE
+};
+
+/**
+ * Typed accessors shared by the views. Each one reads the value returned by
+ * the view's GetValue() for the key and returns the default value if the
+ * field is missing or has another type.
+ */
+template<typename ViewType>
+struct TFirestoreTypedAccessors
+{
+	template<typename KeyType>
+	EFirestoreFieldValueType GetType(const KeyType& Key) const { return View().GetValue(Key).GetType(); }
+
+	template<typename KeyType>
+	bool Contains(const KeyType& Key) const { return View().GetValue(Key).IsValid(); }
+
+	template<typename KeyType>
+	bool GetBool(const KeyType& Key, const bool bDefault = false) const { return View().GetValue(Key).GetBool(bDefault); }
+
+	template<typename KeyType>
+	int64 GetInt64(const KeyType& Key, const int64 Default = 0) const { return View().GetValue(Key).GetInt64(Default); }
+
+	template<typename KeyType>
+	double GetDouble(const KeyType& Key, const double Default = 0.) const { return View().GetValue(Key).GetDouble(Default); }
+
+	template<typename KeyType>
+	FString GetString(const KeyType& Key, const FString& Default = FString()) const { return View().GetValue(Key).GetString(Default); }
+
+	template<typename KeyType>
+	FFirestoreTimestamp GetTimestamp(const KeyType& Key) const { return View().GetValue(Key).GetTimestamp(); }
+
+	template<typename KeyType>
+	FFirestoreGeoPoint GetGeoPoint(const KeyType& Key) const { return View().GetValue(Key).GetGeoPoint(); }
+
+	template<typename KeyType>
+	FFirestoreArrayView GetArrayView(const KeyType& Key) const;
+
+	template<typename KeyType>
+	FFirestoreMapView GetMapView(const KeyType& Key) const;
+
+private:
+	const ViewType& View() const
+	{
+		return static_cast<const ViewType&>(*this);
+	}
+};
+
+/**
+ * A read-only view of a single field value.
+ *
+ * A value view either owns the native value, when it was read from a
+ * document, or borrows it from the array or map view it was read from. A
+ * borrowing view must not outlive that array or map view.
+ */
+struct FIREBASEFEATURES_API FFirestoreValueView
+{
+public:
+	FFirestoreValueView();
+	FFirestoreValueView(const FFirestoreValueView& Other);
+	FFirestoreValueView(FFirestoreValueView&& Other);
+
+	FFirestoreValueView& operator=(const FFirestoreValueView& Other);
+	FFirestoreValueView& operator=(FFirestoreValueView&& Other);
+
+#if WITH_FIREBASE_FIRESTORE
+	/** Takes ownership of the native value. */
+	explicit FFirestoreValueView(firebase::firestore::FieldValue&& InValue);
+
+	/** Borrows the native value, which must outlive this view. */
+	explicit FFirestoreValueView(const firebase::firestore::FieldValue* InValue);
+#endif // WITH_FIREBASE_FIRESTORE
+
+	/** @return If the field exists. */
+	bool IsValid() const;
+
+	/** @return The type of the value, Null if the field doesn't exist. */
+	EFirestoreFieldValueType GetType() const;
+
+	bool IsNull() const;
+
+	bool  GetBool (const bool  bDefault = false) const;
+	int64 GetInt64(const int64 Default  = 0)	 const;
+
+	/** @return The value as double. Integers are converted. */
+	double GetDouble(const double Default = 0.) const;
+
+	FString GetString(const FString& Default = FString()) const;
+
+	FFirestoreTimestamp GetTimestamp() const;
+	FFirestoreGeoPoint  GetGeoPoint()  const;
+
+	/** @return The bytes of a blob value, valid as long as this view. */
+	TArrayView<const uint8> GetBlob() const;
+
+	FFirestoreArrayView GetArrayView() const;
+	FFirestoreMapView   GetMapView()   const;
+
+	/** Copies the value to a field value, for APIs that need one. */
+	FFirestoreFieldValue ToFieldValue() const;
+
+private:
+#if WITH_FIREBASE_FIRESTORE
+	firebase::firestore::FieldValue Owned;
+	const firebase::firestore::FieldValue* Value = nullptr;
+#endif // WITH_FIREBASE_FIRESTORE
+};
+
+/** A read-only view of an array value. */
+struct FIREBASEFEATURES_API FFirestoreArrayView : public TFirestoreTypedAccessors<FFirestoreArrayView>
+{
+public:
+	FFirestoreArrayView() = default;
+
+#if WITH_FIREBASE_FIRESTORE
+	explicit FFirestoreArrayView(std::vector<firebase::firestore::FieldValue>&& InValues);
+#endif // WITH_FIREBASE_FIRESTORE
+
+	int32 Num() const;
+
+	/** @return A view borrowing the element at Index, invalid if Index is out of range. */
+	FFirestoreValueView GetValue(const int32 Index) const;
+
+private:
+#if WITH_FIREBASE_FIRESTORE
+	std::vector<firebase::firestore::FieldValue> Values;
+#endif // WITH_FIREBASE_FIRESTORE
+};
+
+/**
+ * A read-only view of a map value.
+ */
+struct FIREBASEFEATURES_API FFirestoreMapView : public TFirestoreTypedAccessors<FFirestoreMapView>
+{
+public:
+	FFirestoreMapView() = default;
+
+#if WITH_FIREBASE_FIRESTORE
+	explicit FFirestoreMapView(firebase::firestore::MapFieldValue&& InValues);
+#endif // WITH_FIREBASE_FIRESTORE
+
+	int32 Num() const;
+
+	/** @return A view borrowing the field's value, invalid if there is no such field. */
+	FFirestoreValueView GetValue(const FFirestoreFieldKey& Key) const;
+
+	/** Calls Callback for each field with its UTF-8 key and a view borrowing its value. */
+	void ForEach(TFunctionRef<void(const ANSICHAR* Key, const FFirestoreValueView& Value)> Callback) const;
+
+private:
+#if WITH_FIREBASE_FIRESTORE
+	firebase::firestore::MapFieldValue Values;
+#endif // WITH_FIREBASE_FIRESTORE
+};
+
+/**
+ * A read-only view over a document snapshot that reads fields on access
+ * instead of converting the whole document like FFirestoreDocumentSnapshot::GetData().
+ *
+ * Fields are looked up by name or, for nested fields and exact keys, by a
+ * field path built once and reused.
+ *
+ * The view borrows the snapshot, which must outlive it.
+ */
+struct FIREBASEFEATURES_API FFirestoreDocumentView : public TFirestoreTypedAccessors<FFirestoreDocumentView>
+{
+public:
+	explicit FFirestoreDocumentView(const FFirestoreDocumentSnapshot& InSnapshot,
+		const EFirestoreServerTimestampBehavior InServerTimestampBehavior = EFirestoreServerTimestampBehavior::Default);
+
+	/** @return True if the document exists in the snapshot. */
+	bool Exists() const;
+
+	/** @return A view owning the field's value, invalid if there is no such field. */
+	FFirestoreValueView GetValue(const FFirestoreFieldKey& Key) const;
+	FFirestoreValueView GetValue(const FFirestoreFieldPath& Path) const;
+
+private:
+#if WITH_FIREBASE_FIRESTORE
+	const firebase::firestore::DocumentSnapshot& Snapshot;
+#endif // WITH_FIREBASE_FIRESTORE
+	const EFirestoreServerTimestampBehavior ServerTimestampBehavior;
+};
+
+template<typename ViewType>
+template<typename KeyType>
+FFirestoreArrayView TFirestoreTypedAccessors<ViewType>::GetArrayView(const KeyType& Key) const
+{
+	return View().GetValue(Key).GetArrayView();
+}
+
+template<typename ViewType>
+template<typename KeyType>
+FFirestoreMapView TFirestoreTypedAccessors<ViewType>::GetMapView(const KeyType& Key) const
+{
+	return View().GetValue(Key).GetMapView();
+}
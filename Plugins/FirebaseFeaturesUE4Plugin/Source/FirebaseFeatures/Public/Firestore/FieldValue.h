@@ -109,6 +109,19 @@ public:
 	float Longitude;
 };
 
+/**
+ * Storage for the field values that fit in a few bytes and are kept
+ * inline by FFirestoreFieldValue instead of in a heap-allocated native value.
+ */
+union FFirestoreInlineFieldValue
+{
+	bool   bBoolean;
+	int64  Integer;
+	double Double;
+	struct { int64  Seconds;  int32  Nanoseconds; } Timestamp;
+	struct { double Latitude; double Longitude;   } GeoPoint;
+};
+
 /**
  * A field value represents variant datatypes as stored by Firestore.
  *
@@ -117,6 +130,10 @@ public:
  * writing document fields with DocumentReference::Set() or
  * DocumentReference::Update(), it can also represent sentinel values in
  * addition to real data values.
+ *
+ * Nulls, booleans, integers, doubles, timestamps and geo points are stored
+ * inline and don't allocate. The other types are held by a native value that
+ * is only created for them.
  */
 USTRUCT(BlueprintType)
 struct FIREBASEFEATURES_API FFirestoreFieldValue
@@ -125,9 +142,11 @@ struct FIREBASEFEATURES_API FFirestoreFieldValue
 public:
 	FFirestoreFieldValue();
 	FFirestoreFieldValue(const FFirestoreFieldValue& Other);
+	FFirestoreFieldValue(FFirestoreFieldValue&& Other);
 
 #if WITH_FIREBASE_FIRESTORE
 	FFirestoreFieldValue(const firebase::firestore::FieldValue& Value);
+	FFirestoreFieldValue(firebase::firestore::FieldValue&& Value);
 #endif // WITH_FIREBASE_FIRESTORE
 
 	FFirestoreFieldValue(const bool  bValue);
@@ -150,19 +169,27 @@ public:
 	~FFirestoreFieldValue();
 	
 	FFirestoreFieldValue& operator=(const FFirestoreFieldValue& Other);
+	FFirestoreFieldValue& operator=(FFirestoreFieldValue&& Other);
 
 	EFirestoreFieldValueType GetType() const;
 
 #if WITH_FIREBASE_FIRESTORE
-	FORCEINLINE operator firebase::firestore::FieldValue& ()
-	{
-		return *FieldValue.Get();
-	}
+	/**
+	 * Gives mutable access to the native value, creating it from the inline
+	 * value if needed. The value then stays held by the native value.
+	 */
+	operator firebase::firestore::FieldValue& ();
 
-	FORCEINLINE operator firebase::firestore::FieldValue& () const
+	FORCEINLINE operator firebase::firestore::FieldValue () const
 	{
-		return *FieldValue.Get();
+		return ToNative();
 	}
+
+	/** Creates a native value holding a copy of this value. */
+	firebase::firestore::FieldValue ToNative() const;
+
+	/** Moves this value out to a native value and leaves this one null. */
+	firebase::firestore::FieldValue MoveToNative();
 #endif  // WITH_FIREBASE_FIRESTORE
 
 	operator int32()   const;
@@ -236,11 +263,32 @@ public:
 	 */
 	static FFirestoreFieldValue ArrayRemove(const TArray<FFirestoreFieldValue>& Elements);
 
+	/**
+	 * Returns a special value that can be used with Set() or Update() that tells
+	 * the server to increment the field's current value by the given value. If
+	 * the field is not a number or doesn't exist, it is set to the given value.
+	 *
+	 * @param ByValue The value to add to the field.
+	 * @return The FieldValue sentinel for use in a call to Set() or Update().
+	 */
+	static FFirestoreFieldValue Increment(const int64 ByValue);
+	static FFirestoreFieldValue Increment(const double ByValue);
+
 private:
 #if WITH_FIREBASE_FIRESTORE
 	void SetValue(const firebase::firestore::FieldValue& Value);
+	void SetValue(firebase::firestore::FieldValue&& Value);
+	bool IsInline() const { return !FieldValue.IsValid(); }
+
+	/** Set for the types not stored inline and once exposed as mutable native value. */
 	TUniquePtr<firebase::firestore::FieldValue> FieldValue;
+#else
+	bool IsInline() const { return true; }
 #endif
+
+	/** Type of the inline value. Only meaningful when there is no native value. */
+	EFirestoreFieldValueType InlineType = EFirestoreFieldValueType::Null;
+	FFirestoreInlineFieldValue Inline;
 };
 
 
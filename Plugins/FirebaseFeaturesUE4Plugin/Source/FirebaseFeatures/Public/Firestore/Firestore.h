@@ -16,6 +16,7 @@
 #endif 
 
 DECLARE_DELEGATE_OneParam(FFirestoreCallback, const EFirestoreError);
+DECLARE_DELEGATE_TwoParams(FFirestoreDocumentsCallback, const EFirestoreError, const TArray<FFirestoreDocumentSnapshot>&);
 
 namespace firebase { namespace firestore { 
 	class Firestore; 
@@ -145,6 +146,8 @@ public:
 	 */
 	static FFirestoreSetOptions MergeFieldPaths(const TArray<FFirestoreFieldPath>& Fields);
 
+	/** @return How Set() calls using these options write the document. */
+	EFirestoreSetOptionsType GetType() const { return Type; }
 
 #if WITH_FIREBASE_FIRESTORE
 	FORCEINLINE operator firebase::firestore::SetOptions&()
@@ -162,6 +165,8 @@ private:
 #if WITH_FIREBASE_FIRESTORE
 	TUniquePtr<firebase::firestore::SetOptions> Options;
 #endif
+
+	EFirestoreSetOptionsType Type = EFirestoreSetOptionsType::Overwrite;
 };
 
 USTRUCT(BlueprintType)
@@ -246,6 +251,8 @@ struct FIREBASEFEATURES_API FWriteBatch
 	GENERATED_BODY()
 public:
 	FWriteBatch();
+	FWriteBatch(const FWriteBatch& Other);
+	FWriteBatch(FWriteBatch&& Other);
 	~FWriteBatch();
 
 	FWriteBatch& operator=(const FWriteBatch& Other);
@@ -303,6 +310,12 @@ public:
 	void Commit(const FFirestoreCallback& Callback);
 
 private:
+	friend class UFirestore;
+
+#if WITH_FIREBASE_FIRESTORE
+	FWriteBatch(firebase::firestore::WriteBatch&& InBatch);
+#endif // WITH_FIREBASE_FIRESTORE
+
 	TUniquePtr<firebase::firestore::WriteBatch> Batch;
 };
 
@@ -336,6 +349,18 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Firebase|Firestore")
 	static UPARAM(DisplayName = "Document") UFirestoreDocumentReference* GetDocument(const FString& DocumentPath);
 
+	/**
+	 * Reads several documents at once. The reads run concurrently, up to 16 at a time,
+	 * and documents requested several times are read once.
+	 *
+	 * @param Documents The documents to read.
+	 * @param Source The source the documents are read from.
+	 * @param Callback Called once all the reads completed, with the snapshots in the same
+	 * order as Documents and the first error if any. Snapshots of failed reads are empty.
+	 */
+	static void GetAll(const TArray<UFirestoreDocumentReference*>& Documents, const EFirestoreSource Source, FFirestoreDocumentsCallback Callback);
+	static void GetAll(const TArray<UFirestoreDocumentReference*>& Documents, FFirestoreDocumentsCallback Callback);
+
 
 	/**
 	 * @brief Returns a Query instance that includes all documents in the
@@ -376,6 +401,45 @@ public:
 	 */
 	static void RunTransaction(const FFirestoreTransactionCallback& Transaction, const FFirestoreCallback& Callback);
 
+	/**
+	 * Creates a write batch, used for performing multiple writes as a single
+	 * atomic operation.
+	 *
+	 * @return The created WriteBatch.
+	 */
+	static FWriteBatch Batch();
+
+	/**
+	 * Sets the time during which Set(), Update() and Delete() calls made on document references from
+	 * the game thread are queued before being committed together in one write batch.
+	 *
+	 * Queued writes to the same document are merged when the result is the same: later
+	 * field values replace earlier ones and a Set() without merge or a Delete() drops the
+	 * writes queued before it. Callbacks of the merged writes are all called with the result
+	 * of the batch.
+	 *
+	 * Writes of unrelated callers are committed in the same atomic batch. If the batch is
+	 * rejected because of one write (permissions, missing document for an update, ...), the
+	 * documents of the batch are committed again one by one, so only the callbacks of the
+	 * rejected document's writes get the error. Writes to different documents that must
+	 * succeed or fail together must use Batch() instead.
+	 *
+	 * @param Seconds The coalescing window. Zero commits the queued writes and disables coalescing.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore")
+	static void SetWriteCoalescingWindow(const float Seconds);
+
+	/** @return The write coalescing window in seconds, zero if writes aren't coalesced. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Firebase|Firestore")
+	static float GetWriteCoalescingWindow();
+
+	/**
+	 * Commits the writes queued by the write coalescer without waiting for the end of the window.
+	 *
+	 * @param Callback Called once all the queued writes are committed, with the first error if any.
+	 */
+	static void FlushCoalescedWrites(const FFirestoreCallback& Callback = FFirestoreCallback());
+
 	/**
 	 * Sets the log verbosity of all Firestore instances.
 	 *
@@ -430,6 +494,8 @@ public:
 	//static void SetPersistenceEnabled(const bool bEnabled);
 
 private:
+	friend class FFirestoreTransactionRunner;
+
 #if WITH_FIREBASE_FIRESTORE
 	static firebase::firestore::Firestore* GetFirestore();
 #endif // WITH_FIREBASE_FIRESTORE
@@ -16,12 +16,14 @@ THIRD_PARTY_INCLUDES_END
 #endif // WITH_FIREBASE_FIRESTORE 
 
 #include "Firestore/DocumentSnapshot.h"
+#include "Firestore/QuerySnapshotDiff.h"
 #include "Firestore/FieldValue.h"
 #include "Firestore/FieldPath.h"
 #include "Firestore/Firestore.h"
 #include "Query.generated.h"
 
 DECLARE_DELEGATE_ThreeParams(FFirestoreQueryCallback, EFirestoreError, TArray<FFirestoreDocumentSnapshot>, TArray<class UFirestoreDocumentChange*>);
+DECLARE_DELEGATE_TwoParams(FFirestoreCachedQueryCallback, const EFirestoreError, const TArray<FFirestoreDocumentSnapshot>&);
 
 class UFirestoreDocumentChange;
 
@@ -40,6 +42,8 @@ DECLARE_DELEGATE_ThreeParams(
 		const TArray<UFirestoreDocumentChange*>&
 );
 
+DECLARE_DELEGATE_TwoParams(FQuerySnapshotDiffListenerCallback, const EFirestoreError, const FFirestoreQuerySnapshotDiff&);
+
 UENUM(BlueprintType)
 enum class EFirestoreQueryDirection : uint8
 {
@@ -76,10 +80,18 @@ public:
 	*/
 	void Remove();
 
+private:
+	friend class UFirestoreQuery;
+	friend class UFirestoreDocumentReference;
+
+	/** Handle of a listener emulated by polling, on platforms without the SDK's listeners. */
+	explicit FQuerySnapshotListenerHandle(const uint64 InPolledListenerId);
+
 private:
 #if WITH_FIREBASE_FIRESTORE 
 	firebase::firestore::ListenerRegistration Listener;
 #endif
+	uint64 PolledListenerId = 0;
 };
 
 UCLASS(BlueprintType)
@@ -500,8 +512,21 @@ public:
 	void Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const;
 	void Get(FFirestoreQueryCallback Callback) const;
 
+	/**
+	 * Same as Get() but the results come from FFirestoreQueryResultCache: the query is kept
+	 * up to date with a listener so the next calls for the same query are answered
+	 * immediately, without converting the results again. No document changes are given.
+	 *
+	 * @param Source Server reads from the server without using the cache. Default only uses
+	 *				 results the listener got from the server. Cache uses any results.
+	 */
+	void GetCached(const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback) const;
+
 	/**
 	 * Adds a snapshot listener for this query.
+	 * On Linux, the query is polled and the listener is called when its results
+	 * changed. The document changes then list all the documents as added, use
+	 * AddSnapshotDiffListener() to get the actual changes.
 	 * @param Listener The listener.
 	 * @return An handle to remove the listener.
 	*/
@@ -509,9 +534,41 @@ public:
 	UPARAM(DisplayName = "Handle") FQuerySnapshotListenerHandle AddSnapshotListener(FQuerySnapshotListener Listener);
 	FQuerySnapshotListenerHandle AddSnapshotListener(FQuerySnapshotListenerCallback Callback);
 
+	/**
+	 * Adds a snapshot listener that only receives the changed documents. The full results
+	 * are converted only if FFirestoreQuerySnapshotDiff::GetDocuments() is called, which
+	 * keeps updates of large results cheap.
+	 * @param Callback The listener. The diff is only valid during the call.
+	 * @return An handle to remove the listener.
+	 */
+	FQuerySnapshotListenerHandle AddSnapshotDiffListener(FQuerySnapshotDiffListenerCallback Callback);
+
 	UFUNCTION(BlueprintPure, Category = "Firebase|Firestore|Query")
 	UPARAM(DisplayName = "Is Valid") bool IsValid() const;
 
+private:
+	friend struct FFirestoreQueryBuilder;
+	friend class FFirestoreQueryResultCache;
+
+#if WITH_FIREBASE_FIRESTORE 
+	/** Called with the previous results when the snapshot doesn't carry its changes, null otherwise. */
+	using FRawSnapshotListener = TFunction<void(const firebase::firestore::QuerySnapshot&,
+		const std::vector<firebase::firestore::DocumentSnapshot>* PreviousDocuments, const EFirestoreError)>;
+
+	static void GetNative(const firebase::firestore::Query& Query, const EFirestoreSource Source, FFirestoreQueryCallback Callback);
+	static FQuerySnapshotListenerHandle AddNativeSnapshotListener(firebase::firestore::Query& Query, FQuerySnapshotListenerCallback Callback);
+	static FQuerySnapshotListenerHandle AddNativeSnapshotDiffListener(firebase::firestore::Query& Query, FQuerySnapshotDiffListenerCallback Callback);
+
+	/** 
+	 * Adds a listener called on the SDK's thread with the native snapshot. The query is polled
+	 * on platforms without the SDK's listeners.
+	 * @param bIncludeMetadataChanges If the listener is also called when only the metadata changed.
+	 * @return The listener's handle.
+	 */
+	static FQuerySnapshotListenerHandle AddRawSnapshotListener(firebase::firestore::Query& Query, FRawSnapshotListener Listener,
+		const bool bIncludeMetadataChanges = false);
+#endif 
+
 protected:
 
 #if WITH_FIREBASE_FIRESTORE 
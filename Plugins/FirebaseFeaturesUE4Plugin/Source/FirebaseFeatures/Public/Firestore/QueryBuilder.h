@@ -0,0 +1,327 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Query.h"
+
+#if WITH_FIREBASE_FIRESTORE
+THIRD_PARTY_INCLUDES_START
+#	include "firebase/firestore/document_snapshot.h"
+#	include "firebase/firestore/field_path.h"
+#	include "firebase/firestore/field_value.h"
+THIRD_PARTY_INCLUDES_END
+
+#	include <string>
+#	include <vector>
+#endif // WITH_FIREBASE_FIRESTORE
+
+#include "QueryBuilder.generated.h"
+
+UDELEGATE()
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(
+	FQueryBuilderGetCallback,
+		const EFirestoreError, Error,
+		const TArray<FFirestoreDocumentSnapshot>&, DocumentSnapshots,
+		const TArray<UFirestoreDocumentChange*>&, DocumentChanges
+);
+
+/**
+ * Builds a query without creating a UFirestoreQuery for each clause.
+ *
+ * Clauses are stored in the builder and the native query is only created
+ * when the query is run with Get() or AddSnapshotListener(). Native queries
+ * built from the same base and clauses are cached and reused.
+ *
+ * @code
+ * FFirestoreQueryBuilder(Collection)
+ *     .WhereEqualTo(TEXT("season"), Season)
+ *     .OrderBy(TEXT("score"), EFirestoreQueryDirection::Descending)
+ *     .Limit(20)
+ *     .Get(Callback);
+ * @endcode
+ */
+struct FIREBASEFEATURES_API FFirestoreQueryBuilder
+{
+public:
+	/** Creates a builder without base query. Reset() must be called before use. */
+	FFirestoreQueryBuilder();
+
+	/** Creates a builder adding clauses to Base. */
+	explicit FFirestoreQueryBuilder(const UFirestoreQuery* Base);
+
+	FFirestoreQueryBuilder(const FFirestoreQueryBuilder& Other);
+	FFirestoreQueryBuilder(FFirestoreQueryBuilder&& Other);
+	~FFirestoreQueryBuilder();
+
+	FFirestoreQueryBuilder& operator=(const FFirestoreQueryBuilder& Other);
+	FFirestoreQueryBuilder& operator=(FFirestoreQueryBuilder&& Other);
+
+	/** Removes the clauses and sets a new base query. */
+	void Reset(const UFirestoreQuery* Base);
+
+	/** Removes the clauses. */
+	void Reset();
+
+	FFirestoreQueryBuilder& WhereEqualTo             (const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereEqualTo             (const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereLessThan            (const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereLessThan            (const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereLessThanOrEqualTo   (const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereLessThanOrEqualTo   (const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereGreaterThan         (const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereGreaterThan         (const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereGreaterThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereGreaterThanOrEqualTo(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereArrayContains       (const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereArrayContains       (const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& WhereArrayContainsAny    (const FString& Field, const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& WhereArrayContainsAny    (const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& WhereIn                  (const FString& Field, const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& WhereIn                  (const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values);
+
+	FFirestoreQueryBuilder& OrderBy(const FString& Field, const EFirestoreQueryDirection Direction = EFirestoreQueryDirection::Ascending);
+	FFirestoreQueryBuilder& OrderBy(const FFirestoreFieldPath& Field, const EFirestoreQueryDirection Direction = EFirestoreQueryDirection::Ascending);
+
+	FFirestoreQueryBuilder& Limit(const int32 Limit);
+	FFirestoreQueryBuilder& LimitToLast(const int32 Limit);
+
+	FFirestoreQueryBuilder& StartAt   (const FFirestoreDocumentSnapshot& Snapshot);
+	FFirestoreQueryBuilder& StartAt   (const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& StartAfter(const FFirestoreDocumentSnapshot& Snapshot);
+	FFirestoreQueryBuilder& StartAfter(const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& EndBefore (const FFirestoreDocumentSnapshot& Snapshot);
+	FFirestoreQueryBuilder& EndBefore (const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& EndAt     (const FFirestoreDocumentSnapshot& Snapshot);
+	FFirestoreQueryBuilder& EndAt     (const TArray<FFirestoreFieldValue>& Values);
+
+	/** Runs the query. @see UFirestoreQuery::Get() */
+	void Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const;
+	void Get(FFirestoreQueryCallback Callback) const;
+
+	/** Adds a snapshot listener for the query. @see UFirestoreQuery::AddSnapshotListener() */
+	FQuerySnapshotListenerHandle AddSnapshotListener(FQuerySnapshotListenerCallback Callback) const;
+
+	/** Adds a snapshot listener receiving only the changed documents. @see UFirestoreQuery::AddSnapshotDiffListener() */
+	FQuerySnapshotListenerHandle AddSnapshotDiffListener(FQuerySnapshotDiffListenerCallback Callback) const;
+
+	/** @return A new query object for APIs that expect one. */
+	UFirestoreQuery* ToQuery() const;
+
+	/** @return If the builder has a base query. */
+	bool IsValid() const;
+
+	/** @return A hash of the base query and clauses. Equal builders have equal hashes. */
+	uint32 GetHash() const { return Hash; }
+
+	bool operator==(const FFirestoreQueryBuilder& Other) const;
+	bool operator!=(const FFirestoreQueryBuilder& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FFirestoreQueryBuilder& Builder) { return Builder.Hash; }
+
+#if WITH_FIREBASE_FIRESTORE
+	/** @return The native query, built once per base and clauses. */
+	firebase::firestore::Query Build() const;
+#endif // WITH_FIREBASE_FIRESTORE
+
+private:
+#if WITH_FIREBASE_FIRESTORE
+	enum class EClauseType : uint8
+	{
+		WhereEqualTo,
+		WhereLessThan,
+		WhereLessThanOrEqualTo,
+		WhereGreaterThan,
+		WhereGreaterThanOrEqualTo,
+		WhereArrayContains,
+		WhereArrayContainsAny,
+		WhereIn,
+		OrderBy,
+		Limit,
+		LimitToLast,
+		StartAt,
+		StartAfter,
+		EndBefore,
+		EndAt,
+	};
+
+	struct FClause
+	{
+		EClauseType Type;
+
+		// Either a dot-separated field name or a field path.
+		std::string Field;
+		firebase::firestore::FieldPath FieldPath;
+		bool bUseFieldPath = false;
+
+		std::vector<firebase::firestore::FieldValue> Values;
+		firebase::firestore::DocumentSnapshot Snapshot;
+
+		// Limit or direction.
+		int32 Number = 0;
+
+		bool operator==(const FClause& Other) const;
+		uint32 GetHash() const;
+	};
+
+	FFirestoreQueryBuilder& AddClause(FClause&& Clause);
+	FFirestoreQueryBuilder& AddFieldClause(const EClauseType Type, const FString& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& AddFieldClause(const EClauseType Type, const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+	FFirestoreQueryBuilder& AddFieldClause(const EClauseType Type, const FString& Field, const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& AddFieldClause(const EClauseType Type, const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values);
+	FFirestoreQueryBuilder& AddCursorClause(const EClauseType Type, const FFirestoreDocumentSnapshot& Snapshot);
+	FFirestoreQueryBuilder& AddCursorClause(const EClauseType Type, const TArray<FFirestoreFieldValue>& Values);
+
+	static firebase::firestore::Query ApplyClause(const firebase::firestore::Query& Query, const FClause& Clause);
+
+	TUniquePtr<firebase::firestore::Query> Base;
+	std::vector<FClause> Clauses;
+#endif // WITH_FIREBASE_FIRESTORE
+
+	// Hash of the base query's collection path, zero if it isn't a collection.
+	uint32 BaseHash;
+	uint32 Hash;
+};
+
+/**
+ * Blueprint query builder. Clauses are added to this object instead of
+ * creating a new query object for each of them and the object can be reused
+ * for the next query with Reset().
+ */
+UCLASS(BlueprintType)
+class FIREBASEFEATURES_API UFirestoreQueryBuilder : public UObject
+{
+	GENERATED_BODY()
+public:
+	/**
+	 * Creates a query builder.
+	 * @param Query The query the clauses are added to.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	static UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* CreateQueryBuilder(UFirestoreQuery* Query);
+
+	/**
+	 * Removes the clauses to reuse the builder.
+	 * @param Query The query the next clauses are added to.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* Reset(UFirestoreQuery* Query);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereEqualTo(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereLessThan(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereLessThanFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereLessThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereLessThanOrEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereGreaterThan(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereGreaterThanFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereGreaterThanOrEqualTo(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereGreaterThanOrEqualToFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereArrayContains(const FString& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereArrayContainsFieldPath(const FFirestoreFieldPath& Field, const FFirestoreFieldValue& Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereArrayContainsAny(const FString& Field, const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereArrayContainsAnyFieldPath(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereIn(const FString& Field, const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* WhereInFieldPath(const FFirestoreFieldPath& Field, const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* OrderBy(const FString& Field,
+		EFirestoreQueryDirection Direction = EFirestoreQueryDirection::Ascending);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* OrderByFieldPath(const FFirestoreFieldPath& Field,
+		EFirestoreQueryDirection Direction = EFirestoreQueryDirection::Ascending);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* Limit(int32 Limit);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* LimitToLast(int32 Limit);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* StartAt(const FFirestoreDocumentSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* StartAtFieldValue(const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* StartAfter(const FFirestoreDocumentSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* StartAfterFieldValue(const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* EndBefore(const FFirestoreDocumentSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* EndBeforeFieldValue(const TArray<FFirestoreFieldValue>& Values);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* EndAt(const FFirestoreDocumentSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Builder") UFirestoreQueryBuilder* EndAtFieldValue(const TArray<FFirestoreFieldValue>& Values);
+
+	/**
+	 * Creates the query object for the clauses added so far, to be used with
+	 * nodes expecting a query.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Query") UFirestoreQuery* ToQuery() const;
+
+	/**
+	 * Adds a snapshot listener for the query built so far.
+	 * @param Listener The listener.
+	 * @return An handle to remove the listener.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder")
+	UPARAM(DisplayName = "Handle") FQuerySnapshotListenerHandle AddSnapshotListener(FQuerySnapshotListener Listener);
+
+	/**
+	 * Runs the query built so far.
+	 * @param Source A value to configure the get behavior. @see UFirestoreQuery::Get()
+	 * @param Callback Called with the documents of the query.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Firestore|Query Builder", meta = (DisplayName = "Get"))
+	void GetDocuments(const EFirestoreSource Source, FQueryBuilderGetCallback Callback) const;
+
+	/** Runs the query built so far. */
+	void Get(const EFirestoreSource Source, FFirestoreQueryCallback Callback) const;
+
+	FORCEINLINE FFirestoreQueryBuilder& GetBuilder() { return Builder; }
+	FORCEINLINE const FFirestoreQueryBuilder& GetBuilder() const { return Builder; }
+
+private:
+	FFirestoreQueryBuilder Builder;
+};
@@ -0,0 +1,129 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/QueryBuilder.h"
+
+#if WITH_FIREBASE_FIRESTORE
+namespace firebase { namespace firestore { class Query; class DocumentSnapshot; } }
+#endif
+
+/** Called on the game thread with the next page. An empty page without error means the query has no more results. */
+DECLARE_DELEGATE_TwoParams(FFirestoreQueryPageCallback, const EFirestoreError, const TArray<FFirestoreDocumentSnapshot>&);
+
+/** Called on the game thread with each page. Returns false to stop the iteration. */
+DECLARE_DELEGATE_RetVal_OneParam(bool, FFirestoreQueryPageDelegate, const TArray<FFirestoreDocumentSnapshot>&);
+
+struct FFirestoreQueryCursorSettings
+{
+	/** Documents per page. */
+	int32 PageSize = 500;
+
+	/** Pages read ahead of the one being consumed. */
+	int32 ReadAhead = 2;
+
+	/** Where the pages are read from. */
+	EFirestoreSource Source = EFirestoreSource::Default;
+};
+
+/**
+ * Iterates over the results of a query page by page.
+ *
+ * Pages are read with Limit() and StartAfter() the last document of the previous page,
+ * so the query must be ordered. The next pages are read while the current one is
+ * consumed: up to ReadAhead pages wait to be consumed, and a page is released once its
+ * callback returns, so memory stays bounded whatever the number of results.
+ *
+ * Pages are read one after the other as each one starts after the previous one: read-ahead
+ * hides the round trips behind the consumer's work, it doesn't parallelize them.
+ *
+ * Game thread only.
+ *
+ * @code
+ * TSharedRef<FFirestoreQueryCursor, ESPMode::ThreadSafe> Cursor = FFirestoreQueryCursor::Create(FFirestoreQueryBuilder(Players).OrderBy(TEXT("level")));
+ * Cursor->ForEachPage(FFirestoreQueryPageDelegate::CreateLambda([](const TArray<FFirestoreDocumentSnapshot>& Page) -> bool
+ * {
+ *     ...
+ *     return true;
+ * }), FFirestoreCallback::CreateLambda([](const EFirestoreError Error) { ... }));
+ * @endcode
+ */
+class FIREBASEFEATURES_API FFirestoreQueryCursor : public TSharedFromThis<FFirestoreQueryCursor, ESPMode::ThreadSafe>
+{
+public:
+	/**
+	 * Creates a cursor over the query's results and starts reading the first pages.
+	 *
+	 * @param Query The query to iterate over. Its limit and cursors are replaced.
+	 * @param Settings The settings of the cursor.
+	 */
+	static TSharedRef<FFirestoreQueryCursor, ESPMode::ThreadSafe> Create(const FFirestoreQueryBuilder& Query,
+		const FFirestoreQueryCursorSettings& Settings = FFirestoreQueryCursorSettings());
+
+	~FFirestoreQueryCursor();
+
+	FFirestoreQueryCursor(const FFirestoreQueryCursor&) = delete;
+	FFirestoreQueryCursor& operator=(const FFirestoreQueryCursor&) = delete;
+
+	/**
+	 * Gets the next page. Only one page can be requested at a time.
+	 *
+	 * @param Callback Called with the page. Called before Next() returns when the page
+	 * has already been read.
+	 */
+	void Next(FFirestoreQueryPageCallback Callback);
+
+	/**
+	 * Gets the pages one after the other until the last one or until OnPage returns false.
+	 * The cursor stays alive until the iteration completes.
+	 *
+	 * @param OnPage Called with each page.
+	 * @param OnComplete Called once the iteration stopped, with the error that stopped it.
+	 */
+	void ForEachPage(FFirestoreQueryPageDelegate OnPage, FFirestoreCallback OnComplete = FFirestoreCallback());
+
+	/** Stops reading pages. The pending Next() callback isn't called. */
+	void Cancel();
+
+	/** @return If all the pages have been consumed. */
+	bool IsDone() const;
+
+	/** @return The number of documents consumed. */
+	int32 GetNumDocuments() const { return NumDocuments; }
+
+private:
+	struct FPage;
+
+	explicit FFirestoreQueryCursor(const FFirestoreQueryBuilder& Query, const FFirestoreQueryCursorSettings& InSettings);
+
+	/** Reads the next page if more pages can be read ahead. */
+	void ReadAhead();
+	void HandlePage(FPage&& Page);
+
+	/** Calls the pending callback if it can be answered. */
+	void Deliver();
+
+private:
+	const FFirestoreQueryCursorSettings Settings;
+
+#if WITH_FIREBASE_FIRESTORE
+	TUniquePtr<firebase::firestore::Query> Query;
+
+	/** Last document of the last page read, the next page starts after it. */
+	TUniquePtr<firebase::firestore::DocumentSnapshot> LastDocument;
+#endif
+
+	/** Pages read and not consumed yet. */
+	TArray<TArray<FFirestoreDocumentSnapshot>> Pages;
+
+	FFirestoreQueryPageCallback PendingCallback;
+
+	EFirestoreError Error;
+	int32 NumDocuments;
+
+	bool bReading;
+	bool bReadAll;
+	bool bCancelled;
+};
@@ -0,0 +1,80 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/QueryBuilder.h"
+
+/**
+ * In-memory cache of query results, keyed by the query's base and clauses.
+ *
+ * The first Get() of a query adds a snapshot listener to it. The listener's
+ * snapshots are kept converted in the cache, so the following Get() calls of the
+ * same query are answered immediately with up-to-date results without going
+ * through the SDK.
+ *
+ * Least recently used queries are removed, and their listener with them, when
+ * the cached results use more memory than the budget or when too many queries
+ * are listened to. Cached results are the listener's last snapshot, which can
+ * come from Firestore's local cache when offline: the Source of the read decides
+ * if they can be used.
+ *
+ * Game thread only.
+ */
+class FIREBASEFEATURES_API FFirestoreQueryResultCache
+{
+public:
+	// Maximum number of queries kept up to date with a listener.
+	static constexpr int32 MaxEntries = 32;
+
+	static FFirestoreQueryResultCache& Get();
+
+	/**
+	 * Gets the results of the query, from the cache if they are available.
+	 *
+	 * @param Query The query to run.
+	 * @param Source Server bypasses the cache. Default waits for results the listener got from
+	 *				 the server, and reads the query like UFirestoreQuery::Get() if they come from
+	 *				 Firestore's local cache. Cache uses any results.
+	 * @param Callback Called with the documents of the query. Called before returning
+	 *                 if the results are cached.
+	 */
+	void GetQuery(const FFirestoreQueryBuilder& Query, const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback);
+	void GetQuery(const FFirestoreQueryBuilder& Query, FFirestoreCachedQueryCallback Callback);
+
+	/** Removes the results of the query and stops listening to it. */
+	void Invalidate(const FFirestoreQueryBuilder& Query);
+
+	/** Removes all the results and stops listening to the queries. */
+	void Empty();
+
+	/** Sets the memory the cached results can use. Zero disables the cache. */
+	void  SetBudget(const int64 Bytes);
+	int64 GetBudget() const;
+
+	/** @return The estimated memory used by the cached results. */
+	int64 GetUsedBytes() const;
+
+private:
+	FFirestoreQueryResultCache();
+
+	struct FEntry;
+	using FEntryRef = TSharedRef<FEntry, ESPMode::ThreadSafe>;
+
+	int32 FindEntry(const FFirestoreQueryBuilder& Query) const;
+	void  RemoveEntry(const int32 Index);
+	void  EnforceBudget();
+
+	void HandleSnapshot(const FEntryRef& Entry, const EFirestoreError Error, TArray<FFirestoreDocumentSnapshot>&& Snapshots,
+		const int64 NumBytes, const bool bFromCache);
+
+	/** Reads the query without the cache. */
+	static void GetUncached(const FFirestoreQueryBuilder& Query, const EFirestoreSource Source, FFirestoreCachedQueryCallback Callback);
+
+private:
+	/** Cached queries, least recently used first. */
+	TArray<FEntryRef> Entries;
+
+	int64 Budget;
+	int64 UsedBytes;
+};
@@ -0,0 +1,92 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/DocumentSnapshot.h"
+#include "Firestore/DocumentChange.h"
+
+#include <vector>
+
+#if WITH_FIREBASE_FIRESTORE
+namespace firebase { namespace firestore { class QuerySnapshot; } }
+#endif
+
+/**
+ * A change of a query's results, as delivered to diff snapshot listeners.
+ */
+struct FIREBASEFEATURES_API FFirestoreDocumentDiff
+{
+	/** The type of change (added, modified, or removed). */
+	EDocumentChangeType Type = EDocumentChangeType::Added;
+
+	/**
+	 * The index of the document in the results before this change, supposing that all the
+	 * prior changes have been applied. INDEX_NONE for added documents.
+	 */
+	int32 OldIndex = INDEX_NONE;
+
+	/**
+	 * The index of the document in the results after this change, supposing that all the
+	 * prior changes and this one have been applied. INDEX_NONE for removed documents.
+	 */
+	int32 NewIndex = INDEX_NONE;
+
+	/**
+	 * The added or modified document, or the removed document. Only the changed documents
+	 * are converted. Read it with FFirestoreDocumentView to avoid converting its fields.
+	 */
+	FFirestoreDocumentSnapshot Document;
+};
+
+/**
+ * The changes of a query's results since the listener's previous snapshot.
+ *
+ * The first snapshot of a listener reports all its documents as added. The full
+ * results are only converted when GetDocuments() is called.
+ */
+struct FIREBASEFEATURES_API FFirestoreQuerySnapshotDiff
+{
+public:
+	FFirestoreQuerySnapshotDiff();
+	FFirestoreQuerySnapshotDiff(FFirestoreQuerySnapshotDiff&& Other);
+	~FFirestoreQuerySnapshotDiff();
+
+	FFirestoreQuerySnapshotDiff& operator=(FFirestoreQuerySnapshotDiff&& Other);
+
+#if WITH_FIREBASE_FIRESTORE
+	FFirestoreQuerySnapshotDiff(const firebase::firestore::QuerySnapshot& InSnapshot);
+
+	/**
+	 * Computes the changes from the documents of the previous snapshot, for snapshots that
+	 * don't carry their changes, such as polled ones.
+	 */
+	FFirestoreQuerySnapshotDiff(const firebase::firestore::QuerySnapshot& InSnapshot,
+		const std::vector<firebase::firestore::DocumentSnapshot>& PreviousDocuments);
+#endif
+
+	/** @return The changes, in the order they must be applied. */
+	const TArray<FFirestoreDocumentDiff>& GetChanges() const { return Changes; }
+
+	/** @return The number of documents in the results. */
+	int32 Num() const;
+
+	/** @return The metadata of the snapshot. */
+	FFirestoreSnapshotMetadata GetMetadata() const;
+
+	/**
+	 * Gets all the documents of the results. They are converted on the first call, which
+	 * costs as much as a regular snapshot listener's update.
+	 * @return The documents, in the query's order.
+	 */
+	const TArray<FFirestoreDocumentSnapshot>& GetDocuments() const;
+
+private:
+	TArray<FFirestoreDocumentDiff> Changes;
+
+#if WITH_FIREBASE_FIRESTORE
+	TUniquePtr<firebase::firestore::QuerySnapshot> Snapshot;
+#endif
+
+	mutable TOptional<TArray<FFirestoreDocumentSnapshot>> Documents;
+};
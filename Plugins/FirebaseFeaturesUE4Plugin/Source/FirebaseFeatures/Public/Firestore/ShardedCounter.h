@@ -0,0 +1,181 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/Query.h"
+
+class UFirestoreCollectionReference;
+class UFirestoreDocumentReference;
+
+/** Called on the game thread with the counter's value. */
+DECLARE_DELEGATE_OneParam(FFirestoreShardedCounterCallback, const int64);
+
+struct FFirestoreShardedCounterSettings
+{
+	/** Shard documents increments are spread over. Each one sustains about one write per second. */
+	int32 NumShards = 10;
+
+	/** Integer field of the shard documents holding their part of the count. */
+	FString Field = TEXT("count");
+
+	/**
+	 * Time in seconds during which the increments are summed locally before being written.
+	 * Zero writes them on the next tick.
+	 */
+	float FlushInterval = 1.f;
+};
+
+/**
+ * A counter that can be incremented faster than a single document allows by spreading
+ * the increments over several shard documents of a collection.
+ *
+ * The counter's value is the sum of the shards, kept up to date by a listener on the
+ * collection: reading it is free. Increments are summed locally and written with one
+ * batch per flush, so a client writes each shard at most once per flush interval.
+ *
+ * The number of shards can be changed while clients use the counter. More shards only
+ * takes effect for the increments that follow. Fewer shards moves the count of the
+ * removed shards into the remaining ones with transactions. All the documents of the
+ * collection are summed, so clients still using the old number of shards don't lose
+ * their increments.
+ *
+ * Game thread only.
+ *
+ * @code
+ * TSharedRef<FFirestoreShardedCounter, ESPMode::ThreadSafe> Kills = FFirestoreShardedCounter::Create(UFirestore::GetCollection(TEXT("events/halloween/kills")));
+ * Kills->OnValueChanged.BindLambda([](const int64 Value) { ... });
+ * Kills->Increment();
+ * @endcode
+ */
+class FIREBASEFEATURES_API FFirestoreShardedCounter : public TSharedFromThis<FFirestoreShardedCounter, ESPMode::ThreadSafe>
+{
+public:
+	/**
+	 * Creates a counter and starts listening to its shards.
+	 *
+	 * @param Shards The collection holding the shard documents, named 0 to NumShards - 1.
+	 * @param Settings The settings of the counter.
+	 */
+	static TSharedRef<FFirestoreShardedCounter, ESPMode::ThreadSafe> Create(UFirestoreCollectionReference* const Shards,
+		const FFirestoreShardedCounterSettings& Settings = FFirestoreShardedCounterSettings());
+
+	~FFirestoreShardedCounter();
+
+	FFirestoreShardedCounter(const FFirestoreShardedCounter&) = delete;
+	FFirestoreShardedCounter& operator=(const FFirestoreShardedCounter&) = delete;
+
+	/**
+	 * Increments the counter. The shard is chosen from a key random to each counter, so a
+	 * client's increments go to the same shard and are merged in a single write.
+	 */
+	void Increment(const int64 ByValue = 1);
+
+	/** Increments the counter on the shard chosen by the key's hash. */
+	void Increment(const int64 ByValue, const FString& Key);
+
+	/**
+	 * Writes the pending increments now.
+	 *
+	 * @param Callback Called once the increments are committed.
+	 */
+	void Flush(const FFirestoreCallback& Callback = FFirestoreCallback());
+
+	/** @return The sum of the shards, including the increments not written or not read back yet. */
+	int64 GetValue() const;
+
+	/** @return If the shards have been read at least once. */
+	bool HasValue() const { return bHasValue; }
+
+	/** Called on the game thread when the value changed. */
+	FFirestoreShardedCounterCallback OnValueChanged;
+
+	/** @return The number of shards increments are spread over. */
+	int32 GetNumShards() const { return Shards.Num(); }
+
+	/**
+	 * Changes the number of shards. The count of the removed shards is moved into the
+	 * remaining ones. Other clients must be given the new number of shards too.
+	 *
+	 * @param NumShards The new number of shards.
+	 * @param Callback Called once the removed shards have been moved.
+	 */
+	void Reshard(const int32 NumShards, const FFirestoreCallback& Callback = FFirestoreCallback());
+
+private:
+	FFirestoreShardedCounter(UFirestoreCollectionReference* const InCollection, const FFirestoreShardedCounterSettings& InSettings);
+
+	void StartListening();
+	void HandleSnapshot(const EFirestoreError Error, const FFirestoreQuerySnapshotDiff& Diff);
+
+	void AddShard();
+	void AddIncrement(const int32 Shard, const int64 ByValue);
+	bool HandleFlushTick(float DeltaTime);
+
+	/**
+	 * Writes the pending increments.
+	 *
+	 * @param bTrack If the flushed increments are counted until the snapshots include them.
+	 * Off when the counter is destroyed.
+	 */
+	void CommitPending(const FFirestoreCallback& Callback, const bool bTrack);
+
+	/**
+	 * Called when a flush's commit completed. Its increments stop being counted apart unless
+	 * the shard values can only include them once the shards are read again.
+	 */
+	void CompleteFlush(const uint32 FlushId, const bool bCommitted);
+
+	/**
+	 * Stops counting apart the increments of a shard reported by a snapshot.
+	 *
+	 * @param bHasPendingWrites If the snapshot includes local writes not committed yet. It releases the
+	 * oldest uncommitted flush of the shard, otherwise all the committed ones are released.
+	 */
+	void ReleaseShard(const FString& ShardId, const bool bHasPendingWrites);
+
+	/** Increments written by a flush that the shard values might not include yet. */
+	struct FInFlightFlush
+	{
+		uint32 Id = 0;
+
+		/** Increments of the shards not reported with the write yet, by shard ID. */
+		TMap<FString, int64> WaitingShards;
+
+		/** If the write is committed and waits for a snapshot read after it. */
+		bool bCommitted = false;
+	};
+
+	struct FReshard;
+
+	/** Moves the count of a removed shard into the shard that takes over its increments. */
+	void MoveShard(const int32 Shard, const TSharedRef<FReshard, ESPMode::ThreadSafe>& Reshard);
+
+private:
+	const FFirestoreShardedCounterSettings Settings;
+
+	TStrongObjectPtr<UFirestoreCollectionReference> Collection;
+	TArray<TStrongObjectPtr<UFirestoreDocumentReference>> Shards;
+
+	/** Increments not written yet, per shard. */
+	TArray<int64> PendingIncrements;
+	int64 PendingSum;
+
+	/** Flushes being committed, oldest first. */
+	TArray<FInFlightFlush> InFlightFlushes;
+	int64 InFlightSum;
+	uint32 NextFlushId;
+
+	/** Last known count of the shards, by document ID. */
+	TMap<FString, int64> ShardValues;
+	int64 ShardSum;
+	bool bHasValue;
+
+	const uint32 ClientKey;
+
+	FQuerySnapshotListenerHandle Listener;
+	FDelegateHandle FlushHandle;
+};
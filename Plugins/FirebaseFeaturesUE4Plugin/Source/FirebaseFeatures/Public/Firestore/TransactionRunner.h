@@ -0,0 +1,108 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Firestore/Firestore.h"
+#include "Firestore/DocumentSnapshot.h"
+
+class UFirestoreDocumentReference;
+
+/** Contention observed on a document by the transactions run with FFirestoreTransactionRunner. */
+struct FIREBASEFEATURES_API FFirestoreContentionStats
+{
+	/** Attempts of transactions reading the document. */
+	int32 NumAttempts = 0;
+
+	/** Attempts that failed because a document read by the transaction was modified. */
+	int32 NumConflicts = 0;
+
+	/**
+	 * Recent rate of conflicts of the attempts, between 0 and 1. Unlike NumConflicts / NumAttempts,
+	 * it follows changes of the load.
+	 */
+	float ConflictRate = 0.f;
+};
+
+/**
+ * The update function of a transaction. Called with the snapshots of the documents to read, in
+ * the same order. Writes are made with the transaction.
+ *
+ * Called on one of the SDK's threads, once per attempt: it must only depend on the snapshots and
+ * have no side effects. An error it returns fails the transaction without retrying it.
+ */
+DECLARE_DELEGATE_RetVal_ThreeParams(EFirestoreError, FFirestoreTransactionUpdateFunction,
+	const TArray<FFirestoreDocumentSnapshot>& /* Snapshots */, FFirestoreTransaction& /* Transaction */, FString& /* ErrorMessage */);
+
+/** Called on the game thread with the result of the transaction and the number of attempts it took. */
+DECLARE_DELEGATE_TwoParams(FFirestoreTransactionRunnerCallback, const EFirestoreError, const int32);
+
+struct FFirestoreTransactionRunnerSettings
+{
+	/** Runs of the transaction before failing. The SDK also retries each run up to 5 times. */
+	int32 MaxAttempts = 5;
+
+	/** Delay in seconds before the first retry, doubled on each retry. */
+	float InitialBackoff = 0.1f;
+
+	/** Maximum delay in seconds before retrying. */
+	float MaxBackoff = 10.f;
+
+	/**
+	 * How much the conflict rate of the documents increases the delays. With a conflict rate of 1,
+	 * delays are multiplied by 1 + ContentionScale.
+	 */
+	float ContentionScale = 4.f;
+};
+
+/**
+ * Runs transactions whose documents to read are known in advance.
+ *
+ * The documents are read at the start of each attempt, before the update function is called,
+ * which keeps the time between the reads and the commit short. Runs failing because of a conflict
+ * or a transient error are retried after a randomized exponential delay, so concurrent clients
+ * don't retry in lockstep. Delays grow with the conflict rate of the documents, and transactions
+ * on documents with a high conflict rate wait a random delay before their first attempt.
+ *
+ * @code
+ * FFirestoreTransactionRunner::Run({ Treasury },
+ *     FFirestoreTransactionUpdateFunction::CreateLambda([Amount](const TArray<FFirestoreDocumentSnapshot>& Snapshots, FFirestoreTransaction& Transaction, FString&)
+ *     {
+ *         Transaction.Update(...);
+ *         return EFirestoreError::Ok;
+ *     }),
+ *     FFirestoreTransactionRunnerCallback::CreateLambda([](const EFirestoreError Error, const int32 NumAttempts) { ... }));
+ * @endcode
+ */
+class FIREBASEFEATURES_API FFirestoreTransactionRunner
+{
+public:
+	/**
+	 * Runs a transaction. Game thread only.
+	 *
+	 * @param Reads The documents read by the transaction.
+	 * @param Update The update function.
+	 * @param Callback Called with the result of the transaction.
+	 * @param Settings The retry settings.
+	 */
+	static void Run(const TArray<UFirestoreDocumentReference*>& Reads, FFirestoreTransactionUpdateFunction Update,
+		FFirestoreTransactionRunnerCallback Callback, const FFirestoreTransactionRunnerSettings& Settings = FFirestoreTransactionRunnerSettings());
+
+	/** @return The contention observed on the document, empty if no transaction read it. Thread-safe. */
+	static FFirestoreContentionStats GetContentionStats(const FString& DocumentPath);
+
+	/** Forgets the contention observed on all the documents. Thread-safe. */
+	static void ResetContentionStats();
+
+private:
+	struct FRun;
+	using FRunRef = TSharedRef<FRun, ESPMode::ThreadSafe>;
+
+	static void Attempt(const FRunRef& Run);
+	/** @param bUpdateFailed If the error was returned by the update function. */
+	static void HandleAttempt(const FRunRef& Run, const EFirestoreError Error, const bool bUpdateFailed);
+	static void ScheduleAttempt(const FRunRef& Run, const float Delay);
+
+	/** @return The delay before the next attempt of the run. */
+	static float GetBackoff(const FRun& Run);
+};
@@ -14,6 +14,36 @@
 @class FIRTrace;
 #endif
 
+/**
+ * Handle to a metric name registered with FFirebaseTrace::RegisterMetric().
+ * Handles are valid for all traces during the whole lifetime of the process.
+ */
+struct FFirebaseMetricHandle
+{
+public:
+	FFirebaseMetricHandle()
+		: Index(INDEX_NONE)
+	{
+	}
+
+	explicit FFirebaseMetricHandle(const int32 InIndex)
+		: Index(InIndex)
+	{
+	}
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+
+	FORCEINLINE int32 GetIndex() const { return Index; }
+
+	FORCEINLINE bool operator==(const FFirebaseMetricHandle& Other) const { return Index == Other.Index; }
+	FORCEINLINE bool operator!=(const FFirebaseMetricHandle& Other) const { return Index != Other.Index; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FFirebaseMetricHandle& Handle) { return ::GetTypeHash(Handle.Index); }
+
+private:
+	int32 Index;
+};
+
 /**
  * FFirebaseTrace objects contain information about a "Trace", which is a sequence of steps. Traces can be
  * used to measure the time taken for a sequence of steps.
@@ -69,6 +99,55 @@ public:
 	 */
 	void SetMetricValue(const FString& MetricName, const int64 Value);
 
+	/**
+	 * Sets the values of several metrics at once. Equivalent to calling SetMetricValue() for each
+	 * pair but crosses into the native SDK a single time. Does nothing if the trace has not been
+	 * started or has already been stopped.
+	 *
+	 * @param MetricNames The names of the metrics to set.
+	 * @param Values The values to set the metrics to. Must have the same length as MetricNames.
+	 */
+	void SetMetricValues(TArrayView<const FString> MetricNames, TArrayView<const int64> Values);
+
+	/**
+	 * Registers a metric name and returns a handle to it. The native string for the name is created
+	 * once and cached so the handle-based overloads below don't convert the name on each call.
+	 * Registering the same name twice returns the same handle. Thread-safe.
+	 *
+	 * @param MetricName The name of the metric.
+	 * @return The handle of the metric or an invalid handle if too many metrics were registered.
+	 */
+	static FFirebaseMetricHandle RegisterMetric(const FString& MetricName);
+
+	/**
+	 * Gets the name a metric handle was registered with.
+	 *
+	 * @param Metric The handle of the metric.
+	 * @return The name of the metric or an empty string if the handle is invalid.
+	 */
+	static FString GetMetricName(const FFirebaseMetricHandle Metric);
+
+	/** Same as IncrementMetric() with a name, for a registered metric. */
+	void IncrementMetric(const FFirebaseMetricHandle Metric, const int64 ByValue);
+
+	/** Same as GetMetricValue() with a name, for a registered metric. */
+	int64 GetMetricValue(const FFirebaseMetricHandle Metric) const;
+
+	/** Same as SetMetricValue() with a name, for a registered metric. */
+	void SetMetricValue(const FFirebaseMetricHandle Metric, const int64 Value);
+
+	/** Same as SetMetricValues() with names, for registered metrics. */
+	void SetMetricValues(TArrayView<const FFirebaseMetricHandle> MetricHandles, TArrayView<const int64> Values);
+
+	/**
+	 * Increments several registered metrics at once, crossing into the native SDK a single time.
+	 * Does nothing if the trace has not been started or has already been stopped.
+	 *
+	 * @param MetricHandles The metrics to increment.
+	 * @param ByValues The values to increment the metrics by. Must have the same length as MetricHandles.
+	 */
+	void IncrementMetrics(TArrayView<const FFirebaseMetricHandle> MetricHandles, TArrayView<const int64> ByValues);
+
 public:
 	FFirebaseTrace();
 	FFirebaseTrace(const FFirebaseTrace& Other);
@@ -80,22 +159,58 @@ public:
 	~FFirebaseTrace();
 
 #if PLATFORM_IOS 
-	FFirebaseTrace(FIRTrace* Native);
+	FFirebaseTrace(FIRTrace* InNative);
 #elif PLATFORM_ANDROID
-	FFirebaseTrace(jobject Native);
+	FFirebaseTrace(jobject InNative);
 #else
 	FFirebaseTrace(FString InName);
 #endif
 
+	/**
+	 * If the trace references a native trace. Default-constructed traces and traces
+	 * whose creation failed are invalid and all their methods are no-ops.
+	 */
+	bool IsValid() const;
+
 private:
-#if PLATFORM_IOS
-	FIRTrace* Trace;
-#elif PLATFORM_ANDROID
-	jobject Trace;
-#else
-	FString Name;
-	TMap<FString, int64> Metrics;
-#endif
+	// Copies share the native trace so copying a trace (by value in Blueprints for example)
+	// doesn't create a new JNI global reference or retain the Objective-C object.
+	TSharedPtr<class FFirebaseNativeTrace, ESPMode::ThreadSafe> Native;
+};
+
+/**
+ * Move-only owner of a trace, for C++ code that wants to make the ownership of a trace explicit.
+ * Returned by UFirebasePerformanceLibrary::AcquireTrace() and AcquireAndStartTrace().
+ */
+class FFirebaseTraceHandle
+{
+public:
+	FFirebaseTraceHandle() = default;
+
+	explicit FFirebaseTraceHandle(FFirebaseTrace&& InTrace)
+		: Trace(MoveTemp(InTrace))
+	{
+	}
+
+	FFirebaseTraceHandle(FFirebaseTraceHandle&&) = default;
+	FFirebaseTraceHandle& operator=(FFirebaseTraceHandle&&) = default;
+
+	FFirebaseTraceHandle(const FFirebaseTraceHandle&) = delete;
+	FFirebaseTraceHandle& operator=(const FFirebaseTraceHandle&) = delete;
+
+	FORCEINLINE bool IsValid() const { return Trace.IsValid(); }
+
+	FORCEINLINE FFirebaseTrace* operator->() { return &Trace; }
+	FORCEINLINE const FFirebaseTrace* operator->() const { return &Trace; }
+
+	FORCEINLINE FFirebaseTrace& operator*() { return Trace; }
+	FORCEINLINE const FFirebaseTrace& operator*() const { return Trace; }
+
+	/** Gives up the ownership of the trace. */
+	FORCEINLINE FFirebaseTrace Release() { return MoveTemp(Trace); }
+
+private:
+	FFirebaseTrace Trace;
 };
 
 UCLASS()
@@ -125,6 +240,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Firebase|Performance")
 	static UPARAM(DisplayName = "Trace") FFirebaseTrace CreateAndStartTrace(const FString& TraceName);
 
+	/**
+	 * Pre-creates native traces for the provided names so that later calls to AcquireTrace() and
+	 * AcquireAndStartTrace() for these names don't have to create them. Traces are created on a
+	 * background thread. Names listed in the plugin's settings are prewarmed at startup.
+	 *
+	 * @param TraceNames The names of the traces to prewarm.
+	 * @param CountPerName How many traces to keep ready for each name.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Firebase|Performance")
+	static void PrewarmTraces(const TArray<FString>& TraceNames, const int32 CountPerName = 2);
+
+	/**
+	 * Takes a pre-created trace from the trace pool, or creates one if none is available for this
+	 * name. Only names passed to PrewarmTraces() are pooled. The trace isn't started. The pool is
+	 * refilled on a background thread.
+	 *
+	 * @param TraceName The name of the Trace.
+	 * @return The trace.
+	 */
+	static FFirebaseTraceHandle AcquireTrace(const FString& TraceName);
+
+	/**
+	 * Same as AcquireTrace() but also starts the trace.
+	 *
+	 * @param TraceName The name of the Trace.
+	 * @return The started trace.
+	 */
+	static FFirebaseTraceHandle AcquireAndStartTrace(const FString& TraceName);
+
 	/**
 	 * Controls the instrumentation of the app to capture performance data. Setting this value to NO has
 	 * immediate effect only if it is done so before calling [FIRApp configure]. Otherwise it takes
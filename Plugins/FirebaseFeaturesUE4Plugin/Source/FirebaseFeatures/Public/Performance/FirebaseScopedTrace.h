@@ -0,0 +1,69 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FirebaseFeatures.h"
+#include "Performance/FirebasePerformanceLibrary.h"
+
+// Scoped traces can be compiled out per build, for example with
+// GlobalDefinitions.Add("FIREBASE_SCOPED_TRACES_ENABLED=0") in a Target.cs.
+#ifndef FIREBASE_SCOPED_TRACES_ENABLED
+#	define FIREBASE_SCOPED_TRACES_ENABLED WITH_FIREBASE_PERFORMANCE
+#endif
+
+namespace FirebasePerformance
+{
+	/**
+	 * FNV-1a hash of a trace name. Evaluated at compile time for the literals
+	 * passed to FIREBASE_SCOPED_TRACE.
+	 */
+	constexpr uint32 HashTraceName(const TCHAR* const Name, const uint32 Hash = 2166136261u)
+	{
+		return *Name ? HashTraceName(Name + 1, (Hash ^ (uint32)*Name) * 16777619u) : Hash;
+	}
+}
+
+/**
+ * Starts a trace on construction and stops it on destruction.
+ * Traces of names prewarmed with UFirebasePerformanceLibrary::PrewarmTraces() are taken
+ * from a pool of pre-created native traces so scopes entered often don't pay for the
+ * trace creation.
+ * Scoped traces can be disabled at runtime with firebase.Performance.ScopedTraces 0.
+ */
+class FIREBASEFEATURES_API FScopedFirebaseTrace
+{
+public:
+	/**
+	 * @param NameHash FirebasePerformance::HashTraceName(Name).
+	 * @param Name The name of the trace. Can't be empty.
+	 */
+	FScopedFirebaseTrace(const uint32 NameHash, const TCHAR* const Name);
+
+	explicit FScopedFirebaseTrace(const FString& Name);
+
+	~FScopedFirebaseTrace();
+
+	FScopedFirebaseTrace(const FScopedFirebaseTrace&) = delete;
+	FScopedFirebaseTrace& operator=(const FScopedFirebaseTrace&) = delete;
+
+	/** If the trace was started. False if scoped traces are disabled. */
+	FORCEINLINE bool IsActive() const { return bActive; }
+
+	/** The running trace, to add metrics. Only valid if IsActive(). */
+	FORCEINLINE FFirebaseTrace& GetTrace() { return Trace; }
+
+private:
+	FFirebaseTrace Trace;
+	bool bActive;
+};
+
+#if FIREBASE_SCOPED_TRACES_ENABLED
+#	define FIREBASE_SCOPED_TRACE(Name)																					\
+		static constexpr uint32 PREPROCESSOR_JOIN(FirebaseScopedTraceHash_, __LINE__)								\
+			= FirebasePerformance::HashTraceName(TEXT(Name));														\
+		FScopedFirebaseTrace PREPROCESSOR_JOIN(FirebaseScopedTrace_, __LINE__)(									\
+			PREPROCESSOR_JOIN(FirebaseScopedTraceHash_, __LINE__), TEXT(Name))
+#else
+#	define FIREBASE_SCOPED_TRACE(Name)
+#endif
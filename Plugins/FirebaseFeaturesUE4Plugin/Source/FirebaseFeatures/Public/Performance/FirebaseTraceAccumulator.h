@@ -0,0 +1,87 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Performance/FirebasePerformanceLibrary.h"
+
+#include <atomic>
+
+/**
+ * Accumulates metric increments for a trace locally and pushes the summed deltas to Firebase
+ * Performance at a fixed interval.
+ *
+ * Metrics are assigned a fixed slot when added. Incrementing a slot is a relaxed atomic add and is
+ * safe from any thread, which makes per-event counting (per projectile, per packet, ...) affordable.
+ * Only flushes cross into the native SDK, once per flush with all the non-zero deltas.
+ *
+ * The accumulator must be created and destroyed on the game thread as it registers to the core ticker.
+ */
+class FIREBASEFEATURES_API FFirebaseTraceAccumulator
+{
+public:
+	// Firebase Performance doesn't accept more than 32 custom metrics per trace.
+	static constexpr int32 MaxSlots = 32;
+
+	/**
+	 * Creates an accumulator for the provided trace.
+	 *
+	 * @param InTrace The trace deltas are pushed to. It should be started.
+	 * @param FlushInterval The interval in seconds between two automatic flushes. A negative value uses the
+	 *                      interval from the plugin's settings. Zero disables automatic flushes.
+	 */
+	explicit FFirebaseTraceAccumulator(FFirebaseTrace InTrace, const float FlushInterval = -1.f);
+
+	/** Flushes the remaining deltas. */
+	~FFirebaseTraceAccumulator();
+
+	FFirebaseTraceAccumulator(const FFirebaseTraceAccumulator&) = delete;
+	FFirebaseTraceAccumulator& operator=(const FFirebaseTraceAccumulator&) = delete;
+
+	/**
+	 * Adds a metric to the accumulator. Metrics must be added before being incremented from other threads.
+	 * Adding the same metric twice returns the same slot.
+	 *
+	 * @param MetricName The name of the metric.
+	 * @return The slot of the metric or INDEX_NONE if all the slots are used.
+	 */
+	int32 AddMetric(const FString& MetricName);
+
+	/**
+	 * Adds ByValue to the metric in Slot. Thread-safe and lock-free.
+	 *
+	 * @param Slot The slot returned by AddMetric().
+	 * @param ByValue The value to increment the metric by.
+	 */
+	FORCEINLINE void Increment(const int32 Slot, const int64 ByValue = 1)
+	{
+		checkSlow(Slot >= 0 && Slot < NumSlots.load(std::memory_order_relaxed));
+		Deltas[Slot].fetch_add(ByValue, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Pushes the deltas accumulated since the last flush to the trace in one native call.
+	 * Thread-safe.
+	 */
+	void Flush();
+
+	/**
+	 * Flushes the remaining deltas then stops the trace. Increments done after stopping are discarded.
+	 */
+	void Stop();
+
+private:
+	bool HandleFlushTick(float DeltaTime);
+
+private:
+	std::atomic<int64> Deltas[MaxSlots];
+	FFirebaseMetricHandle Handles[MaxSlots];
+	std::atomic<int32> NumSlots;
+
+	FCriticalSection TraceLock;
+	FFirebaseTrace Trace;
+	bool bStopped;
+
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,34 @@
+// Copyright Pandores Marketplace 2022. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Receives the trace events of platforms without a Firebase Performance SDK (Windows, Mac, Linux)
+ * so they can be recorded locally instead of being discarded.
+ *
+ * Sinks are called from the thread using the trace and must be thread-safe.
+ * Trace ids are unique for the whole process.
+ */
+class FIREBASEFEATURES_API IFirebaseTraceSink
+{
+public:
+	virtual ~IFirebaseTraceSink() = default;
+
+	virtual void OnTraceStarted(const uint64 TraceId, const FString& TraceName) = 0;
+	virtual void OnTraceStopped(const uint64 TraceId) = 0;
+	virtual void OnMetricIncremented(const uint64 TraceId, const FString& MetricName, const int64 ByValue) = 0;
+	virtual void OnMetricSet(const uint64 TraceId, const FString& MetricName, const int64 Value) = 0;
+};
+
+using FFirebaseTraceSinkRef = TSharedRef<IFirebaseTraceSink, ESPMode::ThreadSafe>;
+
+namespace FirebasePerformance
+{
+	/** Adds a sink receiving the events of all the traces. Thread-safe. */
+	FIREBASEFEATURES_API void AddTraceSink(const FFirebaseTraceSinkRef& Sink);
+
+	/** Removes a sink added with AddTraceSink(). Thread-safe. */
+	FIREBASEFEATURES_API void RemoveTraceSink(const FFirebaseTraceSinkRef& Sink);
+}
@@ -0,0 +1,201 @@
+#include "WZFFirebaseMetricPipeline.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWZFFirebaseMetricPipeline, Log, All);
+
+// Number of samples the ring can hold per metric before the worker drains it.
+static constexpr int32 SamplesPerMetric = 8;
+
+// Upper bound between two flushes when no flush is requested.
+static constexpr uint32 WorkerIdleWaitMs = 1000;
+
+FWZFFirebaseTraceChannel::FWZFFirebaseTraceChannel(const TArray<FString>& MetricNames)
+	: Samples(FMath::RoundUpToPowerOfTwo(FMath::Max(MetricNames.Num(), 1) * SamplesPerMetric))
+	, DroppedSamples(0)
+{
+	MetricHandles.Reserve(MetricNames.Num());
+	for (const FString& MetricName : MetricNames)
+	{
+		MetricHandles.Add(FFirebaseTrace::RegisterMetric(MetricName));
+	}
+
+	PendingValues.SetNumZeroed(MetricHandles.Num());
+	PushedValues.SetNumZeroed(MetricHandles.Num());
+	PendingMetrics.Init(false, MetricHandles.Num());
+	PushedMetrics.Init(false, MetricHandles.Num());
+	BatchHandles.Reserve(MetricHandles.Num());
+	BatchValues.Reserve(MetricHandles.Num());
+}
+
+bool FWZFFirebaseTraceChannel::PushSample(int32 MetricIndex, int64 Value)
+{
+	check(MetricHandles.IsValidIndex(MetricIndex));
+
+	if (!Samples.Enqueue({ MetricIndex, Value }))
+	{
+		DroppedSamples.IncrementExchange();
+		return false;
+	}
+
+	return true;
+}
+
+void FWZFFirebaseTraceChannel::ResetTrace(const FString& NewTraceName, FFirebaseTraceHandle&& NewTrace)
+{
+	FScopeLock Lock(&TraceLock);
+
+	if (bTraceRunning)
+	{
+		Trace->Stop();
+	}
+
+	Trace = MoveTemp(NewTrace);
+	TraceName = NewTraceName;
+	bTraceRunning = true;
+
+	// The new native trace has no metric yet, everything must be sent again.
+	PushedMetrics.Init(false, MetricHandles.Num());
+}
+
+void FWZFFirebaseTraceChannel::StopTrace()
+{
+	FScopeLock Lock(&TraceLock);
+
+	if (bTraceRunning)
+	{
+		Trace->Stop();
+		bTraceRunning = false;
+	}
+}
+
+int32 FWZFFirebaseTraceChannel::Flush()
+{
+	FWZFFirebaseMetricSample Sample;
+	while (Samples.Dequeue(Sample))
+	{
+		PendingValues[Sample.MetricIndex] = Sample.Value;
+		PendingMetrics[Sample.MetricIndex] = true;
+	}
+
+	FScopeLock Lock(&TraceLock);
+
+	if (!bTraceRunning)
+	{
+		return 0;
+	}
+
+	BatchHandles.Reset();
+	BatchValues.Reset();
+
+	for (TConstSetBitIterator<> It(PendingMetrics); It; ++It)
+	{
+		const int32 MetricIndex = It.GetIndex();
+		const int64 Value = PendingValues[MetricIndex];
+
+		if (!PushedMetrics[MetricIndex] || PushedValues[MetricIndex] != Value)
+		{
+			BatchHandles.Add(MetricHandles[MetricIndex]);
+			BatchValues.Add(Value);
+
+			PushedValues[MetricIndex] = Value;
+			PushedMetrics[MetricIndex] = true;
+		}
+	}
+
+	PendingMetrics.Init(false, MetricHandles.Num());
+
+	Trace->SetMetricValues(BatchHandles, BatchValues);
+
+	UE_LOG(LogWZFFirebaseMetricPipeline, Verbose, TEXT("Flushed %d metric(s) to trace %s."), BatchHandles.Num(), *TraceName);
+
+	return BatchHandles.Num();
+}
+
+FWZFFirebaseMetricWorker::FWZFFirebaseMetricWorker()
+	: bStopRequested(false)
+{
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		Thread = FRunnableThread::Create(this, TEXT("WZFFirebaseMetricWorker"), 0, TPri_BelowNormal);
+	}
+}
+
+FWZFFirebaseMetricWorker::~FWZFFirebaseMetricWorker()
+{
+	if (Thread)
+	{
+		// Kill() calls Stop() then waits for Run() to return.
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+	}
+}
+
+void FWZFFirebaseMetricWorker::AddChannel(const FWZFFirebaseTraceChannelRef& Channel)
+{
+	FScopeLock Lock(&ChannelsLock);
+	Channels.AddUnique(Channel);
+}
+
+void FWZFFirebaseMetricWorker::RemoveChannel(const FWZFFirebaseTraceChannelRef& Channel)
+{
+	FScopeLock Lock(&ChannelsLock);
+	Channels.RemoveSingleSwap(Channel);
+}
+
+void FWZFFirebaseMetricWorker::RequestFlush()
+{
+	if (Thread)
+	{
+		WakeEvent->Trigger();
+	}
+	else
+	{
+		FlushChannels();
+	}
+}
+
+uint32 FWZFFirebaseMetricWorker::Run()
+{
+	while (!bStopRequested.Load(EMemoryOrder::Relaxed))
+	{
+		WakeEvent->Wait(WorkerIdleWaitMs);
+		FlushChannels();
+	}
+
+	// Don't lose the samples taken right before shutdown.
+	FlushChannels();
+
+	return 0;
+}
+
+void FWZFFirebaseMetricWorker::Stop()
+{
+	bStopRequested = true;
+	WakeEvent->Trigger();
+}
+
+void FWZFFirebaseMetricWorker::FlushChannels()
+{
+	TArray<FWZFFirebaseTraceChannelRef, TInlineAllocator<8>> ChannelsToFlush;
+	{
+		FScopeLock Lock(&ChannelsLock);
+		ChannelsToFlush.Append(Channels);
+	}
+
+	for (const FWZFFirebaseTraceChannelRef& Channel : ChannelsToFlush)
+	{
+		Channel->Flush();
+	}
+}
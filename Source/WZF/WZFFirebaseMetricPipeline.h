@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "Performance/FirebasePerformanceLibrary.h"
+
+struct FWZFFirebaseMetricSample
+{
+	int32 MetricIndex = INDEX_NONE;
+	int64 Value = 0;
+};
+
+/**
+ * Per-trace state shared between the game thread and the metric worker.
+ * The game thread is the single producer of samples and the worker the single consumer,
+ * so pushing a sample is a lock-free enqueue into a fixed-size ring.
+ */
+class FWZFFirebaseTraceChannel
+{
+public:
+	explicit FWZFFirebaseTraceChannel(const TArray<FString>& MetricNames);
+
+	/** Game thread. Returns false if the ring is full and the sample was dropped. */
+	bool PushSample(int32 MetricIndex, int64 Value);
+
+	/** Game thread. Stops the running native trace, if any, and replaces it with NewTrace. */
+	void ResetTrace(const FString& NewTraceName, FFirebaseTraceHandle&& NewTrace);
+
+	/** Game thread. Stops the running native trace, if any. */
+	void StopTrace();
+
+	/**
+	 * Worker thread. Drains the queued samples, keeps the latest value of each metric and
+	 * pushes the ones that changed to the native trace in a single call.
+	 * @return The number of metric values sent to the native trace.
+	 */
+	int32 Flush();
+
+	int32 GetDroppedSampleCount() const { return DroppedSamples.Load(EMemoryOrder::Relaxed); }
+
+private:
+	TCircularQueue<FWZFFirebaseMetricSample> Samples;
+	TAtomic<int32> DroppedSamples;
+
+	// Registered once so flushes don't convert metric names to native strings.
+	TArray<FFirebaseMetricHandle> MetricHandles;
+
+	// Only accessed by the consumer.
+	TArray<int64> PendingValues;
+	TArray<int64> PushedValues;
+	TBitArray<> PendingMetrics;
+	TBitArray<> PushedMetrics;
+	TArray<FFirebaseMetricHandle> BatchHandles;
+	TArray<int64> BatchValues;
+
+	// Guards the native trace, which is replaced by the game thread on rollover.
+	FCriticalSection TraceLock;
+	FFirebaseTraceHandle Trace;
+	FString TraceName;
+	bool bTraceRunning = false;
+};
+
+using FWZFFirebaseTraceChannelRef = TSharedRef<FWZFFirebaseTraceChannel, ESPMode::ThreadSafe>;
+
+/**
+ * Background thread flushing the trace channels' samples to Firebase so JNI calls and
+ * string conversions never happen on the game thread.
+ * Falls back to flushing inline on platforms without multithreading.
+ */
+class FWZFFirebaseMetricWorker final : public FRunnable
+{
+public:
+	FWZFFirebaseMetricWorker();
+	virtual ~FWZFFirebaseMetricWorker();
+
+	void AddChannel(const FWZFFirebaseTraceChannelRef& Channel);
+	void RemoveChannel(const FWZFFirebaseTraceChannelRef& Channel);
+
+	/** Game thread. Wakes the worker up so it drains all the channels. */
+	void RequestFlush();
+
+protected:
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void FlushChannels();
+
+private:
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	TAtomic<bool> bStopRequested;
+
+	FCriticalSection ChannelsLock;
+	TArray<FWZFFirebaseTraceChannelRef> Channels;
+};
@@ -2,6 +2,10 @@
 
 #include "WZFSettings.h"
 
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/PlatformMemory.h"
 #include "HAL/PlatformMisc.h"
 #include "Performance/FirebasePerformanceLibrary.h"
 
@@ -9,15 +13,84 @@ DEFINE_LOG_CATEGORY_STATIC(LogWZFFirebaseTrace, Log, All);
 
 static int TotalTraceCount = 0;
 
+FWZFAsyncMetricState::FWZFAsyncMetricState()
+	: bSampling(false)
+{
+	for (auto& value : Values)
+	{
+		value.store(0, std::memory_order_relaxed);
+	}
+}
+
+void UWZFAsyncFirebaseMetric::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		return;
+	}
+
+	TArray<FString> valueSuffixes;
+	GetValueSuffixes(valueSuffixes);
+	check(valueSuffixes.Num() <= FWZFAsyncMetricState::MaxValues);
+
+	State = MakeShared<FWZFAsyncMetricState, ESPMode::ThreadSafe>();
+	State->Sampler = CreateSampler();
+	State->NumValues = valueSuffixes.Num();
+
+	// The first values are read right away so the first sample isn't made of zeros.
+	TArray<int64> values;
+	State->Sampler(values);
+	for (int32 valueIndex = 0; valueIndex < State->NumValues; ++valueIndex)
+	{
+		State->Values[valueIndex].store(values.IsValidIndex(valueIndex) ? values[valueIndex] : 0, std::memory_order_relaxed);
+	}
+}
+
+int64 UWZFAsyncFirebaseMetric::GetValue() const
+{
+	return State.IsValid() ? State->Values[0].load(std::memory_order_relaxed) : 0;
+}
+
+void UWZFAsyncFirebaseMetric::SampleValues(TArray<int64>& OutValues)
+{
+	for (int32 valueIndex = 0; valueIndex < State->NumValues; ++valueIndex)
+	{
+		OutValues.Add(State->Values[valueIndex].load(std::memory_order_relaxed));
+	}
+
+	// Skips this period if the previous read is still running.
+	if (State->bSampling.exchange(true, std::memory_order_acquire))
+	{
+		return;
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [state = State]()
+	{
+		TArray<int64> values;
+		state->Sampler(values);
+		for (int32 valueIndex = 0; valueIndex < state->NumValues; ++valueIndex)
+		{
+			state->Values[valueIndex].store(values.IsValidIndex(valueIndex) ? values[valueIndex] : 0, std::memory_order_relaxed);
+		}
+
+		state->bSampling.store(false, std::memory_order_release);
+	});
+}
+
 int64 UWZFFPSFirebaseMetric::GetValue() const
 {
 	extern ENGINE_API float GAverageFPS;
 	return GAverageFPS;
 }
 
-int64 UWZFDeviceTemperatureFirebaseMetric::GetValue() const
+TFunction<void(TArray<int64>&)> UWZFDeviceTemperatureFirebaseMetric::CreateSampler() const
 {
-	return 0;
+	return [](TArray<int64>& OutValues)
+	{
+		OutValues.Add(FMath::RoundToInt(FPlatformMisc::GetDeviceTemperatureLevel()));
+	};
 }
 
 int64 UWZFDeviceBatteryLevelFirebaseMetric::GetValue() const
@@ -31,9 +104,41 @@ int64 UWZFDeviceBatteryLevelFirebaseMetric::GetValue() const
 #endif
 }
 
-int64 UWZFMemoryFirebaseMetric::GetValue() const
+void UWZFMemoryFirebaseMetric::GetValueSuffixes(TArray<FString>& OutSuffixes) const
 {
-	return 5;
+	OutSuffixes.Add(TEXT("_resident"));
+	OutSuffixes.Add(TEXT("_peak"));
+	OutSuffixes.Add(TEXT("_available"));
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	OutSuffixes.Add(TEXT("_llm_total"));
+	OutSuffixes.Add(TEXT("_llm_platform"));
+	OutSuffixes.Add(TEXT("_llm_textures"));
+	OutSuffixes.Add(TEXT("_llm_audio"));
+	OutSuffixes.Add(TEXT("_llm_uobject"));
+#endif
+}
+
+TFunction<void(TArray<int64>&)> UWZFMemoryFirebaseMetric::CreateSampler() const
+{
+	return [](TArray<int64>& OutValues)
+	{
+		static constexpr uint64 bytesPerMB = 1024 * 1024;
+
+		const auto stats = FPlatformMemory::GetStats();
+		OutValues.Add(stats.UsedPhysical / bytesPerMB);
+		OutValues.Add(stats.PeakUsedPhysical / bytesPerMB);
+		OutValues.Add(stats.AvailablePhysical / bytesPerMB);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		auto& tracker = FLowLevelMemTracker::Get();
+		const bool bTracking = tracker.IsEnabled();
+		OutValues.Add(bTracking ? tracker.GetTotalTrackedMemory(ELLMTracker::Default) / bytesPerMB : 0);
+		OutValues.Add(bTracking ? tracker.GetTotalTrackedMemory(ELLMTracker::Platform) / bytesPerMB : 0);
+		OutValues.Add(bTracking ? tracker.GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::Textures) / bytesPerMB : 0);
+		OutValues.Add(bTracking ? tracker.GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::Audio) / bytesPerMB : 0);
+		OutValues.Add(bTracking ? tracker.GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::UObject) / bytesPerMB : 0);
+#endif
+	};
 }
 
 int64 UWZFDeviceVolumeStateFirebaseMetric::GetValue() const
@@ -56,23 +161,63 @@ int64 UWZFTestIncrementalFirebaseMetric::GetValue() const
 	return value;
 }
 
-void UWZFFirebaseTrace::InitializeTrace(UGameInstance* InGameInstance)
+void UWZFFirebaseTrace::InitializeTrace(UGameInstance* InGameInstance, FWZFFirebaseMetricWorker* InMetricWorker)
 {
 	GameInstance = InGameInstance;
+	MetricWorker = InMetricWorker;
+
+	TArray<FString> metricNames;
+	TArray<FString> valueSuffixes;
+	for (const auto& metricData : TraceData.Metrics)
+	{
+		valueSuffixes.Reset();
+		if (metricData.MetricClass != nullptr)
+		{
+			metricData.MetricClass->GetDefaultObject<UWZFFirebaseMetric>()->GetValueSuffixes(valueSuffixes);
+		}
+		else
+		{
+			valueSuffixes.Add(FString());
+		}
+
+		MetricValueOffsets.Add(metricNames.Num());
+		MetricValueCounts.Add(valueSuffixes.Num());
+		for (const auto& suffix : valueSuffixes)
+		{
+			metricNames.Add(metricData.MetricName + suffix);
+		}
+	}
+
+	Channel = MakeShared<FWZFFirebaseTraceChannel, ESPMode::ThreadSafe>(metricNames);
+	MetricWorker->AddChannel(Channel.ToSharedRef());
+
+	// Incremented names are unique so there's nothing to prewarm for them.
+	if (!TraceData.bIncrementTraceName)
+	{
+		UFirebasePerformanceLibrary::PrewarmTraces({ TraceData.TraceName }, 1);
+	}
 
 	FTimerHandle timer;
 	GameInstance->GetTimerManager().SetTimer(timer, this, &UWZFFirebaseTrace::OnTraceTimer, TraceData.TraceDuration, !TraceData.bOnceTrace, 0.f);
 }
 
-void UWZFFirebaseTrace::OnTraceTimer()
+void UWZFFirebaseTrace::DeinitializeTrace()
 {
-	UE_LOG(LogWZFFirebaseTrace, Log, TEXT("UWZFFirebaseTrace::OnTraceTimer %s, bStartedTrace: %d"), *TraceData.TraceName, bStartedTrace);
+	if (GameInstance.IsValid())
+	{
+		GameInstance->GetTimerManager().ClearAllTimersForObject(this);
+	}
 
-	if(bStartedTrace)
+	if (Channel.IsValid())
 	{
-		FirebaseTrace.Stop();
+		Channel->StopTrace();
+		MetricWorker->RemoveChannel(Channel.ToSharedRef());
+		Channel.Reset();
 	}
-	
+}
+
+void UWZFFirebaseTrace::OnTraceTimer()
+{
 	FString traceName = TraceData.TraceName;
 	if (TraceData.bIncrementTraceName)
 	{
@@ -80,39 +225,20 @@ void UWZFFirebaseTrace::OnTraceTimer()
 		TotalTraceCount++;
 	}
 
-	UE_LOG(LogWZFFirebaseTrace, Log, TEXT("Try create and start trace: %s"), *traceName);
-	FirebaseTrace = UFirebasePerformanceLibrary::CreateAndStartTrace(traceName);
-
-	//UE_LOG(LogWZFFirebaseTrace, Log, TEXT("Try start trace: %s"), *traceName);
-	//FirebaseTrace.Start();
-
-	UE_LOG(LogWZFFirebaseTrace, Log, TEXT("Success start trace: %s"), *traceName);
+	UE_LOG(LogWZFFirebaseTrace, Log, TEXT("UWZFFirebaseTrace::OnTraceTimer, starting trace: %s"), *traceName);
 
-	bStartedTrace = true;
-	
-	Metrics.Empty();
-	for (const auto& metricData : TraceData.Metrics)
-	{
-		if (metricData.MetricClass != nullptr)
-		{
-			Metrics.Emplace(metricData.MetricName, NewObject<UWZFFirebaseMetric>(this, metricData.MetricClass));
-		}
-	}
-
-	FTimerHandle timer;
-	GameInstance->GetTimerManager().SetTimer(timer, this, &UWZFFirebaseTrace::OnMetricTimer, TraceData.MetricRate, true, 0.f);
+	// Stops the previous trace, if any, under the channel's lock so the worker never
+	// flushes into a trace that is being replaced.
+	Channel->ResetTrace(traceName, UFirebasePerformanceLibrary::AcquireAndStartTrace(traceName));
 }
 
-void UWZFFirebaseTrace::OnMetricTimer()
+void UWZFFirebaseTrace::PushMetricValues(int32 MetricIndex, TArrayView<const int64> Values)
 {
-	for (const auto& metric : Metrics)
+	check(Values.Num() == MetricValueCounts[MetricIndex]);
+
+	for (int32 valueIndex = 0; valueIndex < Values.Num(); ++valueIndex)
 	{
-		if (metric.Value.IsValid())
-		{
-			UE_LOG(LogWZFFirebaseTrace, Log, TEXT("Start Firebase metric [%s:%d]"), *metric.Key, metric.Value->GetValue());
-			FirebaseTrace.SetMetricValue(metric.Key, metric.Value->GetValue());
-			UE_LOG(LogWZFFirebaseTrace, Log, TEXT("End Firebase metric"));
-		}
+		Channel->PushSample(MetricValueOffsets[MetricIndex] + valueIndex, Values[valueIndex]);
 	}
 }
 
@@ -132,11 +258,119 @@ void UWZFFirebasePerformanceSubsystem::Initialize(FSubsystemCollectionBase& Coll
 	FTimerHandle timer;
 	GetGameInstance()->GetTimerManager().SetTimer(timer, timerCallback, 5.f, false);
 
+	MetricWorker = MakeUnique<FWZFFirebaseMetricWorker>();
+
 	for (const auto& traceData : UWZFSettings::Get()->Traces)
 	{
 		const auto trace = NewObject<UWZFFirebaseTrace>(this);
 		trace->TraceData = traceData;
-		trace->InitializeTrace(GetGameInstance());
-		Traces.Add(trace);
+		trace->InitializeTrace(GetGameInstance(), MetricWorker.Get());
+		const auto traceIndex = Traces.Add(trace);
+
+		for (int32 metricIndex = 0; metricIndex < traceData.Metrics.Num(); ++metricIndex)
+		{
+			const auto& metricClass = traceData.Metrics[metricIndex].MetricClass;
+			if (metricClass != nullptr)
+			{
+				MetricSubscriptions[FindOrAddMetric(metricClass, traceData.MetricRate)].Add({ traceIndex, metricIndex });
+			}
+		}
+
+		NextTraceSampleTimes.Add(0.);
+	}
+
+	DueTraces.Init(false, Traces.Num());
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UWZFFirebasePerformanceSubsystem::Tick));
+}
+
+void UWZFFirebasePerformanceSubsystem::Deinitialize()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+
+	for (const auto trace : Traces)
+	{
+		trace->DeinitializeTrace();
+	}
+	Traces.Empty();
+	NextTraceSampleTimes.Empty();
+
+	Metrics.Empty();
+	MetricSubscriptions.Empty();
+	MetricRates.Empty();
+
+	MetricWorker.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 UWZFFirebasePerformanceSubsystem::FindOrAddMetric(TSubclassOf<UWZFFirebaseMetric> MetricClass, float MetricRate)
+{
+	// Sampling a metric can reset its window, so only traces sampling at the same rate share an instance.
+	for (int32 registryIndex = 0; registryIndex < Metrics.Num(); ++registryIndex)
+	{
+		if (Metrics[registryIndex]->GetClass() == MetricClass && MetricRates[registryIndex] == MetricRate)
+		{
+			return registryIndex;
+		}
+	}
+
+	MetricSubscriptions.AddDefaulted();
+	MetricRates.Add(MetricRate);
+	return Metrics.Add(NewObject<UWZFFirebaseMetric>(this, MetricClass));
+}
+
+bool UWZFFirebasePerformanceSubsystem::Tick(float DeltaTime)
+{
+	const auto now = FPlatformTime::Seconds();
+
+	bool bAnyTraceDue = false;
+	for (int32 traceIndex = 0; traceIndex < Traces.Num(); ++traceIndex)
+	{
+		const bool bDue = now >= NextTraceSampleTimes[traceIndex];
+		if (bDue)
+		{
+			// Scheduled from now rather than from the previous deadline so a long frame doesn't cause a burst.
+			NextTraceSampleTimes[traceIndex] = now + Traces[traceIndex]->TraceData.MetricRate;
+		}
+
+		DueTraces[traceIndex] = bDue;
+		bAnyTraceDue |= bDue;
 	}
+
+	if (!bAnyTraceDue)
+	{
+		return true;
+	}
+
+	// Only sample here, the values reach Firebase from the metric worker.
+	for (int32 registryIndex = 0; registryIndex < Metrics.Num(); ++registryIndex)
+	{
+		const auto& subscriptions = MetricSubscriptions[registryIndex];
+		const bool bSampleMetric = subscriptions.ContainsByPredicate([this](const FWZFFirebaseMetricSubscription& subscription)
+		{
+			return DueTraces[subscription.TraceIndex];
+		});
+
+		if (!bSampleMetric)
+		{
+			continue;
+		}
+
+		SampledValues.Reset();
+		Metrics[registryIndex]->SampleValues(SampledValues);
+
+		for (const auto& subscription : subscriptions)
+		{
+			if (DueTraces[subscription.TraceIndex])
+			{
+				Traces[subscription.TraceIndex]->PushMetricValues(subscription.MetricIndex, SampledValues);
+			}
+		}
+	}
+
+	MetricWorker->RequestFlush();
+
+	return true;
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "WZFFirebaseMetricPipeline.h"
 #include "WZFFirebasePerfomanceData.h"
 
 #include "Performance/FirebasePerformanceLibrary.h"
 #include "Subsystems/WorldSubsystem.h"
-#include "UObject/StrongObjectPtr.h"
+
+#include <atomic>
 
 #include "WZFFirebasePerformanceSubsystem.generated.h"
 
@@ -16,24 +18,74 @@ class WZF_API UWZFFirebaseMetric : public UObject
 	GENERATED_BODY()
 public:
 	virtual int64 GetValue() const { PURE_VIRTUAL(UWZFFirebaseMetric::GetValue, return {};) }
+
+	/**
+	 * Suffixes appended to the configured metric name, one per value reported by the metric.
+	 * Metrics reporting a single value report it under the configured name.
+	 */
+	virtual void GetValueSuffixes(TArray<FString>& OutSuffixes) const { OutSuffixes.Add(FString()); }
+
+	/** Samples the metric's values, in the order of GetValueSuffixes(). */
+	virtual void SampleValues(TArray<int64>& OutValues) { OutValues.Add(GetValue()); }
 };
 
-UCLASS()
-class WZF_API UWZFFPSFirebaseMetric : public UWZFFirebaseMetric
+/** Latest values of an async metric, shared with the background task sampling them. */
+struct FWZFAsyncMetricState
+{
+	static constexpr int32 MaxValues = 8;
+
+	FWZFAsyncMetricState();
+
+	TFunction<void(TArray<int64>&)> Sampler;
+	int32 NumValues = 0;
+
+	std::atomic<int64> Values[MaxValues];
+	std::atomic<bool> bSampling;
+};
+
+/**
+ * Metric whose values are expensive to read. Sampling it on the game thread returns the values from
+ * the previous sample and starts a background task reading the next ones, so reads happen at the
+ * trace's MetricRate without stalling the frame.
+ */
+UCLASS(Abstract)
+class WZF_API UWZFAsyncFirebaseMetric : public UWZFFirebaseMetric
 {
 	GENERATED_BODY()
 public:
+	virtual void PostInitProperties() override;
+
 	virtual int64 GetValue() const override;
+	virtual void SampleValues(TArray<int64>& OutValues) override;
+
+protected:
+	/** Creates the function reading the values on a background thread. It must not capture the metric. */
+	virtual TFunction<void(TArray<int64>&)> CreateSampler() const { PURE_VIRTUAL(UWZFAsyncFirebaseMetric::CreateSampler, return {};) }
+
+private:
+	TSharedPtr<FWZFAsyncMetricState, ESPMode::ThreadSafe> State;
 };
 
 UCLASS()
-class WZF_API UWZFDeviceTemperatureFirebaseMetric : public UWZFFirebaseMetric
+class WZF_API UWZFFPSFirebaseMetric : public UWZFFirebaseMetric
 {
 	GENERATED_BODY()
 public:
 	virtual int64 GetValue() const override;
 };
 
+/**
+ * Reports FPlatformMisc::GetDeviceTemperatureLevel(): the battery temperature in Celsius on Android and
+ * the thermal state (FCoreDelegates::ETemperatureSeverity) on iOS. -1 where it isn't supported.
+ */
+UCLASS()
+class WZF_API UWZFDeviceTemperatureFirebaseMetric : public UWZFAsyncFirebaseMetric
+{
+	GENERATED_BODY()
+protected:
+	virtual TFunction<void(TArray<int64>&)> CreateSampler() const override;
+};
+
 UCLASS()
 class WZF_API UWZFDeviceBatteryLevelFirebaseMetric : public UWZFFirebaseMetric
 {
@@ -42,12 +94,20 @@ public:
 	virtual int64 GetValue() const override;
 };
 
+/**
+ * Reports the resident, peak resident and available physical memory in MB as <MetricName>_resident,
+ * <MetricName>_peak and <MetricName>_available. Builds with LLM also report the tracked totals and a
+ * few tag totals, which are 0 when LLM isn't enabled on the command line.
+ */
 UCLASS()
-class WZF_API UWZFMemoryFirebaseMetric : public UWZFFirebaseMetric
+class WZF_API UWZFMemoryFirebaseMetric : public UWZFAsyncFirebaseMetric
 {
 	GENERATED_BODY()
 public:
-	virtual int64 GetValue() const override;
+	virtual void GetValueSuffixes(TArray<FString>& OutSuffixes) const override;
+
+protected:
+	virtual TFunction<void(TArray<int64>&)> CreateSampler() const override;
 };
 
 UCLASS()
@@ -73,24 +133,41 @@ class WZF_API UWZFFirebaseTrace : public UObject
 {
 	GENERATED_BODY()
 public:
-	virtual void InitializeTrace(class UGameInstance* InGameInstance);
+	virtual void InitializeTrace(class UGameInstance* InGameInstance, FWZFFirebaseMetricWorker* InMetricWorker);
+	virtual void DeinitializeTrace();
+
+	/** Queues the values sampled for the metric at MetricIndex in TraceData.Metrics. Flushed by the metric worker. */
+	void PushMetricValues(int32 MetricIndex, TArrayView<const int64> Values);
 
 public:
 	FWZFFireBaseTraceData TraceData;
 
 private:
 	void OnTraceTimer();
-	void OnMetricTimer();
 
 private:
-	FFirebaseTrace FirebaseTrace;
-	bool bStartedTrace = false;
+	TSharedPtr<FWZFFirebaseTraceChannel, ESPMode::ThreadSafe> Channel;
+	FWZFFirebaseMetricWorker* MetricWorker = nullptr;
 
-	TArray<TPair<FString, TStrongObjectPtr<UWZFFirebaseMetric>>> Metrics;
+	// Channel index of the first value of each metric, indexed like TraceData.Metrics.
+	TArray<int32> MetricValueOffsets;
+	TArray<int32> MetricValueCounts;
 
 	TWeakObjectPtr<class UGameInstance> GameInstance;
 };
 
+struct FWZFFirebaseMetricSubscription
+{
+	int32 TraceIndex = INDEX_NONE;
+	int32 MetricIndex = INDEX_NONE;
+};
+
+/**
+ * Owns the traces configured in UWZFSettings and the metrics they report.
+ * Each metric class is instantiated once per MetricRate and sampled once per tick, however many traces
+ * use it, and the values are fanned out to the traces whose MetricRate elapsed. Metrics such as the
+ * frame time histogram reset their window when sampled, so traces with another rate can't share them.
+ */
 UCLASS()
 class WZF_API UWZFFirebasePerformanceSubsystem : public UGameInstanceSubsystem
 {
@@ -102,7 +179,30 @@ public:
 protected:
 	virtual bool ShouldCreateSubsystem(UObject* Outer) const override { return true; }
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
+private:
+	int32 FindOrAddMetric(TSubclassOf<UWZFFirebaseMetric> MetricClass, float MetricRate);
+	bool Tick(float DeltaTime);
+
+protected:
 	UPROPERTY()
 	TArray<UWZFFirebaseTrace*> Traces;
+
+	UPROPERTY()
+	TArray<UWZFFirebaseMetric*> Metrics;
+
+	TUniquePtr<FWZFFirebaseMetricWorker> MetricWorker;
+
+private:
+	// Indexed like Metrics.
+	TArray<TArray<FWZFFirebaseMetricSubscription>> MetricSubscriptions;
+	TArray<float> MetricRates;
+
+	// Indexed like Traces.
+	TArray<double> NextTraceSampleTimes;
+	TBitArray<> DueTraces;
+
+	TArray<int64> SampledValues;
+	FDelegateHandle TickerHandle;
 };
@@ -0,0 +1,83 @@
+#include "WZFFrameTimeFirebaseMetrics.h"
+
+#include "Misc/CoreDelegates.h"
+#include "RenderCore.h"
+#include "RHI.h"
+#include "RHICommandList.h"
+
+void UWZFFrameTimeFirebaseMetric::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// The CDO is only used to read the value suffixes, it doesn't record anything.
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UWZFFrameTimeFirebaseMetric::OnEndFrame);
+	}
+}
+
+void UWZFFrameTimeFirebaseMetric::BeginDestroy()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+
+	Super::BeginDestroy();
+}
+
+int64 UWZFFrameTimeFirebaseMetric::GetValue() const
+{
+	return Histogram.GetPercentile(50.f);
+}
+
+void UWZFFrameTimeFirebaseMetric::GetValueSuffixes(TArray<FString>& OutSuffixes) const
+{
+	OutSuffixes.Add(TEXT("_p50"));
+	OutSuffixes.Add(TEXT("_p90"));
+	OutSuffixes.Add(TEXT("_p99"));
+	OutSuffixes.Add(TEXT("_max"));
+	OutSuffixes.Add(TEXT("_hitches"));
+}
+
+void UWZFFrameTimeFirebaseMetric::SampleValues(TArray<int64>& OutValues)
+{
+	OutValues.Add(Histogram.GetPercentile(50.f));
+	OutValues.Add(Histogram.GetPercentile(90.f));
+	OutValues.Add(Histogram.GetPercentile(99.f));
+	OutValues.Add(Histogram.GetMax());
+	OutValues.Add(Histogram.GetNumHitches());
+
+	// Each sample covers the frames since the previous one.
+	Histogram.Reset();
+}
+
+void UWZFFrameTimeFirebaseMetric::OnEndFrame()
+{
+	const auto frameCycles = GetFrameCycles();
+	if (frameCycles == 0)
+	{
+		return;
+	}
+
+	const auto frameTimeUs = static_cast<uint32>(FPlatformTime::ToMilliseconds(frameCycles) * 1000.f);
+	Histogram.Record(frameTimeUs, static_cast<uint32>(HitchThresholdMs * 1000.f));
+}
+
+uint32 UWZFGameThreadTimeFirebaseMetric::GetFrameCycles() const
+{
+	return GGameThreadTime;
+}
+
+uint32 UWZFRenderThreadTimeFirebaseMetric::GetFrameCycles() const
+{
+	return GRenderThreadTime;
+}
+
+uint32 UWZFRHIThreadTimeFirebaseMetric::GetFrameCycles() const
+{
+	return IsRunningRHIInSeparateThread() ? GWorkingRHIThreadTime : 0;
+}
+
+uint32 UWZFGPUTimeFirebaseMetric::GetFrameCycles() const
+{
+	return RHIGetGPUFrameCycles();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "WZFFirebasePerformanceSubsystem.h"
+#include "WZFFrameTimeHistogram.h"
+
+#include "WZFFrameTimeFirebaseMetrics.generated.h"
+
+/**
+ * Records one frame time per frame into a histogram on the game thread and reports, for the frames
+ * since the previous sample, the p50/p90/p99/max frame times in microseconds and the hitch count.
+ * Values are reported as <MetricName>_p50, <MetricName>_p90, <MetricName>_p99, <MetricName>_max
+ * and <MetricName>_hitches.
+ */
+UCLASS(Abstract)
+class WZF_API UWZFFrameTimeFirebaseMetric : public UWZFFirebaseMetric
+{
+	GENERATED_BODY()
+public:
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+
+	virtual int64 GetValue() const override;
+	virtual void GetValueSuffixes(TArray<FString>& OutSuffixes) const override;
+	virtual void SampleValues(TArray<int64>& OutValues) override;
+
+	/** Frames taking at least this long are counted as hitches. */
+	UPROPERTY(EditDefaultsOnly)
+	float HitchThresholdMs = 50.f;
+
+protected:
+	/** Time spent on the last frame in cycles, 0 if it isn't available. */
+	virtual uint32 GetFrameCycles() const { PURE_VIRTUAL(UWZFFrameTimeFirebaseMetric::GetFrameCycles, return 0;) }
+
+private:
+	void OnEndFrame();
+
+private:
+	FWZFFrameTimeHistogram Histogram;
+	FDelegateHandle EndFrameHandle;
+};
+
+UCLASS()
+class WZF_API UWZFGameThreadTimeFirebaseMetric : public UWZFFrameTimeFirebaseMetric
+{
+	GENERATED_BODY()
+protected:
+	virtual uint32 GetFrameCycles() const override;
+};
+
+UCLASS()
+class WZF_API UWZFRenderThreadTimeFirebaseMetric : public UWZFFrameTimeFirebaseMetric
+{
+	GENERATED_BODY()
+protected:
+	virtual uint32 GetFrameCycles() const override;
+};
+
+UCLASS()
+class WZF_API UWZFRHIThreadTimeFirebaseMetric : public UWZFFrameTimeFirebaseMetric
+{
+	GENERATED_BODY()
+protected:
+	virtual uint32 GetFrameCycles() const override;
+};
+
+UCLASS()
+class WZF_API UWZFGPUTimeFirebaseMetric : public UWZFFrameTimeFirebaseMetric
+{
+	GENERATED_BODY()
+protected:
+	virtual uint32 GetFrameCycles() const override;
+};
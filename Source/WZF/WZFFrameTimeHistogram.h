@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-size log-linear histogram of frame times in microseconds.
+ * Each power of two is split into SubBucketCount linear buckets, so the relative error of a
+ * reported percentile stays under 1 / SubBucketCount whatever the frame time.
+ * Recording is a couple of integer ops and never allocates.
+ */
+class FWZFFrameTimeHistogram
+{
+public:
+	static constexpr int32 SubBucketBits = 3;
+	static constexpr int32 SubBucketCount = 1 << SubBucketBits;
+
+	// Values above 2^MaxExponent us (~16s) land in the last bucket.
+	static constexpr int32 MaxExponent = 24;
+	static constexpr int32 NumBuckets = (MaxExponent - SubBucketBits + 2) * SubBucketCount;
+
+	FWZFFrameTimeHistogram() { Reset(); }
+
+	void Record(uint32 ValueUs, uint32 HitchThresholdUs)
+	{
+		Buckets[GetBucketIndex(ValueUs)]++;
+		NumValues++;
+		MaxValue = FMath::Max(MaxValue, ValueUs);
+		NumHitches += ValueUs >= HitchThresholdUs ? 1 : 0;
+	}
+
+	void Reset()
+	{
+		FMemory::Memzero(Buckets);
+		NumValues = 0;
+		NumHitches = 0;
+		MaxValue = 0;
+	}
+
+	/** Upper bound of the bucket holding the given percentile, clamped to the max value. 0 if empty. */
+	uint32 GetPercentile(float Percentile) const
+	{
+		if (NumValues == 0)
+		{
+			return 0;
+		}
+
+		const uint32 rank = FMath::Clamp<uint32>(FMath::CeilToInt(NumValues * Percentile / 100.f), 1, NumValues);
+
+		uint32 cumulated = 0;
+		for (int32 bucketIndex = 0; bucketIndex < NumBuckets; ++bucketIndex)
+		{
+			cumulated += Buckets[bucketIndex];
+			if (cumulated >= rank)
+			{
+				return FMath::Min(GetBucketUpperBound(bucketIndex), MaxValue);
+			}
+		}
+
+		return MaxValue;
+	}
+
+	uint32 GetMax() const { return MaxValue; }
+	uint32 GetNumValues() const { return NumValues; }
+	uint32 GetNumHitches() const { return NumHitches; }
+
+	static int32 GetBucketIndex(uint32 ValueUs)
+	{
+		if (ValueUs < SubBucketCount)
+		{
+			return ValueUs;
+		}
+
+		const int32 exponent = FMath::FloorLog2(ValueUs);
+		const int32 subBucket = (ValueUs >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+		return FMath::Min((exponent - SubBucketBits + 1) * SubBucketCount + subBucket, NumBuckets - 1);
+	}
+
+	static uint32 GetBucketUpperBound(int32 BucketIndex)
+	{
+		if (BucketIndex < SubBucketCount)
+		{
+			return BucketIndex;
+		}
+
+		const int32 exponent = BucketIndex / SubBucketCount + SubBucketBits - 1;
+		const uint32 subBucket = BucketIndex % SubBucketCount;
+		const uint32 width = 1u << (exponent - SubBucketBits);
+		return (SubBucketCount + subBucket) * width + width - 1;
+	}
+
+private:
+	uint32 Buckets[NumBuckets];
+	uint32 NumValues;
+	uint32 NumHitches;
+	uint32 MaxValue;
+};